@@ -0,0 +1,592 @@
+#include "engine_benchmarks.hpp"
+
+#include "lve_bvh.hpp"
+#include "lve_camera.hpp"
+#include "lve_descriptors.hpp"
+#include "lve_device.hpp"
+#include "lve_frustum.hpp"
+#include "lve_game_object.hpp"
+#include "lve_job_system.hpp"
+#include "lve_model.hpp"
+#include "lve_mpsc_queue.hpp"
+#include "lve_scene.hpp"
+#include "lve_spatial_hash.hpp"
+#include "lve_transform_hierarchy.hpp"
+#include "systems/point_light_system.hpp"
+
+// libs
+#include <glm/gtc/constants.hpp>
+
+// std
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+namespace lve {
+
+namespace {
+
+// Writes a size x size grid of quads with positions, vertex colors, normals and uvs. Faces
+// reference shared corners, so loading it exercises the same vertex welding as real models.
+std::string writeSyntheticObj(int size) {
+  auto path = std::filesystem::temp_directory_path() /
+              ("lve_bench_grid_" + std::to_string(size) + ".obj");
+  std::ofstream file{path};
+  if (!file.is_open()) {
+    throw std::runtime_error("failed to write synthetic model: " + path.string());
+  }
+
+  for (int z = 0; z <= size; z++) {
+    for (int x = 0; x <= size; x++) {
+      float u = static_cast<float>(x) / size;
+      float v = static_cast<float>(z) / size;
+      file << "v " << u * 2.f - 1.f << " " << 0.1f * std::sin(u * 12.f) * std::cos(v * 9.f)
+           << " " << v * 2.f - 1.f << " " << u << " " << v << " 0.5\n";
+      file << "vt " << u << " " << v << "\n";
+    }
+  }
+  file << "vn 0 -1 0\n";
+
+  auto index = [&](int x, int z) { return z * (size + 1) + x + 1; };
+  for (int z = 0; z < size; z++) {
+    for (int x = 0; x < size; x++) {
+      int a = index(x, z), b = index(x + 1, z), c = index(x + 1, z + 1), d = index(x, z + 1);
+      file << "f " << a << "/" << a << "/1 " << b << "/" << b << "/1 " << c << "/" << c << "/1 "
+           << d << "/" << d << "/1\n";
+    }
+  }
+  return path.string();
+}
+
+// Expands an indexed mesh back into one vertex per index, the input loadModel welds
+std::vector<LveModel::Vertex> unweld(const LveModel::Builder &builder) {
+  std::vector<LveModel::Vertex> vertices;
+  vertices.reserve(builder.indices.size());
+  for (uint32_t index : builder.indices) {
+    vertices.push_back(builder.vertices[index]);
+  }
+  return vertices;
+}
+
+void addModelBenchmarks(LveBenchSuite &suite, const std::vector<std::string> &modelFiles) {
+  for (const auto &filepath : modelFiles) {
+    LveModel::Builder probe{};
+    probe.loadModel(filepath);
+    auto name = std::filesystem::path{filepath}.filename().string();
+
+    suite.add("LveModel::Builder::loadModel/" + name, probe.indices.size(), [filepath](uint64_t n) {
+      LveModel::Builder builder{};
+      for (uint64_t i = 0; i < n; i++) {
+        builder.loadModel(filepath);
+        doNotOptimize(builder.vertices.data());
+      }
+    });
+
+    auto unwelded = std::make_shared<std::vector<LveModel::Vertex>>(unweld(probe));
+    suite.add("Vertex hash/" + name, unwelded->size(), [unwelded](uint64_t n) {
+      std::hash<LveModel::Vertex> hasher{};
+      for (uint64_t i = 0; i < n; i++) {
+        size_t combined = 0;
+        for (const auto &vertex : *unwelded) {
+          combined ^= hasher(vertex);
+        }
+        doNotOptimize(combined);
+      }
+    });
+
+    suite.add("Vertex weld/" + name, unwelded->size(), [unwelded](uint64_t n) {
+      std::vector<LveModel::Vertex> vertices;
+      std::vector<uint32_t> indices;
+      for (uint64_t i = 0; i < n; i++) {
+        // same deduplication as LveModel::Builder::loadModel
+        std::unordered_map<LveModel::Vertex, uint32_t> uniqueVertices{};
+        vertices.clear();
+        indices.clear();
+        for (const auto &vertex : *unwelded) {
+          if (uniqueVertices.count(vertex) == 0) {
+            uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
+            vertices.push_back(vertex);
+          }
+          indices.push_back(uniqueVertices[vertex]);
+        }
+        doNotOptimize(indices.data());
+      }
+    });
+  }
+}
+
+void addTransformBenchmarks(LveBenchSuite &suite) {
+  constexpr size_t count = 4096;
+  auto transforms = std::make_shared<std::vector<TransformComponent>>(count);
+  std::mt19937 rng{42};
+  std::uniform_real_distribution<float> position{-50.f, 50.f};
+  std::uniform_real_distribution<float> angle{-glm::pi<float>(), glm::pi<float>()};
+  std::uniform_real_distribution<float> scale{.1f, 3.f};
+  for (auto &transform : *transforms) {
+    transform.translation = {position(rng), position(rng), position(rng)};
+    transform.rotation = {angle(rng), angle(rng), angle(rng)};
+    transform.scale = {scale(rng), scale(rng), scale(rng)};
+  }
+
+  suite.add("TransformComponent::mat4", count, [transforms](uint64_t n) {
+    for (uint64_t i = 0; i < n; i++) {
+      for (auto &transform : *transforms) {
+        glm::mat4 matrix = transform.mat4();
+        doNotOptimize(matrix);
+      }
+    }
+  });
+
+  suite.add("TransformComponent::normalMatrix", count, [transforms](uint64_t n) {
+    for (uint64_t i = 0; i < n; i++) {
+      for (auto &transform : *transforms) {
+        glm::mat3 matrix = transform.normalMatrix();
+        doNotOptimize(matrix);
+      }
+    }
+  });
+}
+
+void addJobSystemBenchmarks(LveBenchSuite &suite) {
+  auto jobSystem = std::make_shared<LveJobSystem>();
+  std::string workers = std::to_string(jobSystem->getWorkerCount());
+
+  // scheduling overhead: a job that does nothing
+  suite.add("LveJobSystem::run+wait/" + workers + " workers", 256, [jobSystem](uint64_t n) {
+    for (uint64_t i = 0; i < n; i++) {
+      LveJobCounter counter;
+      for (int j = 0; j < 256; j++) {
+        jobSystem->run([] {}, counter);
+      }
+      jobSystem->wait(counter);
+    }
+  });
+
+  // the transform benchmark above spread over the workers
+  constexpr size_t count = 65536;
+  auto transforms = std::make_shared<std::vector<TransformComponent>>(count);
+  auto matrices = std::make_shared<std::vector<glm::mat4>>(count);
+  std::mt19937 rng{42};
+  std::uniform_real_distribution<float> angle{-glm::pi<float>(), glm::pi<float>()};
+  for (auto &transform : *transforms) {
+    transform.rotation = {angle(rng), angle(rng), angle(rng)};
+  }
+  suite.add(
+      "LveJobSystem::parallelFor mat4/" + workers + " workers",
+      count,
+      [jobSystem, transforms, matrices](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) {
+          jobSystem->parallelFor(
+              static_cast<uint32_t>(count),
+              1024,
+              [&](uint32_t begin, uint32_t end) {
+                for (uint32_t j = begin; j < end; j++) {
+                  (*matrices)[j] = (*transforms)[j].mat4();
+                }
+              });
+          doNotOptimize(matrices->data());
+        }
+      });
+}
+
+void addQueueBenchmarks(LveBenchSuite &suite) {
+  // loader threads posting to the render thread, which pops while they push
+  constexpr int producers = 4;
+  constexpr uint64_t itemsPerProducer = 16384;
+  suite.add(
+      "LveMpscQueue push+pop/" + std::to_string(producers) + " producers",
+      producers * itemsPerProducer,
+      [](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) {
+          LveMpscQueue<uint64_t> queue;
+          std::vector<std::thread> threads;
+          for (int p = 0; p < producers; p++) {
+            threads.emplace_back([&queue] {
+              for (uint64_t j = 0; j < itemsPerProducer; j++) {
+                queue.push(j);
+              }
+            });
+          }
+          uint64_t popped = 0, sum = 0, item;
+          while (popped < producers * itemsPerProducer) {
+            if (queue.pop(item)) {
+              sum += item;
+              popped++;
+            }
+          }
+          for (auto &thread : threads) {
+            thread.join();
+          }
+          doNotOptimize(sum);
+        }
+      });
+}
+
+void addSceneBenchmarks(LveBenchSuite &suite) {
+  // a scattered forest of single objects, the worst case for the text format
+  constexpr int count = 100000;
+  auto directory = std::filesystem::temp_directory_path();
+  std::string textPath = (directory / "lve_bench_100k.scene").string();
+  std::string binaryPath = (directory / "lve_bench_100k.lvscene").string();
+  {
+    std::ofstream file{textPath};
+    if (!file.is_open()) {
+      throw std::runtime_error("failed to write synthetic scene: " + textPath);
+    }
+    file << "model tree models/park/Tree01/tree01.obj\n";
+    std::mt19937 rng{42};
+    std::uniform_real_distribution<float> position{-500.f, 500.f};
+    for (int i = 0; i < count; i++) {
+      file << "object tree " << position(rng) << " .5 " << position(rng) << " 0 " << i * .1f
+           << " 0 .3 .3 .3 static\n";
+    }
+  }
+  LveScene::loadFromFile(textPath).writeBinary(binaryPath);
+
+  suite.add("LveScene::loadFromFile text/100k objects", count, [textPath](uint64_t n) {
+    for (uint64_t i = 0; i < n; i++) {
+      auto scene = LveScene::loadFromFile(textPath);
+      doNotOptimize(scene.getInstances());
+    }
+  });
+  // maps the file and validates the model indices, which touches every instance once
+  suite.add("LveScene::loadFromFile binary/100k objects", count, [binaryPath](uint64_t n) {
+    for (uint64_t i = 0; i < n; i++) {
+      auto scene = LveScene::loadFromFile(binaryPath);
+      doNotOptimize(scene.getInstances());
+    }
+  });
+}
+
+void addBvhBenchmarks(LveBenchSuite &suite) {
+  // a 1km square of small objects, like a scattered forest
+  constexpr size_t count = 100000;
+  auto items = std::make_shared<std::vector<LveBvh::Item>>(count);
+  std::mt19937 rng{42};
+  std::uniform_real_distribution<float> position{-500.f, 500.f};
+  std::uniform_real_distribution<float> size{.2f, 2.f};
+  for (size_t i = 0; i < count; i++) {
+    glm::vec3 center{position(rng), 0.f, position(rng)};
+    glm::vec3 extent{size(rng)};
+    (*items)[i] = {{center - extent, center + extent}, static_cast<LveGameObject::id_t>(i), false};
+  }
+  auto jobSystem = std::make_shared<LveJobSystem>();
+  std::string workers = std::to_string(jobSystem->getWorkerCount());
+
+  suite.add("LveBvh::build/100k objects", count, [items](uint64_t n) {
+    for (uint64_t i = 0; i < n; i++) {
+      LveBvh bvh;
+      bvh.build(*items);
+      doNotOptimize(bvh.getNodes().data());
+    }
+  });
+  suite.add(
+      "LveBvh::build/100k objects, " + workers + " workers",
+      count,
+      [items, jobSystem](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) {
+          LveBvh bvh;
+          bvh.build(*items, jobSystem.get());
+          doNotOptimize(bvh.getNodes().data());
+        }
+      });
+
+  auto bvh = std::make_shared<LveBvh>();
+  bvh->build(*items, jobSystem.get());
+  suite.add("LveBvh::refit/100k objects", count, [bvh](uint64_t n) {
+    for (uint64_t i = 0; i < n; i++) {
+      bvh->refit();
+      doNotOptimize(bvh->getNodes().data());
+    }
+  });
+
+  // batch render sized chunk of views from inside the square
+  constexpr size_t viewCount = 256;
+  auto frustums = std::make_shared<std::vector<LveFrustum>>();
+  std::uniform_real_distribution<float> yaw{-glm::pi<float>(), glm::pi<float>()};
+  for (size_t i = 0; i < viewCount; i++) {
+    LveCamera camera{};
+    camera.setViewYXZ({position(rng), -2.f, position(rng)}, {0.f, yaw(rng), 0.f});
+    camera.setPerspectiveProjection(glm::radians(50.f), 16.f / 9.f, .1f, 100.f);
+    frustums->push_back(LveFrustum::fromCamera(camera));
+  }
+  suite.add("LveBvh::queryFrustums/256 views", viewCount, [bvh, frustums](uint64_t n) {
+    std::vector<std::vector<LveGameObject::id_t>> visible;
+    for (uint64_t i = 0; i < n; i++) {
+      bvh->queryFrustums(*frustums, visible);
+      doNotOptimize(visible.data());
+    }
+  });
+
+  constexpr size_t queryCount = 4096;
+  auto spheres = std::make_shared<std::vector<LveBoundingSphere>>(queryCount);
+  auto rays = std::make_shared<std::vector<LveRay>>(queryCount);
+  std::uniform_real_distribution<float> direction{-1.f, 1.f};
+  for (size_t i = 0; i < queryCount; i++) {
+    (*spheres)[i] = {{position(rng), 0.f, position(rng)}, 10.f};
+    (*rays)[i].origin = {position(rng), 1.f, position(rng)};
+    (*rays)[i].direction = glm::normalize(glm::vec3{direction(rng), -.05f, direction(rng)});
+  }
+  suite.add(
+      "LveBvh::querySpheres/" + workers + " workers",
+      queryCount,
+      [bvh, spheres, jobSystem](uint64_t n) {
+        std::vector<std::vector<LveGameObject::id_t>> results;
+        for (uint64_t i = 0; i < n; i++) {
+          bvh->querySpheres(*spheres, results, jobSystem.get());
+          doNotOptimize(results.data());
+        }
+      });
+  suite.add(
+      "LveBvh::intersectRays/" + workers + " workers",
+      queryCount,
+      [bvh, rays, jobSystem](uint64_t n) {
+        std::vector<LveBvh::RayHit> hits;
+        for (uint64_t i = 0; i < n; i++) {
+          bvh->intersectRays(*rays, hits, jobSystem.get());
+          doNotOptimize(hits.data());
+        }
+      });
+}
+
+void addSpatialHashBenchmarks(LveBenchSuite &suite) {
+  // people walking around the park, each moves a little every frame
+  constexpr size_t count = 10000;
+  auto bounds = std::make_shared<std::vector<LveAabb>>(count);
+  std::mt19937 rng{42};
+  std::uniform_real_distribution<float> position{-100.f, 100.f};
+  for (auto &box : *bounds) {
+    glm::vec3 center{position(rng), 0.f, position(rng)};
+    box = {center - glm::vec3{.5f, 1.f, .5f}, center + glm::vec3{.5f, 1.f, .5f}};
+  }
+  auto grid = std::make_shared<LveSpatialHash>();
+  for (size_t i = 0; i < count; i++) {
+    grid->insert(static_cast<LveGameObject::id_t>(i), (*bounds)[i]);
+  }
+
+  suite.add("LveSpatialHash::update/10k moving objects", count, [grid, bounds](uint64_t n) {
+    for (uint64_t i = 0; i < n; i++) {
+      glm::vec3 step{.05f * (i % 2 == 0 ? 1.f : -1.f), 0.f, .05f};
+      for (size_t j = 0; j < count; j++) {
+        auto &box = (*bounds)[j];
+        box = {box.min + step, box.max + step};
+        grid->update(static_cast<LveGameObject::id_t>(j), box);
+      }
+    }
+    doNotOptimize(grid->getCellCount());
+  });
+  // the same objects in a BVH, which has to refit every frame
+  auto bvh = std::make_shared<LveBvh>();
+  {
+    std::vector<LveBvh::Item> items(count);
+    for (size_t i = 0; i < count; i++) {
+      items[i] = {(*bounds)[i], static_cast<LveGameObject::id_t>(i), false};
+    }
+    bvh->build(std::move(items));
+  }
+  suite.add("LveBvh::setItemBounds+refit/10k moving objects", count, [bvh, bounds](uint64_t n) {
+    for (uint64_t i = 0; i < n; i++) {
+      for (size_t j = 0; j < count; j++) {
+        bvh->setItemBounds(static_cast<LveGameObject::id_t>(j), (*bounds)[j]);
+      }
+      bvh->refit();
+    }
+    doNotOptimize(bvh->getNodes().data());
+  });
+
+  constexpr size_t queryCount = 4096;
+  auto spheres = std::make_shared<std::vector<LveBoundingSphere>>(queryCount);
+  for (auto &sphere : *spheres) {
+    sphere = {{position(rng), 0.f, position(rng)}, 5.f};
+  }
+  suite.add("LveSpatialHash::querySpheres", queryCount, [grid, spheres](uint64_t n) {
+    std::vector<std::vector<LveGameObject::id_t>> results;
+    for (uint64_t i = 0; i < n; i++) {
+      grid->querySpheres(*spheres, results);
+      doNotOptimize(results.data());
+    }
+  });
+}
+
+void addTransformHierarchyBenchmarks(LveBenchSuite &suite) {
+  // 1000 groups of a root, 9 children and 9 grandchildren per child
+  constexpr int groups = 1000;
+  constexpr int fanOut = 9;
+  auto gameObjects = std::make_shared<LveGameObject::Map>();
+  auto hierarchy = std::make_shared<LveTransformHierarchy>();
+  auto roots = std::make_shared<std::vector<LveGameObject::id_t>>();
+  std::mt19937 rng{42};
+  std::uniform_real_distribution<float> position{-5.f, 5.f};
+  auto addObject = [&](LveGameObject::id_t parent, bool hasParent) {
+    auto obj = LveGameObject::createGameObject();
+    obj.transform.translation = {position(rng), position(rng), position(rng)};
+    obj.transform.rotation = {0.f, position(rng), 0.f};
+    LveGameObject::id_t id = obj.getId();
+    gameObjects->emplace(id, std::move(obj));
+    if (hasParent) {
+      hierarchy->setParent(id, parent);
+    }
+    return id;
+  };
+  for (int g = 0; g < groups; g++) {
+    LveGameObject::id_t root = addObject(0, false);
+    roots->push_back(root);
+    for (int c = 0; c < fanOut; c++) {
+      LveGameObject::id_t child = addObject(root, true);
+      for (int gc = 0; gc < fanOut; gc++) {
+        addObject(child, true);
+      }
+    }
+  }
+  const size_t count = gameObjects->size();
+  auto jobSystem = std::make_shared<LveJobSystem>();
+  std::string workers = std::to_string(jobSystem->getWorkerCount());
+  hierarchy->update(*gameObjects);
+
+  // every group moves, so every world matrix is recomputed
+  suite.add(
+      "LveTransformHierarchy::update all moved/" + workers + " workers",
+      count,
+      [gameObjects, hierarchy, roots, jobSystem](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) {
+          for (auto id : *roots) {
+            gameObjects->at(id).transform.rotation.y += .01f;
+          }
+          hierarchy->update(*gameObjects, jobSystem.get());
+          doNotOptimize(hierarchy->getLastRecomputedCount());
+        }
+      });
+  // 1% of the groups move, the rest is only copied out
+  suite.add(
+      "LveTransformHierarchy::update 1% moved/" + workers + " workers",
+      count,
+      [gameObjects, hierarchy, roots, jobSystem](uint64_t n) {
+        for (uint64_t i = 0; i < n; i++) {
+          for (size_t r = i % 100; r < roots->size(); r += 100) {
+            gameObjects->at((*roots)[r]).transform.rotation.y += .01f;
+          }
+          hierarchy->update(*gameObjects, jobSystem.get());
+          doNotOptimize(hierarchy->getLastRecomputedCount());
+        }
+      });
+}
+
+void addCameraBenchmarks(LveBenchSuite &suite) {
+  suite.add("LveCamera::setViewYXZ", 1, [](uint64_t n) {
+    LveCamera camera{};
+    for (uint64_t i = 0; i < n; i++) {
+      float t = static_cast<float>(i & 1023) * .001f;
+      camera.setViewYXZ({t, -2.f, -9.5f}, {.1f, t, 0.f});
+      doNotOptimize(camera.getView());
+    }
+  });
+
+  suite.add("LveCamera::setPerspectiveProjection", 1, [](uint64_t n) {
+    LveCamera camera{};
+    for (uint64_t i = 0; i < n; i++) {
+      float aspect = 1.f + static_cast<float>(i & 1023) * .001f;
+      camera.setPerspectiveProjection(glm::radians(50.f), aspect, .1f, 100.f);
+      doNotOptimize(camera.getProjection());
+    }
+  });
+}
+
+void addLightSortBenchmarks(LveBenchSuite &suite) {
+  // a park sized scene: mostly models, with a handful of point lights
+  for (int lightCount : {8, 64}) {
+    auto gameObjects = std::make_shared<LveGameObject::Map>();
+    std::mt19937 rng{7};
+    std::uniform_real_distribution<float> position{-20.f, 20.f};
+    for (int i = 0; i < 1000 + lightCount; i++) {
+      auto obj = i < lightCount ? LveGameObject::makePointLight(1.f)
+                                : LveGameObject::createGameObject();
+      obj.transform.translation = {position(rng), position(rng), position(rng)};
+      obj.worldMatrix = obj.transform.mat4();
+      gameObjects->emplace(obj.getId(), std::move(obj));
+    }
+
+    suite.add(
+        "PointLightSystem::sortLightsByDistance/" + std::to_string(lightCount) + " lights",
+        lightCount,
+        [gameObjects](uint64_t n) {
+          for (uint64_t i = 0; i < n; i++) {
+            glm::vec3 cameraPosition{static_cast<float>(i & 63) * .1f, -2.f, -9.5f};
+            auto sorted = PointLightSystem::sortLightsByDistance(*gameObjects, cameraPosition);
+            doNotOptimize(sorted.size());
+          }
+        });
+  }
+}
+
+void addDescriptorBenchmarks(LveBenchSuite &suite, bool useDevice) {
+  constexpr const char *name = "LveDescriptorWriter::build";
+  if (!useDevice) {
+    suite.skip(name, "needs a Vulkan device, run with --device");
+    return;
+  }
+
+  std::shared_ptr<LveDevice> device;
+  try {
+    device = std::make_shared<LveDevice>();
+  } catch (const std::exception &e) {
+    suite.skip(name, std::string{"no Vulkan device: "} + e.what());
+    return;
+  }
+
+  constexpr uint32_t setsPerPool = 1024;
+  std::shared_ptr<LveDescriptorSetLayout> layout =
+      LveDescriptorSetLayout::Builder(*device)
+          .addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_ALL_GRAPHICS)
+          .build();
+  std::shared_ptr<LveDescriptorPool> pool =
+      LveDescriptorPool::Builder(*device)
+          .setMaxSets(setsPerPool)
+          .addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, setsPerPool)
+          .build();
+  auto buffer = std::make_shared<LveBuffer>(
+      *device,
+      sizeof(glm::mat4),
+      1,
+      VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+
+  // captures keep the device alive for as long as the suite holds the case
+  suite.add(name, 1, [device, layout, pool, buffer](uint64_t n) {
+    auto bufferInfo = buffer->descriptorInfo();
+    for (uint64_t i = 0; i < n; i++) {
+      if (i % setsPerPool == 0) {
+        pool->resetPool();
+      }
+      VkDescriptorSet set;
+      LveDescriptorWriter(*layout, *pool).writeBuffer(0, &bufferInfo).build(set);
+      doNotOptimize(set);
+    }
+    pool->resetPool();
+  });
+}
+
+}  // namespace
+
+void registerEngineBenchmarks(LveBenchSuite &suite, const LveBenchOptions &options) {
+  std::vector<std::string> modelFiles = options.modelFiles;
+  modelFiles.push_back(writeSyntheticObj(128));
+
+  addModelBenchmarks(suite, modelFiles);
+  addTransformBenchmarks(suite);
+  addJobSystemBenchmarks(suite);
+  addQueueBenchmarks(suite);
+  addSceneBenchmarks(suite);
+  addBvhBenchmarks(suite);
+  addSpatialHashBenchmarks(suite);
+  addTransformHierarchyBenchmarks(suite);
+  addCameraBenchmarks(suite);
+  addLightSortBenchmarks(suite);
+  addDescriptorBenchmarks(suite, options.useDevice);
+}
+
+}  // namespace lve
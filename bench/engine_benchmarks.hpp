@@ -0,0 +1,20 @@
+#pragma once
+
+#include "lve_bench.hpp"
+
+// std
+#include <string>
+#include <vector>
+
+namespace lve {
+
+struct LveBenchOptions {
+  // OBJ files to load in addition to the generated grid mesh
+  std::vector<std::string> modelFiles{};
+  // create a headless Vulkan device for the cases that need one
+  bool useDevice = false;
+};
+
+void registerEngineBenchmarks(LveBenchSuite &suite, const LveBenchOptions &options);
+
+}  // namespace lve
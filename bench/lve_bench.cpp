@@ -0,0 +1,124 @@
+#include "lve_bench.hpp"
+
+// std
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace lve {
+
+namespace {
+
+double secondsFor(const LveBenchSuite::RunFn &run, uint64_t iterations) {
+  auto start = std::chrono::steady_clock::now();
+  run(iterations);
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+void writeJsonString(std::ostream &out, const std::string &text) {
+  out << '"';
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      out << '\\';
+    }
+    out << c;
+  }
+  out << '"';
+}
+
+}  // namespace
+
+void LveBenchSuite::add(const std::string &name, uint64_t itemsPerIteration, RunFn run) {
+  cases.push_back({name, itemsPerIteration, std::move(run)});
+}
+
+void LveBenchSuite::skip(const std::string &name, const std::string &reason) {
+  skipped.emplace_back(name, reason);
+}
+
+LveBenchSuite::Result LveBenchSuite::measure(const Case &benchCase) const {
+  // warm caches and find a batch size that is long enough to time reliably
+  uint64_t iterations = 1;
+  double seconds = secondsFor(benchCase.run, iterations);
+  while (seconds < minSeconds && iterations < (1ull << 40)) {
+    double scale = seconds > 0.0 ? std::min(10.0, 1.5 * minSeconds / seconds) : 10.0;
+    iterations = std::max(iterations + 1, static_cast<uint64_t>(iterations * scale));
+    seconds = secondsFor(benchCase.run, iterations);
+  }
+
+  std::vector<double> samples;
+  for (int i = 0; i < repetitions; i++) {
+    samples.push_back(secondsFor(benchCase.run, iterations) * 1e9 / iterations);
+  }
+  std::sort(samples.begin(), samples.end());
+
+  Result result{};
+  result.name = benchCase.name;
+  result.iterations = iterations;
+  result.itemsPerIteration = benchCase.itemsPerIteration;
+  result.nsPerIteration = samples[samples.size() / 2];
+  result.nsPerIterationMin = samples.front();
+  result.nsPerIterationMax = samples.back();
+  return result;
+}
+
+void LveBenchSuite::run(std::ostream &log) {
+  results.clear();
+  char line[256];
+  for (const auto &benchCase : cases) {
+    if (!filter.empty() && benchCase.name.find(filter) == std::string::npos) continue;
+
+    results.push_back(measure(benchCase));
+    const auto &result = results.back();
+    std::snprintf(
+        line,
+        sizeof(line),
+        "%-48s %14.1f ns/iter %14.3e items/s  (%llu iterations)\n",
+        result.name.c_str(),
+        result.nsPerIteration,
+        result.itemsPerSecond(),
+        static_cast<unsigned long long>(result.iterations));
+    log << line << std::flush;
+  }
+  for (const auto &[name, reason] : skipped) {
+    if (!filter.empty() && name.find(filter) == std::string::npos) continue;
+    log << name << ": skipped, " << reason << "\n";
+  }
+}
+
+void LveBenchSuite::writeJson(std::ostream &out) const {
+  char number[64];
+  auto writeNumber = [&](double value) {
+    std::snprintf(number, sizeof(number), "%.3f", value);
+    out << number;
+  };
+
+  out << "{\n  \"benchmarks\": [";
+  for (size_t i = 0; i < results.size(); i++) {
+    const auto &result = results[i];
+    out << (i == 0 ? "\n" : ",\n") << "    {\"name\": ";
+    writeJsonString(out, result.name);
+    out << ", \"iterations\": " << result.iterations
+        << ", \"itemsPerIteration\": " << result.itemsPerIteration << ", \"nsPerIteration\": ";
+    writeNumber(result.nsPerIteration);
+    out << ", \"nsPerIterationMin\": ";
+    writeNumber(result.nsPerIterationMin);
+    out << ", \"nsPerIterationMax\": ";
+    writeNumber(result.nsPerIterationMax);
+    out << ", \"itemsPerSecond\": ";
+    writeNumber(result.itemsPerSecond());
+    out << "}";
+  }
+  out << (results.empty() ? "" : "\n  ") << "],\n  \"skipped\": [";
+  for (size_t i = 0; i < skipped.size(); i++) {
+    out << (i == 0 ? "\n" : ",\n") << "    {\"name\": ";
+    writeJsonString(out, skipped[i].first);
+    out << ", \"reason\": ";
+    writeJsonString(out, skipped[i].second);
+    out << "}";
+  }
+  out << (skipped.empty() ? "" : "\n  ") << "]\n}\n";
+}
+
+}  // namespace lve
@@ -0,0 +1,76 @@
+#pragma once
+
+// std
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace lve {
+
+// Keeps the compiler from optimizing away a value computed by a benchmark
+template <typename T>
+inline void doNotOptimize(const T &value) {
+#if defined(_MSC_VER)
+  const volatile char *sink = reinterpret_cast<const volatile char *>(&value);
+  (void)*sink;
+  _ReadWriteBarrier();
+#else
+  asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+// Minimal microbenchmark runner. Each case is run with a growing iteration count until a batch
+// takes at least minSeconds, then that batch size is timed `repetitions` times and the median
+// is reported.
+class LveBenchSuite {
+ public:
+  // runs the measured operation `iterations` times
+  using RunFn = std::function<void(uint64_t iterations)>;
+
+  struct Result {
+    std::string name;
+    uint64_t iterations;
+    uint64_t itemsPerIteration;
+    double nsPerIteration;
+    double nsPerIterationMin;
+    double nsPerIterationMax;
+    double itemsPerSecond() const {
+      return nsPerIteration > 0.0 ? itemsPerIteration * 1e9 / nsPerIteration : 0.0;
+    }
+  };
+
+  void add(const std::string &name, uint64_t itemsPerIteration, RunFn run);
+  void skip(const std::string &name, const std::string &reason);
+
+  void setFilter(const std::string &substring) { filter = substring; }
+  void setMinSeconds(double seconds) { minSeconds = seconds; }
+  void setRepetitions(int count) { repetitions = count; }
+
+  // Runs every case matching the filter, printing a human readable line per case to log
+  void run(std::ostream &log);
+  void writeJson(std::ostream &out) const;
+
+ private:
+  struct Case {
+    std::string name;
+    uint64_t itemsPerIteration;
+    RunFn run;
+  };
+
+  Result measure(const Case &benchCase) const;
+
+  std::vector<Case> cases;
+  std::vector<std::pair<std::string, std::string>> skipped;
+  std::vector<Result> results;
+  std::string filter{};
+  double minSeconds = 0.2;
+  int repetitions = 5;
+};
+
+}  // namespace lve
@@ -0,0 +1,76 @@
+#include "engine_benchmarks.hpp"
+#include "lve_bench.hpp"
+
+// std
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+void printUsage(const char *program) {
+  std::cerr << "usage: " << program
+            << " [--filter TEXT] [--min-time S] [--repetitions N] [--model FILE]... [--device]"
+            << " [--out FILE]\n"
+            << "  --filter TEXT     only run cases whose name contains TEXT\n"
+            << "  --min-time S      minimum duration of a timed batch (default: 0.2)\n"
+            << "  --repetitions N   timed batches per case, the median is reported (default: 5)\n"
+            << "  --model FILE      also benchmark loading FILE, may be repeated\n"
+            << "  --device          create a headless Vulkan device for descriptor cases\n"
+            << "  --out FILE        write JSON results to FILE instead of stdout\n";
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  lve::LveBenchSuite suite{};
+  lve::LveBenchOptions options{};
+  std::string outputFile{};
+
+  try {
+    for (int i = 1; i < argc; i++) {
+      std::string arg = argv[i];
+      if (arg == "--filter" && i + 1 < argc) {
+        suite.setFilter(argv[++i]);
+      } else if (arg == "--min-time" && i + 1 < argc) {
+        suite.setMinSeconds(std::stod(argv[++i]));
+      } else if (arg == "--repetitions" && i + 1 < argc) {
+        suite.setRepetitions(std::stoi(argv[++i]));
+      } else if (arg == "--model" && i + 1 < argc) {
+        options.modelFiles.push_back(argv[++i]);
+      } else if (arg == "--device") {
+        options.useDevice = true;
+      } else if (arg == "--out" && i + 1 < argc) {
+        outputFile = argv[++i];
+      } else {
+        throw std::invalid_argument("unknown argument: " + arg);
+      }
+    }
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << '\n';
+    printUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  try {
+    lve::registerEngineBenchmarks(suite, options);
+    suite.run(std::cerr);
+
+    if (outputFile.empty()) {
+      suite.writeJson(std::cout);
+    } else {
+      std::ofstream out{outputFile};
+      if (!out.is_open()) {
+        throw std::runtime_error("failed to open output file: " + outputFile);
+      }
+      suite.writeJson(out);
+    }
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << '\n';
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
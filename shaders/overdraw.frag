@@ -0,0 +1,8 @@
+#version 450
+
+// additively blended, so the target ends up holding the fragment count of every texel
+layout(location = 0) out float outLayers;
+
+void main() {
+  outLayers = 1.0;
+}
@@ -0,0 +1,18 @@
+#version 450
+
+// only position is read, the remaining LveModel::Vertex attributes are ignored
+layout(location = 0) in vec3 position;
+
+// leading members of GlobalUbo in lve_frame_info.hpp
+layout(set = 0, binding = 0) uniform GlobalUbo {
+  mat4 projection;
+  mat4 view;
+} ubo;
+
+layout(push_constant) uniform Push {
+  mat4 modelMatrix;
+} push;
+
+void main() {
+  gl_Position = ubo.projection * ubo.view * push.modelMatrix * vec4(position, 1.0);
+}
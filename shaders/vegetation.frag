@@ -0,0 +1,50 @@
+#version 450
+
+layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec3 fragPosWorld;
+layout(location = 2) in vec3 fragNormalWorld;
+
+layout(location = 0) out vec4 outColor;
+
+struct PointLight {
+  vec4 position;  // ignore w
+  vec4 color;     // w is intensity
+};
+
+// GlobalUbo in lve_frame_info.hpp
+layout(set = 0, binding = 0) uniform GlobalUbo {
+  mat4 projection;
+  mat4 view;
+  mat4 invView;
+  vec4 ambientLightColor;  // w is intensity
+  PointLight pointLights[10];
+  int numLights;
+} ubo;
+
+void main() {
+  vec3 diffuseLight = ubo.ambientLightColor.xyz * ubo.ambientLightColor.w;
+  vec3 specularLight = vec3(0.0);
+  vec3 surfaceNormal = normalize(fragNormalWorld);
+
+  vec3 cameraPosWorld = ubo.invView[3].xyz;
+  vec3 viewDirection = normalize(cameraPosWorld - fragPosWorld);
+
+  for (int i = 0; i < ubo.numLights; i++) {
+    PointLight light = ubo.pointLights[i];
+    vec3 directionToLight = light.position.xyz - fragPosWorld;
+    float attenuation = 1.0 / dot(directionToLight, directionToLight);  // distance squared
+    directionToLight = normalize(directionToLight);
+
+    // leaves are thin, light them from either side
+    float cosAngIncidence = abs(dot(surfaceNormal, directionToLight));
+    vec3 intensity = light.color.xyz * light.color.w * attenuation;
+    diffuseLight += intensity * cosAngIncidence;
+
+    vec3 halfAngle = normalize(directionToLight + viewDirection);
+    float blinnTerm = clamp(abs(dot(surfaceNormal, halfAngle)), 0, 1);
+    blinnTerm = pow(blinnTerm, 32.0);
+    specularLight += intensity * blinnTerm;
+  }
+
+  outColor = vec4(diffuseLight * fragColor + specularLight * fragColor, 1.0);
+}
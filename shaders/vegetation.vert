@@ -0,0 +1,68 @@
+#version 450
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 color;
+layout(location = 2) in vec3 normal;
+layout(location = 3) in vec2 uv;
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec3 fragPosWorld;
+layout(location = 2) out vec3 fragNormalWorld;
+
+struct PointLight {
+  vec4 position;  // ignore w
+  vec4 color;     // w is intensity
+};
+
+// GlobalUbo in lve_frame_info.hpp
+layout(set = 0, binding = 0) uniform GlobalUbo {
+  mat4 projection;
+  mat4 view;
+  mat4 invView;
+  vec4 ambientLightColor;  // w is intensity
+  PointLight pointLights[10];
+  int numLights;
+} ubo;
+
+// matches VegetationInstance in vegetation_system.cpp
+struct Instance {
+  vec4 positionScale;
+  float yaw;
+  uint variant;
+  uint padding0;
+  uint padding1;
+};
+
+struct Variant {
+  mat4 modelMatrix;
+  mat4 normalMatrix;
+  vec4 boundingSphere;
+};
+
+layout(std430, set = 1, binding = 1) readonly buffer Draws {
+  Variant variants[4];
+};
+
+// filled by vegetation_cull.comp, gl_InstanceIndex includes the draw's firstInstance
+layout(std430, set = 1, binding = 2) readonly buffer Visible {
+  Instance visible[];
+};
+
+vec3 rotateY(vec3 v, float c, float s) {
+  return vec3(c * v.x + s * v.z, v.y, -s * v.x + c * v.z);
+}
+
+void main() {
+  Instance instance = visible[gl_InstanceIndex];
+  Variant variant = variants[instance.variant];
+  float c = cos(instance.yaw);
+  float s = sin(instance.yaw);
+
+  vec3 local = (variant.modelMatrix * vec4(position, 1.0)).xyz * instance.positionScale.w;
+  vec4 positionWorld = vec4(rotateY(local, c, s) + instance.positionScale.xyz, 1.0);
+  gl_Position = ubo.projection * ubo.view * positionWorld;
+
+  fragNormalWorld = normalize(rotateY(mat3(variant.normalMatrix) * normal, c, s));
+  fragPosWorld = positionWorld.xyz;
+  fragColor = color;
+}
@@ -1,10 +1,18 @@
 #include "first_app.hpp"
 
 #include "keyboard_movement_controller.hpp"
+#include "lve_batch_renderer.hpp"
 #include "lve_buffer.hpp"
 #include "lve_camera.hpp"
+#include "lve_cpu_profiler.hpp"
+#include "lve_fixed_timestep.hpp"
+#include "lve_hitch_detector.hpp"
+#include "lve_render_snapshot.hpp"
+#include "lve_scene.hpp"
+#include "systems/overdraw_system.hpp"
 #include "systems/point_light_system.hpp"
 #include "systems/simple_render_system.hpp"
+#include "systems/vegetation_system.hpp"
 
 // libs
 #define GLM_FORCE_RADIANS
@@ -17,32 +25,235 @@
 #include <cassert>
 #include <chrono>
 #include <stdexcept>
-#include <cstdlib> // for rand() and srand()
-#include <ctime> // for time()
+#include <fstream>
+#include <iostream>
 
 namespace lve {
 
-FirstApp::FirstApp() {
+namespace {
+
+// park plants and bushes over the ground quad, see scenes/park.scene for the models' placement
+VegetationSystem::Config vegetationConfig(const AppConfig &config) {
+  VegetationSystem::Config vegetation{};
+  vegetation.count = config.vegetationCount;
+  vegetation.seed = config.vegetationSeed;
+  vegetation.densityMapFile = config.vegetationDensityMap;
+
+  VegetationSystem::Variant plant{};
+  plant.modelPath = "models/park/plant/plant-1.obj";
+  plant.weight = 3.f;
+  plant.transform.rotation = {0.f, 0.f, 3.1f};
+  VegetationSystem::Variant bush{};
+  bush.modelPath = "models/park/bush/bush-1.obj";
+  bush.transform.translation = {0.f, -.3f, 0.f};
+  bush.transform.scale = {.5f, 1.f, .5f};
+  vegetation.variants = {plant, bush};
+  return vegetation;
+}
+
+// Joins a job on every way out of the scope, for jobs that write into locals of that scope
+struct LveJobJoin {
+  LveJobSystem &jobSystem;
+  LveJobCounter &counter;
+  ~LveJobJoin() { jobSystem.wait(counter); }
+};
+
+}  // namespace
+
+FirstApp::FirstApp(const AppConfig &config)
+    : config{config}, startTime{std::chrono::high_resolution_clock::now()} {
+  jobSystem = std::make_unique<LveJobSystem>(config.workerCount);
+  if (!config.benchmark.outputFile.empty()) {
+    this->config.frameCount = config.benchmark.warmupFrames + config.benchmark.measuredFrames;
+  }
+  if (config.headless) {
+    lveDevice = std::make_unique<LveDevice>();
+    lveRenderer = std::make_unique<LveRenderer>(
+        *lveDevice,
+        VkExtent2D{static_cast<uint32_t>(WIDTH), static_cast<uint32_t>(HEIGHT)});
+  } else {
+    lveWindow =
+        std::make_unique<LveWindow>(WIDTH, HEIGHT, "GitGud Advanced Grapichs Final Project");
+    lveDevice = std::make_unique<LveDevice>(*lveWindow);
+    lveRenderer = std::make_unique<LveRenderer>(*lveWindow, *lveDevice);
+  }
+  assetStreamer = std::make_unique<LveAssetStreamer>(*lveDevice, *jobSystem);
+  if (!config.captureDirectory.empty()) {
+    lveRenderer->enableReadback(config.captureDirectory, config.captureFormat);
+  }
+  // hitch reports are built from the profilers' data
+  lveRenderer->getGpuProfiler().setEnabled(config.gpuProfile || config.detectHitches);
+  lveRenderer->getPipelineStatistics().setEnabled(config.pipelineStatistics);
+  if (!config.cpuTraceFile.empty() || config.detectHitches) {
+    LveCpuProfiler::setThreadName("main");
+    LveCpuProfiler::setEnabled(true);
+  }
+
   globalPool =
-      LveDescriptorPool::Builder(lveDevice)
+      LveDescriptorPool::Builder(*lveDevice)
           .setMaxSets(LveSwapChain::MAX_FRAMES_IN_FLIGHT)
           .addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, LveSwapChain::MAX_FRAMES_IN_FLIGHT)
           .build();
-  loadGameObjects();
-  loadTreeObjects();
-  loadBenchObjects();
-  loadBushObjects();
-  loadSolarLight();
-  loadPlantObjects();
+  loadScene();
+  if (config.vegetationCount > 0) {
+    for (const auto &variant : vegetationConfig(config).variants) {
+      if (modelUsers.find(variant.modelPath) == modelUsers.end()) {
+        assetStreamer->requestModel(variant.modelPath);
+        modelUsers[variant.modelPath];
+      }
+    }
+  }
+
+  // models load and upload in the background and pop in once ready, which is fine interactively
+  // but would make captured, batch and benchmark frames depend on load timing
+  if (config.headless || !config.captureDirectory.empty() || !config.batchPosesFile.empty() ||
+      !config.benchmark.outputFile.empty()) {
+    LVE_CPU_ZONE("wait for models");
+    assetStreamer->drainAll([this](const std::string &filepath, std::unique_ptr<LveModel> model) {
+      onModelLoaded(filepath, std::move(model));
+    });
+    lveDevice->flushTransfers();
+  }
 }
 
 FirstApp::~FirstApp() {}
 
+void FirstApp::loadScene() {
+  LVE_CPU_ZONE("FirstApp::loadScene");
+  auto scene = LveScene::loadFromFile(config.sceneFile);
+
+  // every model starts loading in the background before the objects are created
+  const auto &modelPaths = scene.getModelPaths();
+  for (const auto &filepath : modelPaths) {
+    if (modelUsers.find(filepath) == modelUsers.end()) {
+      assetStreamer->requestModel(filepath);
+      modelUsers[filepath];
+    }
+  }
+
+  gameObjects.reserve(gameObjects.size() + scene.getInstanceCount() + scene.getLights().size());
+  const LveScene::Instance *instances = scene.getInstances();
+  std::vector<LveGameObject::id_t> instanceIds(scene.getInstanceCount());
+  for (size_t i = 0; i < scene.getInstanceCount(); i++) {
+    const auto &instance = instances[i];
+    auto object = LveGameObject::createGameObject();
+    object.transform.translation = instance.translation;
+    object.transform.rotation = instance.rotation;
+    object.transform.scale = instance.scale;
+    object.isStatic = (instance.flags & LveScene::FLAG_STATIC) != 0;
+    if (instance.model != LveScene::NO_MODEL) {
+      setModel(object, modelPaths[instance.model]);
+    }
+    // parents come before their children, so the parent's object already exists
+    if (instance.parent != LveScene::NO_PARENT) {
+      transformHierarchy.setParent(object.getId(), instanceIds[instance.parent]);
+    }
+    instanceIds[i] = object.getId();
+    gameObjects.emplace(object.getId(), std::move(object));
+  }
+
+  for (const auto &light : scene.getLights()) {
+    auto object = LveGameObject::makePointLight(light.intensity, light.radius, light.color);
+    object.transform.translation = light.position;
+    object.isStatic = (light.flags & LveScene::FLAG_STATIC) != 0;
+    gameObjects.emplace(object.getId(), std::move(object));
+  }
+}
+
+void FirstApp::setModel(LveGameObject &object, const std::string &filepath) {
+  auto model = models.find(filepath);
+  if (model != models.end()) {
+    object.model = model->second;
+    return;
+  }
+  auto users = modelUsers.find(filepath);
+  if (users == modelUsers.end()) {
+    assetStreamer->requestModel(filepath);
+    users = modelUsers.emplace(filepath, std::vector<LveGameObject::id_t>{}).first;
+  }
+  users->second.push_back(object.getId());
+}
+
+void FirstApp::streamModels() {
+  assetStreamer->drain(
+      config.streamingBudgetMs / 1000.0,
+      [this](const std::string &filepath, std::unique_ptr<LveModel> model) {
+        onModelLoaded(filepath, std::move(model));
+      });
+}
+
+void FirstApp::onModelLoaded(const std::string &filepath, std::unique_ptr<LveModel> model) {
+  std::shared_ptr<LveModel> shared = std::move(model);
+  models[filepath] = shared;
+  if (vegetationSystem) {
+    vegetationSystem->onModelLoaded(filepath, shared);
+  }
+  auto users = modelUsers.find(filepath);
+  if (users == modelUsers.end()) {
+    return;
+  }
+  for (auto id : users->second) {
+    auto object = gameObjects.find(id);
+    if (object != gameObjects.end()) {
+      object->second.model = shared;
+    }
+  }
+  modelUsers.erase(users);
+}
+
+void FirstApp::updateStartupMetrics(uint64_t frameNumber) {
+  if (fullyLoadedMs >= 0.0) {
+    return;
+  }
+  auto elapsedMs = [this] {
+    return std::chrono::duration<double, std::chrono::milliseconds::period>(
+               std::chrono::high_resolution_clock::now() - startTime)
+        .count();
+  };
+  if (firstFrameMs < 0.0 && frameNumber > 0) {
+    firstFrameMs = elapsedMs();
+    std::cout << "startup: first frame after " << firstFrameMs << " ms" << std::endl;
+  }
+  if (!assetStreamer->isIdle() || !modelUsers.empty()) {
+    return;
+  }
+  for (const auto &kv : models) {
+    if (!kv.second->isReady()) {
+      return;
+    }
+  }
+  fullyLoadedMs = elapsedMs();
+  std::cout << "startup: " << models.size() << " models loaded after " << fullyLoadedMs << " ms"
+            << std::endl;
+}
+
+bool FirstApp::shouldClose(uint64_t frameNumber) const {
+  if (config.frameCount > 0 && frameNumber >= config.frameCount) {
+    return true;
+  }
+  return lveWindow != nullptr && lveWindow->shouldClose();
+}
+
+void FirstApp::writeCpuTrace() const {
+  LveCpuProfiler::writeChromeTrace(config.cpuTraceFile, config.cpuTraceSeconds);
+  std::cout << "wrote CPU trace of the last " << config.cpuTraceSeconds << "s to "
+            << config.cpuTraceFile << std::endl;
+}
+
+void FirstApp::updateProfilerOverlay(float frameTime) {
+  overlayTimer += frameTime;
+  if (lveWindow == nullptr || overlayTimer < .5f) {
+    return;
+  }
+  overlayTimer = 0.f;
+  lveWindow->setTitle(lveWindow->getName() + " - " + lveRenderer->getGpuProfiler().overlayText());
+}
+
 void FirstApp::run() {
   std::vector<std::unique_ptr<LveBuffer>> uboBuffers(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
   for (int i = 0; i < uboBuffers.size(); i++) {
     uboBuffers[i] = std::make_unique<LveBuffer>(
-        lveDevice,
+        *lveDevice,
         sizeof(GlobalUbo),
         1,
         VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
@@ -51,8 +262,11 @@ void FirstApp::run() {
   }
 
   auto globalSetLayout =
-      LveDescriptorSetLayout::Builder(lveDevice)
-          .addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_ALL_GRAPHICS)
+      LveDescriptorSetLayout::Builder(*lveDevice)
+          .addBinding(
+              0,
+              VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+              VK_SHADER_STAGE_ALL_GRAPHICS | VK_SHADER_STAGE_COMPUTE_BIT)
           .build();
 
   std::vector<VkDescriptorSet> globalDescriptorSets(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
@@ -64,242 +278,377 @@ void FirstApp::run() {
   }
 
   SimpleRenderSystem simpleRenderSystem{
-      lveDevice,
-      lveRenderer.getSwapChainRenderPass(),
+      *lveDevice,
+      lveRenderer->getSwapChainRenderPass(),
       globalSetLayout->getDescriptorSetLayout()};
   PointLightSystem pointLightSystem{
-      lveDevice,
-      lveRenderer.getSwapChainRenderPass(),
+      *lveDevice,
+      lveRenderer->getSwapChainRenderPass(),
       globalSetLayout->getDescriptorSetLayout()};
-  LveCamera camera{};
-
-  auto viewerObject = LveGameObject::createGameObject();
-  viewerObject.transform.translation.z = -9.5f;
-  viewerObject.transform.translation.y = -2.f;
-  KeyboardMovementController cameraController{};
-
-  auto currentTime = std::chrono::high_resolution_clock::now();
-  while (!lveWindow.shouldClose()) {
-    glfwPollEvents();
-
-    auto newTime = std::chrono::high_resolution_clock::now();
-    float frameTime =
-        std::chrono::duration<float, std::chrono::seconds::period>(newTime - currentTime).count();
-    currentTime = newTime;
-
-    cameraController.moveInPlaneXZ(lveWindow.getGLFWwindow(), frameTime, viewerObject);
-    camera.setViewYXZ(viewerObject.transform.translation, viewerObject.transform.rotation);
-
-    float aspect = lveRenderer.getAspectRatio();
-    camera.setPerspectiveProjection(glm::radians(50.f), aspect, 0.1f, 100.f);
 
-    if (auto commandBuffer = lveRenderer.beginFrame()) {
-      int frameIndex = lveRenderer.getFrameIndex();
-      FrameInfo frameInfo{
-          frameIndex,
-          frameTime,
-          commandBuffer,
-          camera,
-          globalDescriptorSets[frameIndex],
-          gameObjects};
+  if (config.vegetationCount > 0) {
+    vegetationSystem = std::make_unique<VegetationSystem>(
+        *lveDevice,
+        lveRenderer->getSwapChainRenderPass(),
+        globalSetLayout->getDescriptorSetLayout(),
+        vegetationConfig(config));
+    for (const auto &kv : models) {
+      vegetationSystem->onModelLoaded(kv.first, kv.second);
+    }
+    std::cout << "vegetation: " << vegetationSystem->getInstanceCount() << " of "
+              << config.vegetationCount << " plants scattered" << std::endl;
+  }
 
-      // update
-      GlobalUbo ubo{};
-      ubo.projection = camera.getProjection();
-      ubo.view = camera.getView();
-      ubo.inverseView = camera.getInverseView();
+  auto updateGlobalUbo = [&](FrameInfo &frameInfo) {
+    GlobalUbo ubo{};
+    ubo.projection = frameInfo.camera.getProjection();
+    ubo.view = frameInfo.camera.getView();
+    ubo.inverseView = frameInfo.camera.getInverseView();
+    {
+      LVE_CPU_ZONE("PointLightSystem::update");
       pointLightSystem.update(frameInfo, ubo);
-      uboBuffers[frameIndex]->writeToBuffer(&ubo);
-      uboBuffers[frameIndex]->flush();
+    }
+    LVE_CPU_ZONE("ubo write");
+    uboBuffers[frameInfo.frameIndex]->writeToBuffer(&ubo);
+    uboBuffers[frameInfo.frameIndex]->flush();
+    frameInfo.stats.recordUpload(sizeof(GlobalUbo));
+  };
 
-      // render
-      lveRenderer.beginSwapChainRenderPass(commandBuffer);
+  std::unique_ptr<OverdrawSystem> overdrawSystem;
+  if (config.overdraw) {
+    overdrawSystem =
+        std::make_unique<OverdrawSystem>(*lveDevice, globalSetLayout->getDescriptorSetLayout());
+    overdrawSystem->setVegetation(vegetationSystem.get());
+  }
 
-      // order here matters
+  auto renderScene = [&](FrameInfo &frameInfo) {
+    auto &gpuProfiler = lveRenderer->getGpuProfiler();
+    auto &pipelineStatistics = lveRenderer->getPipelineStatistics();
+    // order here matters
+    {
+      LVE_CPU_ZONE("SimpleRenderSystem::renderGameObjects");
+      LveGpuZone zone{gpuProfiler, frameInfo.commandBuffer, "SimpleRenderSystem"};
+      LvePipelineStatisticsScope statistics{
+          pipelineStatistics,
+          frameInfo.commandBuffer,
+          "SimpleRenderSystem"};
       simpleRenderSystem.renderGameObjects(frameInfo);
+    }
+    if (vegetationSystem) {
+      LVE_CPU_ZONE("VegetationSystem::render");
+      LveGpuZone zone{gpuProfiler, frameInfo.commandBuffer, "VegetationSystem"};
+      LvePipelineStatisticsScope statistics{
+          pipelineStatistics,
+          frameInfo.commandBuffer,
+          "VegetationSystem"};
+      vegetationSystem->render(frameInfo);
+    }
+    {
+      LVE_CPU_ZONE("PointLightSystem::render");
+      LveGpuZone zone{gpuProfiler, frameInfo.commandBuffer, "PointLightSystem"};
+      LvePipelineStatisticsScope statistics{
+          pipelineStatistics,
+          frameInfo.commandBuffer,
+          "PointLightSystem"};
       pointLightSystem.render(frameInfo);
-
-      lveRenderer.endSwapChainRenderPass(commandBuffer);
-      lveRenderer.endFrame();
     }
-  }
+  };
 
-  vkDeviceWaitIdle(lveDevice.device());
-}
+  // the vegetation cull runs on the compute queue, the frame's draws wait for it
+  auto cullVegetation = [&](FrameInfo &frameInfo) {
+    if (!vegetationSystem) {
+      return;
+    }
+    LVE_CPU_ZONE("VegetationSystem::cull");
+    VkCommandBuffer computeCommandBuffer = lveRenderer->beginCompute();
+    vegetationSystem->cull(frameInfo, computeCommandBuffer);
+    lveRenderer->endCompute(
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT);
+  };
 
-void FirstApp::loadGameObjects() {
-  std::shared_ptr<LveModel> lveModel = LveModel::createModelFromFile(lveDevice, "models/quad.obj");
-  auto floor = LveGameObject::createGameObject();
-  floor.model = lveModel;
-  floor.transform.translation = {0.f, .5f, 0.f};
-  floor.transform.scale = {10.f, 2.f, 10.f};
-  gameObjects.emplace(floor.getId(), std::move(floor));
-
-  lveModel = LveModel::createModelFromFile(lveDevice, "models/simple_model.obj");
-  auto characterlowpoly2 = LveGameObject::createGameObject();
-  characterlowpoly2.model = lveModel;
-  characterlowpoly2.transform.translation = {1.f, -.2f, 0.f};
-  characterlowpoly2.transform.scale = {.2f, .2f, .2f};
-  gameObjects.emplace(characterlowpoly2.getId(), std::move(characterlowpoly2));
-
-  /*
-  std::vector<glm::vec3> lightColors{
-      {1.f, .1f, .1f},
-      {.1f, .1f, 1.f},
-      {.1f, 1.f, .1f},
-      {1.f, 1.f, .1f},
-      {.1f, 1.f, 1.f},
-      {1.f, 1.f, 1.f},  //
-      {1.f, 0.5f, 0.f}
+  auto logDiagnostics = [&]() {
+    if (config.gpuProfile) {
+      lveRenderer->getGpuProfiler().logReport(std::cout);
+    }
+    if (config.frameStats) {
+      lveRenderer->getFrameStats().logReport(std::cout);
+    }
+    if (config.pipelineStatistics) {
+      auto &pipelineStatistics = lveRenderer->getPipelineStatistics();
+      pipelineStatistics.collectAll();
+      VkExtent2D extent = lveRenderer->getExtent();
+      pipelineStatistics.logReport(std::cout, static_cast<uint64_t>(extent.width) * extent.height);
+    }
+    if (overdrawSystem) {
+      overdrawSystem->collectAll();
+      overdrawSystem->logReport(std::cout);
+      if (!config.overdrawImageFile.empty()) {
+        overdrawSystem->writeImage(config.overdrawImageFile);
+      }
+    }
+    if (config.jobStats) {
+      jobSystem->logReport(std::cout);
+    }
+    if (!config.cpuTraceFile.empty()) {
+      writeCpuTrace();
+    }
   };
 
-  for (int i = 0; i < lightColors.size(); i++) {
-    auto pointLight = LveGameObject::makePointLight(5.2f);
-    pointLight.color = lightColors[i];
-    auto rotateLight = glm::rotate(
-        glm::mat4(1.f),
-        (i * glm::two_pi<float>()) / lightColors.size(),
-        {0.f, -1.f, 0.f});
-    pointLight.transform.translation = glm::vec3(rotateLight * glm::vec4(-1.f, -1.f, -1.f, 1.f));
-    gameObjects.emplace(pointLight.getId(), std::move(pointLight));
-  }*/
-}
+  if (!config.batchPosesFile.empty()) {
+    auto views = LveBatchRenderer::loadPoses(
+        config.batchPosesFile,
+        glm::radians(50.f),
+        lveRenderer->getAspectRatio(),
+        0.1f,
+        100.f);
+    transformHierarchy.update(gameObjects, jobSystem.get());
+    LveBatchRenderer batchRenderer{*lveRenderer, gameObjects, *jobSystem};
+    auto stats = batchRenderer.render(
+        views,
+        [&](VkCommandBuffer commandBuffer,
+            int frameIndex,
+            LveCamera &view,
+            const std::vector<LveGameObject::id_t> &visibleObjects) {
+          // a frame time of 0 keeps the lights still, so every view sees the same scene
+          FrameInfo frameInfo{
+              frameIndex,
+              0.f,
+              commandBuffer,
+              view,
+              globalDescriptorSets[frameIndex],
+              gameObjects,
+              lveRenderer->getFrameStats().getCurrent(),
+              &visibleObjects};
+          updateGlobalUbo(frameInfo);
+          cullVegetation(frameInfo);
+          renderScene(frameInfo);
+        });
+    std::cout << "batch: rendered " << stats.viewCount << " views in " << stats.seconds << "s ("
+              << stats.imagesPerSecond() << " images/s)" << std::endl;
+
+    lveDevice->waitIdle();
+    logDiagnostics();
+    return;
+  }
 
-void FirstApp::loadSolarLight() {
-  auto orangeLight = LveGameObject::makePointLight(350.2f);
-  orangeLight.color = {1.f, 0.5f, 0.f};
-  // orangeLight.transform.translation = {-2.f, -20.f, -5.f};
-  orangeLight.transform.translation = {-2.f, -30.f, -5.f};  // radio? altura ?
-  // orangeLight.transform.scale = {10.f, 10.f, 10.f};
-  orangeLight.transform.scale = {1.f, 1.f, 1.f};
-  gameObjects.emplace(orangeLight.getId(), std::move(orangeLight));
-}
+  auto viewerObject = LveGameObject::createGameObject();
+  viewerObject.transform.translation.z = -9.5f;
+  viewerObject.transform.translation.y = -2.f;
+  KeyboardMovementController cameraController{};
 
-void FirstApp::loadTreeObjects() {
-  std::shared_ptr<LveModel> lveModel =
-      LveModel::createModelFromFile(lveDevice, "models/park/Tree/3Trees.obj");
-  auto tree = LveGameObject::createGameObject();
-  tree.model = lveModel;
-  tree.transform.scale = {.3f, .3f, .3f};
-  tree.transform.translation = {-8.5f, .5f, 0.f};
-  gameObjects.emplace(tree.getId(), std::move(tree));
+  std::unique_ptr<LveBenchmark> benchmark;
+  if (!config.benchmark.outputFile.empty()) {
+    benchmark = std::make_unique<LveBenchmark>(config.benchmark, lveRenderer->getGpuProfiler());
+  }
 
-  lveModel = LveModel::createModelFromFile(lveDevice, "models/park/Tree01/tree01.obj");
-  auto tree2 = LveGameObject::createGameObject();
-  tree2.model = lveModel;
-  tree2.transform.scale = {.3f, .3f, .3f};
-  tree2.transform.translation = {-8.5f, .5f, 0.f};
-  gameObjects.emplace(tree2.getId(), std::move(tree2));
+  std::ofstream hitchLogFile;
+  std::unique_ptr<LveHitchDetector> hitchDetector;
+  if (config.detectHitches) {
+    if (!config.hitchLogFile.empty()) {
+      hitchLogFile.open(config.hitchLogFile);
+      if (!hitchLogFile.is_open()) {
+        throw std::runtime_error("failed to open hitch log: " + config.hitchLogFile);
+      }
+    }
+    LveHitchDetector::Config hitchConfig{};
+    hitchConfig.thresholdFactor = config.hitchFactor;
+    hitchDetector = std::make_unique<LveHitchDetector>(
+        hitchLogFile.is_open() ? hitchLogFile : std::cout,
+        lveRenderer->getGpuProfiler(),
+        hitchConfig);
+  }
 
+  // what the simulation needs from the main thread, which owns the window
+  struct SimulationInput {
+    uint64_t frameNumber;
+    double frameTime;
+    float aspect;
+    KeyboardMovementController::Input keys;
+  };
 
-   lveModel = LveModel::createModelFromFile(lveDevice, "models/park/oak/oaks.obj");
-  auto oaks = LveGameObject::createGameObject();
-   oaks.model = lveModel;
-  oaks.transform.scale = {.2f, .2f, .2f};
-   oaks.transform.translation = {-1.f, .5f, 8.7f};
-  gameObjects.emplace(oaks.getId(), std::move(oaks));
+  // The scene advances in fixed steps, in benchmark mode exactly one per frame so runs are
+  // repeatable. Frames render between the last two steps, interpolated by the leftover time,
+  // except in benchmark mode where they show the latest step.
+  LveFixedTimestep timestep{benchmark ? 1.0 / config.benchmark.timestep : config.simulationHz};
+  std::vector<std::pair<LveGameObject::id_t, TransformComponent>> previousTransforms;
+  TransformComponent previousViewer = viewerObject.transform;
+
+  // Advances the scene by the frame time and captures the result. Only touches gameObjects,
+  // viewerObject, the timestep state, transformHierarchy and the snapshot, so it can run on a
+  // worker while the previous snapshot renders.
+  auto simulate = [&](const SimulationInput &input, LveRenderSnapshot &snapshot) {
+    LVE_CPU_ZONE("simulate");
+    const uint64_t firstStep = timestep.getStepCount();
+    const int steps = timestep.advance(input.frameTime);
+    const float step = static_cast<float>(timestep.getStep());
+    for (int i = 0; i < steps; i++) {
+      if (i == steps - 1) {
+        previousViewer = viewerObject.transform;
+        previousTransforms.clear();
+        for (auto &kv : gameObjects) {
+          previousTransforms.emplace_back(kv.first, kv.second.transform);
+        }
+      }
+      {
+        LVE_CPU_ZONE("camera");
+        if (benchmark) {
+          auto pose = benchmark->getCameraPose(firstStep + i);
+          viewerObject.transform.translation = pose.position;
+          viewerObject.transform.rotation = pose.rotation;
+        } else {
+          cameraController.moveInPlaneXZ(input.keys, step, viewerObject);
+        }
+      }
+      LVE_CPU_ZONE("PointLightSystem::animateLights");
+      PointLightSystem::animateLights(step, gameObjects);
+    }
 
+    // a benchmark frame forces exactly one step, so it shows that step's result rather than
+    // interpolating back to the state before it
+    const float alpha = benchmark ? 1.f : timestep.getAlpha();
+    snapshot.frameNumber = input.frameNumber;
+    snapshot.frameTime = static_cast<float>(input.frameTime);
+    snapshot.capture(gameObjects);
+    snapshot.interpolate(previousTransforms, alpha);
+    transformHierarchy.update(snapshot.gameObjects, jobSystem.get());
+
+    auto viewer = TransformComponent::interpolate(previousViewer, viewerObject.transform, alpha);
+    snapshot.camera.setViewYXZ(viewer.translation, viewer.rotation);
+    snapshot.camera.setPerspectiveProjection(glm::radians(50.f), input.aspect, 0.1f, 100.f);
+
+    snapshot.ubo = GlobalUbo{};
+    snapshot.ubo.projection = snapshot.camera.getProjection();
+    snapshot.ubo.view = snapshot.camera.getView();
+    snapshot.ubo.inverseView = snapshot.camera.getInverseView();
+    PointLightSystem::writeLights(snapshot.gameObjects, snapshot.ubo);
+  };
 
+  // Frame N renders snapshots[N % 2] while the simulation fills the other one for frame N + 1.
+  // Without pipelining every frame is simulated into snapshots[0] right before it renders.
+  std::array<LveRenderSnapshot, 2> snapshots{};
+  int renderSlot = 0;
+  uint64_t simulatedFrames = 0;
+  if (config.pipelined) {
+    // one step, so the first frame already has the camera path and animation applied
+    simulate(
+        {simulatedFrames++, timestep.getStep(), lveRenderer->getAspectRatio(), {}},
+        snapshots[0]);
+  }
 
-}
+  auto currentTime = std::chrono::high_resolution_clock::now();
+  uint64_t frameNumber = 0;
+  bool traceKeyWasDown = false;
+  while (!shouldClose(frameNumber)) {
+    LVE_CPU_ZONE("frame");
+    if (benchmark) {
+      benchmark->beginFrame();
+    }
+    if (hitchDetector) {
+      hitchDetector->beginFrame(lveRenderer->getFrameNumber());
+    }
+    bool submitted = false;
+
+    SimulationInput input{};
+    if (lveWindow) {
+      LVE_CPU_ZONE("input");
+      glfwPollEvents();
+      input.keys = cameraController.sampleInput(lveWindow->getGLFWwindow());
+
+      // F12 dumps the recorded window without waiting for the app to exit
+      bool traceKeyDown = glfwGetKey(lveWindow->getGLFWwindow(), GLFW_KEY_F12) == GLFW_PRESS;
+      if (traceKeyDown && !traceKeyWasDown && !config.cpuTraceFile.empty()) {
+        writeCpuTrace();
+      }
+      traceKeyWasDown = traceKeyDown;
+    }
 
-void FirstApp::loadBenchObjects() {
-  std::shared_ptr<LveModel> lveModel =
-      LveModel::createModelFromFile(lveDevice, "models/park/bench/bench-1.obj");
-
-  auto tree = LveGameObject::createGameObject();
-  tree.model = lveModel;
-  tree.transform.translation = {
-      -2.f,
-      .5f,
-      4.f};  // x (positivo derecha) / y (positivo-> abajo .5 base) / z profundidad
-  tree.transform.scale = {.5f, .5f, .5f};
-  tree.transform.rotation = {
-      0.f,
-      2.f,
-      0.f};  // x inclinacion arriba abajo / giro sobre si misma / inclinacion hacia los lados
-
-  // tree.transform.rotation = {0.f,0.f,5.f};
-  gameObjects.emplace(tree.getId(), std::move(tree));
-}
+    auto newTime = std::chrono::high_resolution_clock::now();
+    input.frameTime =
+        std::chrono::duration<double, std::chrono::seconds::period>(newTime - currentTime).count();
+    currentTime = newTime;
+    if (benchmark) {
+      input.frameTime = timestep.getStep();
+    }
+    input.aspect = lveRenderer->getAspectRatio();
+    input.frameNumber = simulatedFrames++;
+
+    LveJobCounter simulation;
+    // beginFrame, renderScene and endFrame may throw while the job still writes into input and
+    // snapshots
+    LveJobJoin simulationJoin{*jobSystem, simulation};
+    if (config.pipelined) {
+      jobSystem->run([&] { simulate(input, snapshots[renderSlot ^ 1]); }, simulation);
+    } else {
+      simulate(input, snapshots[renderSlot]);
+    }
+    auto &snapshot = snapshots[renderSlot];
+
+    if (auto commandBuffer = lveRenderer->beginFrame()) {
+      int frameIndex = lveRenderer->getFrameIndex();
+      FrameInfo frameInfo{
+          frameIndex,
+          snapshot.frameTime,
+          commandBuffer,
+          snapshot.camera,
+          globalDescriptorSets[frameIndex],
+          snapshot.gameObjects,
+          lveRenderer->getFrameStats().getCurrent()};
 
-void FirstApp::loadBushObjects() {
-  std::shared_ptr<LveModel> lveModel =
-      LveModel::createModelFromFile(lveDevice, "models/park/bush/bush-1.obj");
+      // update
+      {
+        LVE_CPU_ZONE("ubo write");
+        uboBuffers[frameIndex]->writeToBuffer(&snapshot.ubo);
+        uboBuffers[frameIndex]->flush();
+        frameInfo.stats.recordUpload(sizeof(GlobalUbo));
+      }
+      cullVegetation(frameInfo);
+
+      if (overdrawSystem) {
+        LVE_CPU_ZONE("OverdrawSystem::render");
+        LveGpuZone zone{lveRenderer->getGpuProfiler(), commandBuffer, "OverdrawSystem"};
+        overdrawSystem->render(frameInfo, lveRenderer->getExtent());
+      }
 
-  /*auto bush = LveGameObject::createGameObject();
-  bush.model = lveModel;
-  bush.transform.translation = {-2.f, .13f, 9.7f};
-  bush.transform.scale = {.5f, 1.f, .5f};
-  bush.transform.rotation = {0.f,2.f,0.f};  // x inclinacion arriba abajo / giro sobre si misma /
-  inclinacion hacia los lados gameObjects.emplace(bush.getId(), std::move(bush));*/
-
-  for (int i = -10; i <= 10; i++) {
-    auto bush = LveGameObject::createGameObject();
-    bush.model = lveModel;
-    // bush.transform.translation = {-2.f, .13f, 9.7f};
-    bush.transform.translation = {-10.f, .13f, i * .9f};
-    bush.transform.scale = {.5f, 1.f, .5f};
-    bush.transform.rotation = {0.f, 2.f, 0.f};
-    gameObjects.emplace(bush.getId(), std::move(bush));
-
-    //
-    auto bushL = LveGameObject::createGameObject();
-    bushL.model = lveModel;
-    bushL.transform.translation = {10.f, .2f, i * .9f};
-    bushL.transform.scale = {.5f, 1.f, .5f};
-    bushL.transform.rotation = {0.f, 2.f, 0.f};
-    gameObjects.emplace(bushL.getId(), std::move(bushL));
-    //
-    auto bush3 = LveGameObject::createGameObject();
-    bush3.model = lveModel;
-    bush3.transform.translation = {i * 1.f, .2f, 9.7f};
-    bush3.transform.scale = {.5f, 1.f, .5f};
-    bush3.transform.rotation = {0.f, 0.f, 0.f};
-    gameObjects.emplace(bush3.getId(), std::move(bush3));
-
-    auto bush4 = LveGameObject::createGameObject();
-    bush4.model = lveModel;
-    bush4.transform.translation = {i * 1.f, .2f, -9.7f};
-    bush4.transform.scale = {.5f, 1.f, .5f};
-    bush4.transform.rotation = {0.f, 0.f, 0.f};
-    gameObjects.emplace(bush4.getId(), std::move(bush4));
+      // render
+      lveRenderer->beginSwapChainRenderPass(commandBuffer);
+      renderScene(frameInfo);
+      lveRenderer->endSwapChainRenderPass(commandBuffer);
+      lveRenderer->endFrame();
+      if (benchmark) {
+        benchmark->endFrame(frameNumber, lveRenderer->getFrameStats().getLastFrame());
+      }
+      frameNumber++;
+      submitted = true;
+    }
+
+    if (config.pipelined) {
+      LVE_CPU_ZONE("wait for simulation");
+      jobSystem->wait(simulation);
+      renderSlot ^= 1;
+    }
+    // the simulation joined, so the scene can change until the next one is scheduled
+    streamModels();
+    updateStartupMetrics(frameNumber);
+
+    // an iteration that didn't submit shares the renderer's frame number with the next one, the
+    // next beginFrame starts over instead
+    if (hitchDetector && submitted) {
+      hitchDetector->endFrame();
+    }
+    if (config.gpuProfile) {
+      updateProfilerOverlay(snapshot.frameTime);
+    }
   }
-}
 
-void FirstApp::loadPlantObjects() {
-  /*std::shared_ptr<LveModel> lveModel =
-      LveModel::createModelFromFile(lveDevice, "models/park/plant/plant-1.obj");
-  auto plant = LveGameObject::createGameObject();
-  plant.model = lveModel;
-  plant.transform.translation = {-2.f,.5f,4.f};
-  plant.transform.scale = {.5f, .5f, .5f};
-  plant.transform.rotation = {0.f,2.f,3.1f};
-  gameObjects.emplace(plant.getId(), std::move(plant));*/
-  std::srand(std::time(nullptr));  // use current time as seed for random generator
-
-  std::shared_ptr<LveModel> lveModel =
-      LveModel::createModelFromFile(lveDevice, "models/park/plant/plant-1.obj");
-
-  int numPlants = 8 + std::rand() % 8;  // Random number between 8 and 15
-
-  for (int i = 0; i < numPlants; ++i) {
-    auto plant = LveGameObject::createGameObject();
-    plant.model = lveModel;
-
-    // Generate random position within the plane
-    float x = -10.f + static_cast<float>(rand()) / (static_cast<float>(RAND_MAX / (20.f)));
-    float y = .5f;
-    float z = -10.f + static_cast<float>(rand()) / (static_cast<float>(RAND_MAX / (20.f)));
-    // Generate random scale
-    float scale = 0.3f + static_cast<float>(rand()) / (static_cast<float>(RAND_MAX / (0.7f)));
-
-    plant.transform.translation = {x, y, z};
-    //plant.transform.scale = {.5f, .5f, .5f};
-    plant.transform.scale = {scale, scale, scale};
-    plant.transform.rotation = {0.f, 2.f, 3.1f};
-    gameObjects.emplace(plant.getId(), std::move(plant));
+  lveDevice->waitIdle();
+  if (hitchDetector) {
+    std::cout << "detected " << hitchDetector->getHitchCount() << " hitches" << std::endl;
+    hitchDetector.reset();
+  }
+  if (benchmark) {
+    benchmark->finish(lveDevice->properties.deviceName, lveRenderer->getExtent());
   }
+  logDiagnostics();
 }
 
 }  // namespace lve
@@ -1,22 +1,85 @@
 #pragma once
 
+#include "lve_asset_streamer.hpp"
+#include "lve_benchmark.hpp"
 #include "lve_descriptors.hpp"
 #include "lve_device.hpp"
 #include "lve_game_object.hpp"
+#include "lve_job_system.hpp"
+#include "lve_model.hpp"
 #include "lve_renderer.hpp"
+#include "lve_transform_hierarchy.hpp"
 #include "lve_window.hpp"
 
 // std
+#include <chrono>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace lve {
+
+class VegetationSystem;
+
+struct AppConfig {
+  // render into an offscreen target without creating a window or surface
+  bool headless = false;
+  // number of frames to render before run() returns, 0 runs until the window is closed
+  uint32_t frameCount = 0;
+  // when set, every rendered frame is written to this directory
+  std::string captureDirectory{};
+  LveImageWriter::Format captureFormat = LveImageWriter::Format::Png;
+  // when set, renders every camera pose listed in this file once instead of the interactive loop
+  std::string batchPosesFile{};
+  // time render systems with GPU timestamps, shown in the window title and logged on exit
+  bool gpuProfile = false;
+  // print per frame workload counters (draws, triangles, binds, uploads, ...) on exit
+  bool frameStats = false;
+  // count vertex, clipping and fragment invocations of every render system, printed on exit
+  bool pipelineStatistics = false;
+  // redraw the scene into an additive fragment counting target and print its histogram on exit,
+  // the last frame is written as a heat map when overdrawImageFile is set
+  bool overdraw = false;
+  std::string overdrawImageFile{};
+  // when set, CPU zones are recorded and the last cpuTraceSeconds are written here as a Chrome
+  // trace on exit or when F12 is pressed
+  std::string cpuTraceFile{};
+  double cpuTraceSeconds = 10.0;
+  // log frames slower than hitchFactor times the rolling median, with the CPU zones, GPU passes
+  // and engine events of that frame; goes to stdout unless hitchLogFile is set
+  bool detectHitches = false;
+  double hitchFactor = 3.0;
+  std::string hitchLogFile{};
+  // background threads of the job system, 0 runs jobs on the main thread only
+  unsigned workerCount = LveJobSystem::defaultWorkerCount();
+  // print jobs executed, stolen and idle time per thread on exit
+  bool jobStats = false;
+  // simulate frame N + 1 on the job system while frame N is recorded and submitted, which adds a
+  // frame of input latency
+  bool pipelined = true;
+  // rate of the fixed simulation step, rendering interpolates between the last two steps
+  double simulationHz = 60.0;
+  // text or binary scene description, see LveScene
+  std::string sceneFile = "scenes/park.scene";
+  // main thread time per frame spent creating models from finished background loads
+  double streamingBudgetMs = 2.0;
+  // plants scattered, culled and drawn on the GPU over the ground, 0 disables them. The density
+  // map is an 8 bit PGM over the ground, planting everywhere when empty.
+  uint32_t vegetationCount = 100000;
+  uint32_t vegetationSeed = 1;
+  std::string vegetationDensityMap{};
+  // scripted, fixed timestep run that reports frame time statistics, see LveBenchmarkConfig
+  LveBenchmarkConfig benchmark{};
+};
+
 class FirstApp {
  public:
   static constexpr int WIDTH = 1366;
   static constexpr int HEIGHT = 768;
+  static constexpr uint32_t DEFAULT_HEADLESS_FRAMES = 300;
 
-  FirstApp();
+  FirstApp(const AppConfig &config = AppConfig{});
   ~FirstApp();
 
   FirstApp(const FirstApp &) = delete;
@@ -25,19 +88,41 @@ class FirstApp {
   void run();
 
  private:
-  void loadGameObjects();
-  void loadTreeObjects();
-  void loadSolarLight();
-  void loadBenchObjects();
-  void loadBushObjects();
-  void loadPlantObjects();
+  // creates the objects and lights of config.sceneFile, its models stream in afterwards
+  void loadScene();
+  // Gives object the model of filepath, right away when it's loaded, else once it streamed in.
+  // Until then the object is in the scene without being drawn.
+  void setModel(LveGameObject &object, const std::string &filepath);
+  // hands models whose background load finished to the scene, within the streaming budget
+  void streamModels();
+  void onModelLoaded(const std::string &filepath, std::unique_ptr<LveModel> model);
+  // logs time to first frame and to a fully loaded scene once each is reached
+  void updateStartupMetrics(uint64_t frameNumber);
+  bool shouldClose(uint64_t frameNumber) const;
+  void updateProfilerOverlay(float frameTime);
+  void writeCpuTrace() const;
 
-  LveWindow lveWindow{WIDTH, HEIGHT, "GitGud Advanced Grapichs Final Project"};
-  LveDevice lveDevice{lveWindow};
-  LveRenderer lveRenderer{lveWindow, lveDevice};
+  AppConfig config;
+  std::unique_ptr<LveJobSystem> jobSystem;
+  std::unique_ptr<LveWindow> lveWindow;
+  std::unique_ptr<LveDevice> lveDevice;
+  std::unique_ptr<LveRenderer> lveRenderer;
+  std::unique_ptr<LveAssetStreamer> assetStreamer;
+  float overlayTimer = 0.f;
 
   // note: order of declarations matters
   std::unique_ptr<LveDescriptorPool> globalPool{};
   LveGameObject::Map gameObjects;
+  // parent links between gameObjects, resolves the world matrices the render systems read
+  LveTransformHierarchy transformHierarchy;
+  std::unordered_map<std::string, std::shared_ptr<LveModel>> models;
+  // objects waiting for a model that is still streaming, by model filepath
+  std::unordered_map<std::string, std::vector<LveGameObject::id_t>> modelUsers;
+  // created by run(), gets its models from onModelLoaded
+  std::unique_ptr<VegetationSystem> vegetationSystem;
+
+  std::chrono::high_resolution_clock::time_point startTime;
+  double firstFrameMs = -1.0;
+  double fullyLoadedMs = -1.0;
 };
 }  // namespace lve
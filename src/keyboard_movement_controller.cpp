@@ -5,14 +5,26 @@
 
 namespace lve {
 
-void KeyboardMovementController::moveInPlaneXZ(
-    GLFWwindow* window, float dt, LveGameObject& gameObject) {
-  glm::vec3 rotate{0};
-  if (glfwGetKey(window, keys.lookRight) == GLFW_PRESS) rotate.y += 1.f;
-  if (glfwGetKey(window, keys.lookLeft) == GLFW_PRESS) rotate.y -= 1.f;
-  if (glfwGetKey(window, keys.lookUp) == GLFW_PRESS) rotate.x += 1.f;
-  if (glfwGetKey(window, keys.lookDown) == GLFW_PRESS) rotate.x -= 1.f;
+KeyboardMovementController::Input KeyboardMovementController::sampleInput(
+    GLFWwindow* window) const {
+  Input input{};
+  if (glfwGetKey(window, keys.lookRight) == GLFW_PRESS) input.look.y += 1.f;
+  if (glfwGetKey(window, keys.lookLeft) == GLFW_PRESS) input.look.y -= 1.f;
+  if (glfwGetKey(window, keys.lookUp) == GLFW_PRESS) input.look.x += 1.f;
+  if (glfwGetKey(window, keys.lookDown) == GLFW_PRESS) input.look.x -= 1.f;
+
+  if (glfwGetKey(window, keys.moveForward) == GLFW_PRESS) input.move.z += 1.f;
+  if (glfwGetKey(window, keys.moveBackward) == GLFW_PRESS) input.move.z -= 1.f;
+  if (glfwGetKey(window, keys.moveRight) == GLFW_PRESS) input.move.x += 1.f;
+  if (glfwGetKey(window, keys.moveLeft) == GLFW_PRESS) input.move.x -= 1.f;
+  if (glfwGetKey(window, keys.moveUp) == GLFW_PRESS) input.move.y += 1.f;
+  if (glfwGetKey(window, keys.moveDown) == GLFW_PRESS) input.move.y -= 1.f;
+  return input;
+}
 
+void KeyboardMovementController::moveInPlaneXZ(
+    const Input& input, float dt, LveGameObject& gameObject) const {
+  glm::vec3 rotate{input.look.x, input.look.y, 0.f};
   if (glm::dot(rotate, rotate) > std::numeric_limits<float>::epsilon()) {
     gameObject.transform.rotation += lookSpeed * dt * glm::normalize(rotate);
   }
@@ -26,16 +38,14 @@ void KeyboardMovementController::moveInPlaneXZ(
   const glm::vec3 rightDir{forwardDir.z, 0.f, -forwardDir.x};
   const glm::vec3 upDir{0.f, -1.f, 0.f};
 
-  glm::vec3 moveDir{0.f};
-  if (glfwGetKey(window, keys.moveForward) == GLFW_PRESS) moveDir += forwardDir;
-  if (glfwGetKey(window, keys.moveBackward) == GLFW_PRESS) moveDir -= forwardDir;
-  if (glfwGetKey(window, keys.moveRight) == GLFW_PRESS) moveDir += rightDir;
-  if (glfwGetKey(window, keys.moveLeft) == GLFW_PRESS) moveDir -= rightDir;
-  if (glfwGetKey(window, keys.moveUp) == GLFW_PRESS) moveDir += upDir;
-  if (glfwGetKey(window, keys.moveDown) == GLFW_PRESS) moveDir -= upDir;
-
+  glm::vec3 moveDir = input.move.z * forwardDir + input.move.x * rightDir + input.move.y * upDir;
   if (glm::dot(moveDir, moveDir) > std::numeric_limits<float>::epsilon()) {
     gameObject.transform.translation += moveSpeed * dt * glm::normalize(moveDir);
   }
 }
+
+void KeyboardMovementController::moveInPlaneXZ(
+    GLFWwindow* window, float dt, LveGameObject& gameObject) {
+  moveInPlaneXZ(sampleInput(window), dt, gameObject);
+}
 }  // namespace lve
\ No newline at end of file
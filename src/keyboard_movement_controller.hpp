@@ -19,6 +19,15 @@ class KeyboardMovementController {
     int lookDown = GLFW_KEY_DOWN;
   };
 
+  // key state of one frame; GLFW may only be queried on the main thread, the movement itself can
+  // then run anywhere
+  struct Input {
+    glm::vec2 look{0.f};  // x pitch, y yaw
+    glm::vec3 move{0.f};  // x right, y up, z forward
+  };
+
+  Input sampleInput(GLFWwindow* window) const;
+  void moveInPlaneXZ(const Input& input, float dt, LveGameObject& gameObject) const;
   void moveInPlaneXZ(GLFWwindow* window, float dt, LveGameObject& gameObject);
 
   KeyMappings keys{};
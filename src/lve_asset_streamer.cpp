@@ -0,0 +1,76 @@
+#include "lve_asset_streamer.hpp"
+
+#include "lve_cpu_profiler.hpp"
+#include "lve_engine_events.hpp"
+
+// std
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+
+#ifndef ENGINE_DIR
+#define ENGINE_DIR "../"
+#endif
+
+namespace lve {
+
+LveAssetStreamer::LveAssetStreamer(LveDevice &device, LveJobSystem &jobSystem)
+    : lveDevice{device}, jobSystem{jobSystem} {}
+
+LveAssetStreamer::~LveAssetStreamer() { jobSystem.wait(loads); }
+
+void LveAssetStreamer::requestModel(const std::string &filepath) {
+  pendingCount.fetch_add(1, std::memory_order_acq_rel);
+  if (jobSystem.getWorkerCount() == 0) {
+    // background jobs need a worker
+    load(filepath);
+    return;
+  }
+  // background, so the render thread never ends up parsing a model while it waits on frame jobs
+  jobSystem.runBackground([this, filepath] { load(filepath); }, loads);
+}
+
+void LveAssetStreamer::load(const std::string &filepath) {
+  LveEngineEventScope event{"asset load", filepath};
+  LoadedModel model{filepath};
+  try {
+    model.builder.loadModel(ENGINE_DIR + filepath);
+  } catch (const std::exception &e) {
+    model.error = e.what();
+  }
+  loaded.push(std::move(model));
+}
+
+size_t LveAssetStreamer::drain(double budgetSeconds, const ModelCallback &onModel) {
+  LVE_CPU_ZONE("LveAssetStreamer::drain");
+  auto start = std::chrono::high_resolution_clock::now();
+  size_t created = 0;
+  LoadedModel model;
+  while (loaded.pop(model)) {
+    pendingCount.fetch_sub(1, std::memory_order_acq_rel);
+    if (!model.error.empty()) {
+      throw std::runtime_error("failed to load model " + model.filepath + ": " + model.error);
+    }
+    {
+      LveEngineEventScope event{"asset upload", model.filepath};
+      onModel(model.filepath, std::make_unique<LveModel>(lveDevice, model.builder));
+    }
+    created++;
+
+    auto elapsed = std::chrono::high_resolution_clock::now() - start;
+    if (std::chrono::duration<double, std::chrono::seconds::period>(elapsed).count() >=
+        budgetSeconds) {
+      break;
+    }
+  }
+  return created;
+}
+
+void LveAssetStreamer::drainAll(const ModelCallback &onModel) {
+  jobSystem.wait(loads);
+  while (!isIdle()) {
+    drain(std::numeric_limits<double>::infinity(), onModel);
+  }
+}
+
+}  // namespace lve
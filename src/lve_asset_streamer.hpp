@@ -0,0 +1,62 @@
+#pragma once
+
+#include "lve_device.hpp"
+#include "lve_job_system.hpp"
+#include "lve_model.hpp"
+#include "lve_mpsc_queue.hpp"
+
+// std
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace lve {
+
+// Parses model files on the job system and hands the results to the render thread through a lock
+// free queue. The render thread drains it once per frame under a time budget, so a burst of
+// finished loads turns into GPU uploads over several frames instead of one long frame.
+class LveAssetStreamer {
+ public:
+  using ModelCallback =
+      std::function<void(const std::string &filepath, std::unique_ptr<LveModel> model)>;
+
+  LveAssetStreamer(LveDevice &device, LveJobSystem &jobSystem);
+  // waits for the loads still running, their results are dropped
+  ~LveAssetStreamer();
+
+  LveAssetStreamer(const LveAssetStreamer &) = delete;
+  LveAssetStreamer &operator=(const LveAssetStreamer &) = delete;
+
+  // Schedules filepath to be parsed in the background. Without workers it is parsed right away.
+  void requestModel(const std::string &filepath);
+
+  // Render thread only. Creates models from finished loads (which submits their uploads) and
+  // passes them to onModel until budgetSeconds passed, at least one per call so streaming always
+  // progresses. Returns how many models were created. Throws when a file failed to load.
+  size_t drain(double budgetSeconds, const ModelCallback &onModel);
+  // Blocks until every requested model was loaded and passed to onModel
+  void drainAll(const ModelCallback &onModel);
+
+  // requested models that haven't been handed to a drain callback yet
+  uint32_t getPendingCount() const { return pendingCount.load(std::memory_order_acquire); }
+  bool isIdle() const { return getPendingCount() == 0; }
+
+ private:
+  struct LoadedModel {
+    std::string filepath;
+    LveModel::Builder builder;
+    // set instead of builder when parsing failed, job system jobs must not throw
+    std::string error;
+  };
+
+  void load(const std::string &filepath);
+
+  LveDevice &lveDevice;
+  LveJobSystem &jobSystem;
+  LveJobCounter loads;
+  LveMpscQueue<LoadedModel> loaded;
+  std::atomic<uint32_t> pendingCount{0};
+};
+
+}  // namespace lve
@@ -0,0 +1,67 @@
+#include "lve_batch_renderer.hpp"
+
+#include "lve_camera_path.hpp"
+
+// std
+#include <algorithm>
+#include <chrono>
+
+namespace lve {
+
+LveBatchRenderer::LveBatchRenderer(
+    LveRenderer &renderer, LveGameObject::Map &gameObjects, LveJobSystem &jobSystem)
+    : lveRenderer{renderer}, gameObjects{gameObjects}, jobSystem{jobSystem} {}
+
+std::vector<LveCamera> LveBatchRenderer::loadPoses(
+    const std::string &filepath, float fovy, float aspect, float near, float far) {
+  std::vector<LveCamera> cameras;
+  for (const auto &pose : loadCameraPoses(filepath)) {
+    LveCamera camera{};
+    camera.setViewYXZ(pose.position, pose.rotation);
+    camera.setPerspectiveProjection(fovy, aspect, near, far);
+    cameras.push_back(camera);
+  }
+  return cameras;
+}
+
+LveBatchRenderer::Stats LveBatchRenderer::render(
+    std::vector<LveCamera> &views, const RecordViewFn &recordView) {
+  auto startTime = std::chrono::high_resolution_clock::now();
+  sceneIndex.build(gameObjects, &jobSystem);
+  const size_t candidates = sceneIndex.getItemCount();
+
+  for (size_t chunkStart = 0; chunkStart < views.size(); chunkStart += CULL_CHUNK_SIZE) {
+    size_t chunkEnd = std::min(views.size(), chunkStart + CULL_CHUNK_SIZE);
+
+    frustums.clear();
+    for (size_t i = chunkStart; i < chunkEnd; i++) {
+      frustums.push_back(LveFrustum::fromCamera(views[i]));
+    }
+    sceneIndex.queryFrustums(frustums, visibleObjects);
+
+    for (size_t i = chunkStart; i < chunkEnd; i++) {
+      VkCommandBuffer commandBuffer = nullptr;
+      // beginFrame returns nullptr while the swapchain is being recreated, retry the same view
+      while ((commandBuffer = lveRenderer.beginFrame()) == nullptr) {
+      }
+
+      const auto &visible = visibleObjects[i - chunkStart];
+      lveRenderer.getFrameStats().getCurrent().culledObjects +=
+          static_cast<uint32_t>(candidates - visible.size());
+
+      lveRenderer.beginSwapChainRenderPass(commandBuffer);
+      recordView(commandBuffer, lveRenderer.getFrameIndex(), views[i], visible);
+      lveRenderer.endSwapChainRenderPass(commandBuffer);
+      lveRenderer.endFrame();
+    }
+  }
+
+  Stats stats{};
+  stats.viewCount = views.size();
+  stats.seconds = std::chrono::duration<double>(
+                      std::chrono::high_resolution_clock::now() - startTime)
+                      .count();
+  return stats;
+}
+
+}  // namespace lve
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "lve_camera.hpp"
+#include "lve_frustum.hpp"
+#include "lve_game_object.hpp"
+#include "lve_job_system.hpp"
+#include "lve_renderer.hpp"
+#include "lve_scene_index.hpp"
+
+// std
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace lve {
+
+// Renders a list of camera poses back to back through an LveRenderer, typically headless with
+// readback enabled, to generate image datasets without running the interactive loop per pose.
+class LveBatchRenderer {
+ public:
+  // Number of views culled together in a single pass over the scene
+  static constexpr size_t CULL_CHUNK_SIZE = 256;
+
+  // Records one view into the renderer's current render pass
+  using RecordViewFn = std::function<void(
+      VkCommandBuffer commandBuffer,
+      int frameIndex,
+      LveCamera &camera,
+      const std::vector<LveGameObject::id_t> &visibleObjects)>;
+
+  struct Stats {
+    size_t viewCount = 0;
+    double seconds = 0.0;
+    double imagesPerSecond() const { return seconds > 0.0 ? viewCount / seconds : 0.0; }
+  };
+
+  LveBatchRenderer(
+      LveRenderer &renderer, LveGameObject::Map &gameObjects, LveJobSystem &jobSystem);
+
+  LveBatchRenderer(const LveBatchRenderer &) = delete;
+  LveBatchRenderer &operator=(const LveBatchRenderer &) = delete;
+
+  // Builds a camera for every pose in the file, see loadCameraPoses for the format
+  static std::vector<LveCamera> loadPoses(
+      const std::string &filepath, float fovy, float aspect, float near, float far);
+
+  Stats render(std::vector<LveCamera> &views, const RecordViewFn &recordView);
+
+ private:
+  LveRenderer &lveRenderer;
+  LveGameObject::Map &gameObjects;
+  LveJobSystem &jobSystem;
+
+  // built at the start of render, the scene doesn't change while views are rendered
+  LveSceneIndex sceneIndex;
+  std::vector<LveFrustum> frustums;
+  std::vector<std::vector<LveGameObject::id_t>> visibleObjects;
+};
+
+}  // namespace lve
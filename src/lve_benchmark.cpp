@@ -0,0 +1,130 @@
+#include "lve_benchmark.hpp"
+
+// std
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace lve {
+
+namespace {
+
+LveCameraPath createCameraPath(const LveBenchmarkConfig &config) {
+  if (!config.cameraPathFile.empty()) {
+    return LveCameraPath::loadFromFile(config.cameraPathFile, config.secondsPerKey);
+  }
+  // matches the interactive starting view, circling the park once every 20 seconds
+  return LveCameraPath::orbit({0.f, 0.f, 0.f}, 9.5f, -2.f, 20.f);
+}
+
+// JSON string contents, device names are free text
+std::string escapeJson(const std::string &text) {
+  std::string escaped;
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+    }
+    escaped += c;
+  }
+  return escaped;
+}
+
+void writeSummary(std::ofstream &out, const LveRollingStats::Summary &summary) {
+  char text[256];
+  std::snprintf(
+      text,
+      sizeof(text),
+      "{\"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f}",
+      summary.mean,
+      summary.p50,
+      summary.p95,
+      summary.p99,
+      summary.max);
+  out << text;
+}
+
+}  // namespace
+
+LveBenchmark::LveBenchmark(const LveBenchmarkConfig &config, LveGpuProfiler &gpuProfiler)
+    : config{config},
+      gpuProfiler{gpuProfiler},
+      cameraPath{createCameraPath(config)},
+      cpuFrameMs{config.measuredFrames},
+      workload{config.measuredFrames} {
+  if (config.measuredFrames == 0) {
+    throw std::runtime_error("benchmark needs at least one measured frame!");
+  }
+  gpuProfiler.setEnabled(true);
+  if (config.warmupFrames == 0) {
+    gpuProfiler.resetStats(config.measuredFrames);
+  }
+}
+
+LveCameraPose LveBenchmark::getCameraPose(uint64_t frameNumber) const {
+  return cameraPath.sample(static_cast<float>(frameNumber) * config.timestep);
+}
+
+void LveBenchmark::beginFrame() { frameStart = std::chrono::steady_clock::now(); }
+
+void LveBenchmark::endFrame(uint64_t frameNumber, const LveFrameCounters &counters) {
+  auto frameEnd = std::chrono::steady_clock::now();
+  if (frameNumber + 1 == config.warmupFrames) {
+    // warm-up frames still in flight are dropped along with everything recorded so far
+    gpuProfiler.resetStats(config.measuredFrames);
+    return;
+  }
+  if (!isMeasuring(frameNumber)) {
+    return;
+  }
+
+  cpuFrameMs.add(std::chrono::duration<double, std::milli>(frameEnd - frameStart).count());
+  workload.beginFrame();
+  workload.getCurrent() = counters;
+  workload.endFrame();
+}
+
+void LveBenchmark::finish(const std::string &deviceName, VkExtent2D extent) {
+  gpuProfiler.collectAll();
+
+  std::ofstream out{config.outputFile};
+  if (!out.is_open()) {
+    throw std::runtime_error("failed to open benchmark output: " + config.outputFile);
+  }
+
+  out << "{\n";
+  out << "  \"device\": \"" << escapeJson(deviceName) << "\",\n";
+  out << "  \"extent\": [" << extent.width << ", " << extent.height << "],\n";
+  out << "  \"warmupFrames\": " << config.warmupFrames << ",\n";
+  out << "  \"measuredFrames\": " << cpuFrameMs.count() << ",\n";
+  out << "  \"timestep\": " << config.timestep << ",\n";
+  out << "  \"cpuFrameMs\": ";
+  writeSummary(out, cpuFrameMs.summarize());
+  out << ",\n  \"gpuFrameMs\": ";
+  if (auto gpuFrame = gpuProfiler.findZone("frame")) {
+    writeSummary(out, gpuFrame->summarize());
+  } else {
+    out << "null";
+  }
+  out << ",\n  \"gpuPassMs\": {";
+  bool first = true;
+  for (const auto &zone : gpuProfiler.getReport()) {
+    if (zone.depth == 0) continue;
+    out << (first ? "\n" : ",\n") << "    \"" << zone.path << "\": ";
+    writeSummary(out, zone.milliseconds);
+    first = false;
+  }
+  out << (first ? "" : "\n  ") << "},\n";
+  out << "  \"workload\": {";
+  for (size_t i = 0; i < LveFrameCounters::COUNT; i++) {
+    out << (i == 0 ? "\n" : ",\n") << "    \"" << LveFrameCounters::name(i) << "\": ";
+    writeSummary(out, workload.getHistory(i).summarize());
+  }
+  out << "\n  }\n}\n";
+
+  auto cpu = cpuFrameMs.summarize();
+  std::cout << "benchmark: " << cpu.count << " frames, cpu frame mean " << cpu.mean << "ms, p99 "
+            << cpu.p99 << "ms, results written to " << config.outputFile << std::endl;
+}
+
+}  // namespace lve
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "lve_camera_path.hpp"
+#include "lve_frame_stats.hpp"
+#include "lve_gpu_profiler.hpp"
+#include "lve_stats.hpp"
+
+// vulkan headers
+#include <vulkan/vulkan.h>
+
+// std
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace lve {
+
+struct LveBenchmarkConfig {
+  // benchmark mode is active when set, results are written here as JSON
+  std::string outputFile{};
+  uint32_t warmupFrames = 60;
+  uint32_t measuredFrames = 600;
+  // simulation time step, independent of how long frames actually take
+  float timestep = 1.f / 60.f;
+  // camera keys as "px py pz rx ry rz" lines, empty flies an orbit around the scene
+  std::string cameraPathFile{};
+  float secondsPerKey = 2.f;
+};
+
+// Drives a deterministic run: the camera follows a scripted path, simulation advances by a fixed
+// step, and CPU/GPU frame times plus workload counts are collected once warm-up is over.
+class LveBenchmark {
+ public:
+  LveBenchmark(const LveBenchmarkConfig &config, LveGpuProfiler &gpuProfiler);
+
+  LveBenchmark(const LveBenchmark &) = delete;
+  LveBenchmark &operator=(const LveBenchmark &) = delete;
+
+  uint32_t getTotalFrames() const { return config.warmupFrames + config.measuredFrames; }
+  float getTimestep() const { return config.timestep; }
+  bool isMeasuring(uint64_t frameNumber) const { return frameNumber >= config.warmupFrames; }
+  LveCameraPose getCameraPose(uint64_t frameNumber) const;
+
+  // Brackets one frame of the loop, frame time is the wall time between the two calls
+  void beginFrame();
+  void endFrame(uint64_t frameNumber, const LveFrameCounters &counters);
+
+  // Collects outstanding GPU timings and writes the report, the device must be idle
+  void finish(const std::string &deviceName, VkExtent2D extent);
+
+ private:
+  LveBenchmarkConfig config;
+  LveGpuProfiler &gpuProfiler;
+  LveCameraPath cameraPath;
+
+  std::chrono::steady_clock::time_point frameStart{};
+  LveRollingStats cpuFrameMs;
+  // measured frames only, unlike the renderer's own windows which also see warm-up
+  LveFrameStats workload;
+};
+
+}  // namespace lve
@@ -35,7 +35,8 @@ LveBuffer::LveBuffer(
     uint32_t instanceCount,
     VkBufferUsageFlags usageFlags,
     VkMemoryPropertyFlags memoryPropertyFlags,
-    VkDeviceSize minOffsetAlignment)
+    VkDeviceSize minOffsetAlignment,
+    bool sharedWithCompute)
     : lveDevice{device},
       instanceSize{instanceSize},
       instanceCount{instanceCount},
@@ -43,13 +44,22 @@ LveBuffer::LveBuffer(
       memoryPropertyFlags{memoryPropertyFlags} {
   alignmentSize = getAlignment(instanceSize, minOffsetAlignment);
   bufferSize = alignmentSize * instanceCount;
-  device.createBuffer(bufferSize, usageFlags, memoryPropertyFlags, buffer, memory);
+  device.createBuffer(
+      bufferSize,
+      usageFlags,
+      memoryPropertyFlags,
+      buffer,
+      memory,
+      sharedWithCompute);
 }
 
 LveBuffer::~LveBuffer() {
   unmap();
-  vkDestroyBuffer(lveDevice.device(), buffer, nullptr);
-  vkFreeMemory(lveDevice.device(), memory, nullptr);
+  lveDevice.getDeletionQueue().push(
+      [device = lveDevice.device(), buffer = buffer, memory = memory] {
+        vkDestroyBuffer(device, buffer, nullptr);
+        vkFreeMemory(device, memory, nullptr);
+      });
 }
 
 /**
@@ -12,7 +12,8 @@ class LveBuffer {
       uint32_t instanceCount,
       VkBufferUsageFlags usageFlags,
       VkMemoryPropertyFlags memoryPropertyFlags,
-      VkDeviceSize minOffsetAlignment = 1);
+      VkDeviceSize minOffsetAlignment = 1,
+      bool sharedWithCompute = false);
   ~LveBuffer();
 
   LveBuffer(const LveBuffer&) = delete;
@@ -0,0 +1,428 @@
+#include "lve_bvh.hpp"
+
+#include "lve_cpu_profiler.hpp"
+
+// std
+#include <algorithm>
+#include <array>
+#include <utility>
+
+namespace lve {
+
+namespace {
+
+// relative cost of visiting an interior node versus testing one item, for the SAH
+constexpr float TRAVERSAL_COST = 1.f;
+
+}  // namespace
+
+LveAabb computeWorldAabb(LveGameObject &gameObject) {
+  LveAabb box{};
+  if (gameObject.model == nullptr) {
+    box.grow(gameObject.getWorldPosition());
+    return box;
+  }
+
+  // box around the transformed model space box: every world axis gets the extent of each local
+  // axis projected onto it
+  const glm::mat4 &transform = gameObject.worldMatrix;
+  const glm::vec3 &boundsMin = gameObject.model->getBoundsMin();
+  const glm::vec3 &boundsMax = gameObject.model->getBoundsMax();
+  glm::vec3 localCenter = .5f * (boundsMin + boundsMax);
+  glm::vec3 localExtent = .5f * (boundsMax - boundsMin);
+  glm::vec3 center{transform * glm::vec4{localCenter, 1.f}};
+  glm::vec3 extent = glm::abs(glm::vec3{transform[0]}) * localExtent.x +
+                     glm::abs(glm::vec3{transform[1]}) * localExtent.y +
+                     glm::abs(glm::vec3{transform[2]}) * localExtent.z;
+  box.min = center - extent;
+  box.max = center + extent;
+  return box;
+}
+
+// *************** Build *********************
+
+void LveBvh::build(LveGameObject::Map &gameObjects, LveJobSystem *jobSystem) {
+  std::vector<Item> newItems;
+  newItems.reserve(gameObjects.size());
+  for (auto &kv : gameObjects) {
+    if (kv.second.model == nullptr) continue;
+    newItems.push_back({computeWorldAabb(kv.second), kv.first, kv.second.isStatic});
+  }
+  build(std::move(newItems), jobSystem);
+}
+
+void LveBvh::build(std::vector<Item> newItems, LveJobSystem *jobSystem) {
+  LVE_CPU_ZONE("LveBvh::build");
+  items = std::move(newItems);
+  nodes.clear();
+  if (!items.empty()) {
+    nodes = buildSubtree(0, static_cast<uint32_t>(items.size()), jobSystem);
+  }
+
+  itemIndices.clear();
+  itemIndices.reserve(items.size());
+  for (uint32_t i = 0; i < items.size(); i++) {
+    itemIndices[items[i].id] = i;
+  }
+  builtCost = computeCost();
+}
+
+std::vector<LveBvh::Node> LveBvh::buildSubtree(
+    uint32_t first, uint32_t count, LveJobSystem *jobSystem) {
+  std::vector<Node> subtree;
+  if (jobSystem == nullptr || count < PARALLEL_BUILD_THRESHOLD) {
+    subtree.reserve(2 * count / MIN_LEAF_SIZE);
+    buildNode(subtree, first, count);
+    return subtree;
+  }
+
+  // large enough to be always split, each child is built into its own array and appended
+  LveAabb bounds;
+  uint32_t leftCount = splitItems(first, count, bounds);
+  std::vector<Node> left, right;
+  LveJobCounter leftBuilt;
+  jobSystem->run([&] { left = buildSubtree(first, leftCount, jobSystem); }, leftBuilt);
+  right = buildSubtree(first + leftCount, count - leftCount, jobSystem);
+  jobSystem->wait(leftBuilt);
+
+  const uint32_t rightIndex = static_cast<uint32_t>(1 + left.size());
+  subtree.reserve(1 + left.size() + right.size());
+  subtree.push_back({bounds.min, rightIndex, bounds.max, 0});
+  for (auto [child, offset] : {std::make_pair(&left, 1u), std::make_pair(&right, rightIndex)}) {
+    for (Node node : *child) {
+      if (!node.isLeaf()) {
+        node.rightOrFirst += offset;
+      }
+      subtree.push_back(node);
+    }
+  }
+  return subtree;
+}
+
+void LveBvh::buildNode(std::vector<Node> &subtree, uint32_t first, uint32_t count) {
+  const auto index = static_cast<uint32_t>(subtree.size());
+  LveAabb bounds;
+  uint32_t leftCount = splitItems(first, count, bounds);
+  subtree.push_back({bounds.min, first, bounds.max, count});
+  if (leftCount == 0) {
+    return;
+  }
+
+  subtree[index].count = 0;
+  buildNode(subtree, first, leftCount);
+  subtree[index].rightOrFirst = static_cast<uint32_t>(subtree.size());
+  buildNode(subtree, first + leftCount, count - leftCount);
+}
+
+uint32_t LveBvh::splitItems(uint32_t first, uint32_t count, LveAabb &bounds) {
+  const auto begin = items.begin() + first;
+  const auto end = begin + count;
+  bounds = LveAabb{};
+  LveAabb centroids{};
+  for (auto it = begin; it != end; ++it) {
+    bounds.grow(it->bounds);
+    centroids.grow(it->bounds.center());
+  }
+  if (count <= MIN_LEAF_SIZE) {
+    return 0;
+  }
+
+  struct Bin {
+    LveAabb bounds{};
+    uint32_t count = 0;
+  };
+  float bestCost = std::numeric_limits<float>::max();
+  int bestAxis = -1;
+  uint32_t bestBin = 0;
+  const glm::vec3 extent = centroids.max - centroids.min;
+  for (int axis = 0; axis < 3; axis++) {
+    if (extent[axis] <= 0.f) continue;
+
+    std::array<Bin, BIN_COUNT> bins{};
+    const float scale = BIN_COUNT / extent[axis];
+    for (auto it = begin; it != end; ++it) {
+      auto bin = static_cast<uint32_t>((it->bounds.center()[axis] - centroids.min[axis]) * scale);
+      bin = std::min(bin, BIN_COUNT - 1);
+      bins[bin].count++;
+      bins[bin].bounds.grow(it->bounds);
+    }
+
+    // sweep the planes between bins, right sides accumulated first
+    std::array<float, BIN_COUNT - 1> rightCosts{};
+    LveAabb right{};
+    uint32_t rightCount = 0;
+    for (uint32_t bin = BIN_COUNT - 1; bin > 0; bin--) {
+      right.grow(bins[bin].bounds);
+      rightCount += bins[bin].count;
+      rightCosts[bin - 1] = rightCount > 0 ? rightCount * right.surfaceArea() : -1.f;
+    }
+    LveAabb left{};
+    uint32_t leftCount = 0;
+    for (uint32_t bin = 0; bin < BIN_COUNT - 1; bin++) {
+      left.grow(bins[bin].bounds);
+      leftCount += bins[bin].count;
+      if (leftCount == 0 || rightCosts[bin] < 0.f) continue;
+      float cost = leftCount * left.surfaceArea() + rightCosts[bin];
+      if (cost < bestCost) {
+        bestCost = cost;
+        bestAxis = axis;
+        bestBin = bin;
+      }
+    }
+  }
+
+  if (bestAxis < 0) {
+    // every centroid in the same spot, no plane separates them
+    return count <= MAX_LEAF_SIZE ? 0 : count / 2;
+  }
+  const float area = bounds.surfaceArea();
+  if (count <= MAX_LEAF_SIZE && (area <= 0.f || TRAVERSAL_COST + bestCost / area >= count)) {
+    return 0;
+  }
+
+  const float scale = BIN_COUNT / extent[bestAxis];
+  auto middle = std::partition(begin, end, [&](const Item &item) {
+    float offset = item.bounds.center()[bestAxis] - centroids.min[bestAxis];
+    auto bin = static_cast<uint32_t>(offset * scale);
+    return std::min(bin, BIN_COUNT - 1) <= bestBin;
+  });
+  auto leftCount = static_cast<uint32_t>(middle - begin);
+  return leftCount == 0 || leftCount == count ? count / 2 : leftCount;
+}
+
+// *************** Refit *********************
+
+void LveBvh::refit(LveGameObject::Map &gameObjects) {
+  LVE_CPU_ZONE("LveBvh::refit");
+  for (auto &item : items) {
+    if (item.isStatic) continue;
+    auto object = gameObjects.find(item.id);
+    if (object != gameObjects.end() && object->second.model != nullptr) {
+      item.bounds = computeWorldAabb(object->second);
+    }
+  }
+  refit();
+}
+
+void LveBvh::refit() {
+  // children always follow their parent, so walking backwards visits them first
+  for (size_t i = nodes.size(); i-- > 0;) {
+    Node &node = nodes[i];
+    LveAabb bounds{};
+    if (node.isLeaf()) {
+      for (uint32_t j = 0; j < node.count; j++) {
+        bounds.grow(items[node.rightOrFirst + j].bounds);
+      }
+    } else {
+      const Node &left = nodes[i + 1];
+      const Node &right = nodes[node.rightOrFirst];
+      bounds.grow(LveAabb{left.boundsMin, left.boundsMax});
+      bounds.grow(LveAabb{right.boundsMin, right.boundsMax});
+    }
+    node.boundsMin = bounds.min;
+    node.boundsMax = bounds.max;
+  }
+}
+
+void LveBvh::setItemBounds(LveGameObject::id_t id, const LveAabb &bounds) {
+  auto index = itemIndices.find(id);
+  if (index != itemIndices.end()) {
+    items[index->second].bounds = bounds;
+  }
+}
+
+float LveBvh::computeCost() const {
+  if (nodes.empty()) {
+    return 0.f;
+  }
+  float rootArea = LveAabb{nodes[0].boundsMin, nodes[0].boundsMax}.surfaceArea();
+  if (rootArea <= 0.f) {
+    return 0.f;
+  }
+  float cost = 0.f;
+  for (const auto &node : nodes) {
+    float area = LveAabb{node.boundsMin, node.boundsMax}.surfaceArea();
+    cost += area * (node.isLeaf() ? static_cast<float>(node.count) : TRAVERSAL_COST);
+  }
+  return cost / rootArea;
+}
+
+// *************** Queries *********************
+
+void LveBvh::queryFrustums(
+    const std::vector<LveFrustum> &frustums,
+    std::vector<std::vector<LveGameObject::id_t>> &visible) const {
+  LVE_CPU_ZONE("LveBvh::queryFrustums");
+  visible.resize(frustums.size());
+  for (auto &list : visible) {
+    list.clear();
+  }
+  if (nodes.empty() || frustums.empty()) {
+    return;
+  }
+
+  // activeViews[d] holds the views that see the node visited at depth d
+  std::vector<std::vector<uint32_t>> activeViews(64);
+  activeViews[0].resize(frustums.size());
+  for (uint32_t v = 0; v < frustums.size(); v++) {
+    activeViews[0][v] = v;
+  }
+  cullNode(0, 1, frustums, activeViews, visible);
+}
+
+void LveBvh::cullNode(
+    uint32_t nodeIndex,
+    size_t depth,
+    const std::vector<LveFrustum> &frustums,
+    std::vector<std::vector<uint32_t>> &activeViews,
+    std::vector<std::vector<LveGameObject::id_t>> &visible) const {
+  if (activeViews.size() <= depth) {
+    activeViews.resize(depth + 1);
+  }
+  const Node &node = nodes[nodeIndex];
+  const auto &parentViews = activeViews[depth - 1];
+  auto &views = activeViews[depth];
+  views.clear();
+  for (uint32_t v : parentViews) {
+    if (frustums[v].intersectsAabb(node.boundsMin, node.boundsMax)) {
+      views.push_back(v);
+    }
+  }
+  if (views.empty()) {
+    return;
+  }
+
+  if (node.isLeaf()) {
+    for (uint32_t i = node.rightOrFirst; i < node.rightOrFirst + node.count; i++) {
+      const Item &item = items[i];
+      for (uint32_t v : views) {
+        if (frustums[v].intersectsAabb(item.bounds.min, item.bounds.max)) {
+          visible[v].push_back(item.id);
+        }
+      }
+    }
+    return;
+  }
+  // views is not used after this point, the children may grow activeViews
+  cullNode(nodeIndex + 1, depth + 1, frustums, activeViews, visible);
+  cullNode(node.rightOrFirst, depth + 1, frustums, activeViews, visible);
+}
+
+void LveBvh::querySphere(
+    const glm::vec3 &center, float radius, std::vector<LveGameObject::id_t> &results) const {
+  if (nodes.empty()) {
+    return;
+  }
+  std::vector<uint32_t> stack;
+  stack.reserve(64);
+  stack.push_back(0);
+  while (!stack.empty()) {
+    const Node &node = nodes[stack.back()];
+    const uint32_t nodeIndex = stack.back();
+    stack.pop_back();
+    if (!LveAabb{node.boundsMin, node.boundsMax}.intersectsSphere(center, radius)) continue;
+
+    if (node.isLeaf()) {
+      for (uint32_t i = node.rightOrFirst; i < node.rightOrFirst + node.count; i++) {
+        if (items[i].bounds.intersectsSphere(center, radius)) {
+          results.push_back(items[i].id);
+        }
+      }
+    } else {
+      stack.push_back(node.rightOrFirst);
+      stack.push_back(nodeIndex + 1);
+    }
+  }
+}
+
+void LveBvh::querySpheres(
+    const std::vector<LveBoundingSphere> &spheres,
+    std::vector<std::vector<LveGameObject::id_t>> &results,
+    LveJobSystem *jobSystem) const {
+  LVE_CPU_ZONE("LveBvh::querySpheres");
+  results.resize(spheres.size());
+  auto query = [&](uint32_t begin, uint32_t end) {
+    for (uint32_t i = begin; i < end; i++) {
+      results[i].clear();
+      querySphere(spheres[i].center, spheres[i].radius, results[i]);
+    }
+  };
+  if (jobSystem != nullptr) {
+    jobSystem->parallelFor(static_cast<uint32_t>(spheres.size()), 64, query);
+  } else {
+    query(0, static_cast<uint32_t>(spheres.size()));
+  }
+}
+
+LveBvh::RayHit LveBvh::intersectRay(const LveRay &ray) const {
+  RayHit closest{};
+  if (nodes.empty()) {
+    return closest;
+  }
+  const glm::vec3 inverseDirection = 1.f / ray.direction;
+  auto enter = [&](const Node &node, float maxDistance) {
+    return LveAabb{node.boundsMin, node.boundsMax}.intersectRay(
+        ray.origin, inverseDirection, maxDistance);
+  };
+  float rootEntry = enter(nodes[0], ray.maxDistance);
+  if (rootEntry < 0.f) {
+    return closest;
+  }
+  closest.distance = ray.maxDistance;
+
+  // (node, entry distance), the nearer child is pushed last so it is visited first
+  std::vector<std::pair<uint32_t, float>> stack;
+  stack.reserve(64);
+  stack.emplace_back(0, rootEntry);
+  while (!stack.empty()) {
+    auto [nodeIndex, entry] = stack.back();
+    stack.pop_back();
+    if (entry > closest.distance) continue;
+
+    const Node &node = nodes[nodeIndex];
+    if (node.isLeaf()) {
+      for (uint32_t i = node.rightOrFirst; i < node.rightOrFirst + node.count; i++) {
+        float distance =
+            items[i].bounds.intersectRay(ray.origin, inverseDirection, closest.distance);
+        if (distance >= 0.f) {
+          closest = {true, items[i].id, distance};
+        }
+      }
+      continue;
+    }
+
+    const uint32_t children[2] = {nodeIndex + 1, node.rightOrFirst};
+    const float entries[2] = {
+        enter(nodes[children[0]], closest.distance),
+        enter(nodes[children[1]], closest.distance)};
+    const int nearer = entries[1] >= 0.f && (entries[0] < 0.f || entries[1] < entries[0]);
+    if (entries[1 - nearer] >= 0.f) {
+      stack.emplace_back(children[1 - nearer], entries[1 - nearer]);
+    }
+    if (entries[nearer] >= 0.f) {
+      stack.emplace_back(children[nearer], entries[nearer]);
+    }
+  }
+  if (!closest.hit) {
+    closest.distance = std::numeric_limits<float>::max();
+  }
+  return closest;
+}
+
+void LveBvh::intersectRays(
+    const std::vector<LveRay> &rays, std::vector<RayHit> &hits, LveJobSystem *jobSystem) const {
+  LVE_CPU_ZONE("LveBvh::intersectRays");
+  hits.resize(rays.size());
+  auto query = [&](uint32_t begin, uint32_t end) {
+    for (uint32_t i = begin; i < end; i++) {
+      hits[i] = intersectRay(rays[i]);
+    }
+  };
+  if (jobSystem != nullptr) {
+    jobSystem->parallelFor(static_cast<uint32_t>(rays.size()), 64, query);
+  } else {
+    query(0, static_cast<uint32_t>(rays.size()));
+  }
+}
+
+}  // namespace lve
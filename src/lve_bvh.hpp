@@ -0,0 +1,159 @@
+#pragma once
+
+#include "lve_frustum.hpp"
+#include "lve_game_object.hpp"
+#include "lve_job_system.hpp"
+
+// libs
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+// std
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace lve {
+
+struct LveAabb {
+  glm::vec3 min{std::numeric_limits<float>::max()};
+  glm::vec3 max{-std::numeric_limits<float>::max()};
+
+  void grow(const glm::vec3 &point) {
+    min = glm::min(min, point);
+    max = glm::max(max, point);
+  }
+  void grow(const LveAabb &other) {
+    min = glm::min(min, other.min);
+    max = glm::max(max, other.max);
+  }
+  glm::vec3 center() const { return .5f * (min + max); }
+  // 0 for empty boxes
+  float surfaceArea() const {
+    glm::vec3 extent = glm::max(max - min, glm::vec3{0.f});
+    return 2.f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+  }
+  bool intersectsSphere(const glm::vec3 &center, float radius) const {
+    glm::vec3 offset = glm::clamp(center, min, max) - center;
+    return glm::dot(offset, offset) <= radius * radius;
+  }
+  // distance along the ray to where it enters the box, 0 from inside, negative when it misses
+  // before maxDistance
+  float intersectRay(
+      const glm::vec3 &origin, const glm::vec3 &inverseDirection, float maxDistance) const {
+    glm::vec3 t1 = (min - origin) * inverseDirection;
+    glm::vec3 t2 = (max - origin) * inverseDirection;
+    glm::vec3 near = glm::min(t1, t2);
+    glm::vec3 far = glm::max(t1, t2);
+    float entry = glm::max(glm::max(near.x, near.y), glm::max(near.z, 0.f));
+    float exit = glm::min(glm::min(far.x, far.y), glm::min(far.z, maxDistance));
+    return entry <= exit ? entry : -1.f;
+  }
+};
+
+// World space box around a game object's model, from the model space bounds
+LveAabb computeWorldAabb(LveGameObject &gameObject);
+
+struct LveRay {
+  glm::vec3 origin{0.f};
+  glm::vec3 direction{0.f, 0.f, 1.f};
+  float maxDistance = std::numeric_limits<float>::max();
+};
+
+// Bounding volume hierarchy over the world space boxes of scene objects, for culling, picking and
+// light assignment without scanning every object. Built top down with binned SAH, the upper levels
+// in parallel on the job system. Nodes are 32 bytes and stored depth first, so a node's left child
+// directly follows it and only the right child needs an index.
+class LveBvh {
+ public:
+  static constexpr uint32_t BIN_COUNT = 16;
+  // nodes with this many items or fewer are never split
+  static constexpr uint32_t MIN_LEAF_SIZE = 2;
+  // nodes with more items are always split, even where SAH would prefer a leaf
+  static constexpr uint32_t MAX_LEAF_SIZE = 16;
+  // subtrees at least this large build their children as separate jobs
+  static constexpr uint32_t PARALLEL_BUILD_THRESHOLD = 4096;
+
+  struct Node {
+    glm::vec3 boundsMin;
+    uint32_t rightOrFirst;  // interior: index of the right child, leaf: first item
+    glm::vec3 boundsMax;
+    uint32_t count;  // items in a leaf, 0 for interior nodes
+
+    bool isLeaf() const { return count > 0; }
+  };
+
+  struct Item {
+    LveAabb bounds;
+    LveGameObject::id_t id;
+    // refit(gameObjects) doesn't recompute the bounds of static objects
+    bool isStatic = false;
+  };
+
+  struct RayHit {
+    bool hit = false;
+    LveGameObject::id_t id = 0;
+    // along the ray to the hit object's box, 0 when the ray starts inside it
+    float distance = std::numeric_limits<float>::max();
+  };
+
+  // Builds over every object with a model; objects still without one are left out
+  void build(LveGameObject::Map &gameObjects, LveJobSystem *jobSystem = nullptr);
+  void build(std::vector<Item> items, LveJobSystem *jobSystem = nullptr);
+
+  // Recomputes the bounds of the non static objects and refits the nodes around them. Objects
+  // added or removed since the build need a rebuild.
+  void refit(LveGameObject::Map &gameObjects);
+  // refits the nodes after items were changed through setItemBounds
+  void refit();
+  void setItemBounds(LveGameObject::id_t id, const LveAabb &bounds);
+
+  // SAH cost of the tree, refitting after large movements makes it grow
+  float computeCost() const;
+  // current cost relative to the cost right after the last build, rebuild once this gets large
+  float getDegradation() const { return builtCost > 0.f ? computeCost() / builtCost : 1.f; }
+
+  // visible[v] receives the ids of the objects whose box intersects frustums[v]. All views are
+  // culled in one traversal, subtrees are only tested against the views that still see them.
+  void queryFrustums(
+      const std::vector<LveFrustum> &frustums,
+      std::vector<std::vector<LveGameObject::id_t>> &visible) const;
+  // appends the ids of the objects whose box intersects the sphere
+  void querySphere(
+      const glm::vec3 &center, float radius, std::vector<LveGameObject::id_t> &results) const;
+  void querySpheres(
+      const std::vector<LveBoundingSphere> &spheres,
+      std::vector<std::vector<LveGameObject::id_t>> &results,
+      LveJobSystem *jobSystem = nullptr) const;
+  // closest object box along the ray
+  RayHit intersectRay(const LveRay &ray) const;
+  void intersectRays(
+      const std::vector<LveRay> &rays,
+      std::vector<RayHit> &hits,
+      LveJobSystem *jobSystem = nullptr) const;
+
+  const std::vector<Node> &getNodes() const { return nodes; }
+  size_t getItemCount() const { return items.size(); }
+
+ private:
+  std::vector<Node> buildSubtree(uint32_t first, uint32_t count, LveJobSystem *jobSystem);
+  void buildNode(std::vector<Node> &subtree, uint32_t first, uint32_t count);
+  // Computes the node's bounds and partitions its items, returns how many go left or 0 for a leaf
+  uint32_t splitItems(uint32_t first, uint32_t count, LveAabb &bounds);
+  void cullNode(
+      uint32_t nodeIndex,
+      size_t depth,
+      const std::vector<LveFrustum> &frustums,
+      std::vector<std::vector<uint32_t>> &activeViews,
+      std::vector<std::vector<LveGameObject::id_t>> &visible) const;
+
+  // in leaf order, leaves reference contiguous ranges
+  std::vector<Item> items;
+  std::vector<Node> nodes;
+  std::unordered_map<LveGameObject::id_t, uint32_t> itemIndices;
+  float builtCost = 0.f;
+};
+
+}  // namespace lve
@@ -0,0 +1,131 @@
+#include "lve_camera_path.hpp"
+
+// libs
+#include <glm/gtc/constants.hpp>
+
+// std
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#ifndef ENGINE_DIR
+#define ENGINE_DIR "../"
+#endif
+
+namespace lve {
+
+namespace {
+
+glm::vec3 catmullRom(
+    const glm::vec3 &p0, const glm::vec3 &p1, const glm::vec3 &p2, const glm::vec3 &p3, float t) {
+  float t2 = t * t;
+  float t3 = t2 * t;
+  return .5f * ((2.f * p1) + (p2 - p0) * t + (2.f * p0 - 5.f * p1 + 4.f * p2 - p3) * t2 +
+                (3.f * p1 - p0 - 3.f * p2 + p3) * t3);
+}
+
+}  // namespace
+
+std::vector<LveCameraPose> loadCameraPoses(const std::string &filepath) {
+  std::ifstream file{filepath};
+  if (!file.is_open()) {
+    file.open(ENGINE_DIR + filepath);
+  }
+  if (!file.is_open()) {
+    throw std::runtime_error("failed to open pose file: " + filepath);
+  }
+
+  std::vector<LveCameraPose> poses;
+  std::string line;
+  int lineNumber = 0;
+  while (std::getline(file, line)) {
+    lineNumber++;
+    if (line.empty() || line[0] == '#') continue;
+
+    std::istringstream stream{line};
+    LveCameraPose pose{};
+    if (!(stream >> pose.position.x >> pose.position.y >> pose.position.z >> pose.rotation.x >>
+          pose.rotation.y >> pose.rotation.z)) {
+      throw std::runtime_error(
+          "invalid pose on line " + std::to_string(lineNumber) + " of " + filepath);
+    }
+    poses.push_back(pose);
+  }
+  return poses;
+}
+
+LveCameraPath::LveCameraPath(std::vector<LveCameraPose> keys, float secondsPerKey, bool looping)
+    : keys{std::move(keys)}, secondsPerKey{secondsPerKey}, looping{looping} {
+  if (this->keys.empty()) {
+    throw std::runtime_error("camera path needs at least one key!");
+  }
+  if (secondsPerKey <= 0.f) {
+    throw std::runtime_error("camera path needs a positive duration per key!");
+  }
+}
+
+LveCameraPath LveCameraPath::loadFromFile(const std::string &filepath, float secondsPerKey) {
+  return LveCameraPath{loadCameraPoses(filepath), secondsPerKey, false};
+}
+
+LveCameraPath LveCameraPath::orbit(glm::vec3 center, float radius, float height, float seconds) {
+  constexpr int keyCount = 8;
+  std::vector<LveCameraPose> keys;
+  for (int i = 0; i < keyCount; i++) {
+    float angle = glm::two_pi<float>() * i / keyCount;
+    LveCameraPose pose{};
+    pose.position = center + glm::vec3{radius * std::sin(angle), height, -radius * std::cos(angle)};
+    // forward for yaw y is (sin y, 0, cos y), towards the center is (-sin a, 0, cos a)
+    pose.rotation.y = -angle;
+    keys.push_back(pose);
+  }
+  return LveCameraPath{keys, seconds / keyCount, true};
+}
+
+float LveCameraPath::getDuration() const {
+  return secondsPerKey * (looping ? keys.size() : keys.size() - 1);
+}
+
+const LveCameraPose &LveCameraPath::key(int index) const {
+  int count = static_cast<int>(keys.size());
+  if (looping) {
+    return keys[((index % count) + count) % count];
+  }
+  return keys[glm::clamp(index, 0, count - 1)];
+}
+
+LveCameraPose LveCameraPath::sample(float seconds) const {
+  float position = seconds / secondsPerKey;
+  if (looping) {
+    position = std::fmod(position, static_cast<float>(keys.size()));
+  } else {
+    position = glm::clamp(position, 0.f, static_cast<float>(keys.size() - 1));
+  }
+
+  int segment = static_cast<int>(std::floor(position));
+  float t = position - segment;
+
+  // rotations are interpolated as euler angles, so take each yaw the short way round from its
+  // neighbour to avoid spinning where a path wraps past 2 pi
+  auto unwrap = [](glm::vec3 rotation, const glm::vec3 &reference) {
+    rotation.y = reference.y + std::remainder(rotation.y - reference.y, glm::two_pi<float>());
+    return rotation;
+  };
+  glm::vec3 r1 = key(segment).rotation;
+  glm::vec3 r0 = unwrap(key(segment - 1).rotation, r1);
+  glm::vec3 r2 = unwrap(key(segment + 1).rotation, r1);
+  glm::vec3 r3 = unwrap(key(segment + 2).rotation, r2);
+
+  LveCameraPose pose{};
+  pose.position = catmullRom(
+      key(segment - 1).position,
+      key(segment).position,
+      key(segment + 1).position,
+      key(segment + 2).position,
+      t);
+  pose.rotation = catmullRom(r0, r1, r2, r3, t);
+  return pose;
+}
+
+}  // namespace lve
@@ -0,0 +1,45 @@
+#pragma once
+
+// libs
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+// std
+#include <string>
+#include <vector>
+
+namespace lve {
+
+// Position and rotation in the conventions of LveCamera::setViewYXZ
+struct LveCameraPose {
+  glm::vec3 position{};
+  glm::vec3 rotation{};
+};
+
+// Reads one pose per line as "px py pz rx ry rz". Empty lines and lines starting with '#' are
+// skipped. Relative paths are also looked up under ENGINE_DIR.
+std::vector<LveCameraPose> loadCameraPoses(const std::string &filepath);
+
+// Catmull-Rom spline through camera key poses, traversed at a fixed number of seconds per key.
+// Replaces KeyboardMovementController when a run has to be reproducible, e.g. in benchmarks.
+class LveCameraPath {
+ public:
+  LveCameraPath(std::vector<LveCameraPose> keys, float secondsPerKey, bool looping);
+
+  static LveCameraPath loadFromFile(const std::string &filepath, float secondsPerKey);
+  // closed loop around center at the given radius, looking at the center's vertical axis
+  static LveCameraPath orbit(glm::vec3 center, float radius, float height, float seconds);
+
+  float getDuration() const;
+  LveCameraPose sample(float seconds) const;
+
+ private:
+  const LveCameraPose &key(int index) const;
+
+  std::vector<LveCameraPose> keys;
+  float secondsPerKey;
+  bool looping;
+};
+
+}  // namespace lve
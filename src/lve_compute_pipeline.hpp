@@ -0,0 +1,33 @@
+#pragma once
+
+#include "lve_device.hpp"
+
+// std
+#include <string>
+
+namespace lve {
+
+class LveComputePipeline {
+ public:
+  LveComputePipeline(
+      LveDevice& device, const std::string& compFilepath, VkPipelineLayout pipelineLayout);
+  ~LveComputePipeline();
+
+  LveComputePipeline(const LveComputePipeline&) = delete;
+  LveComputePipeline& operator=(const LveComputePipeline&) = delete;
+
+  void bind(VkCommandBuffer commandBuffer);
+  void dispatch(VkCommandBuffer commandBuffer, uint32_t x, uint32_t y = 1, uint32_t z = 1);
+
+  // workgroups needed to cover count invocations with groups of groupSize
+  static uint32_t groupCount(uint32_t count, uint32_t groupSize) {
+    return (count + groupSize - 1) / groupSize;
+  }
+
+ private:
+  LveDevice& lveDevice;
+  VkPipeline computePipeline;
+  VkShaderModule compShaderModule;
+};
+
+}  // namespace lve
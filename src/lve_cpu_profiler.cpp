@@ -0,0 +1,196 @@
+#include "lve_cpu_profiler.hpp"
+
+// std
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace lve {
+
+namespace {
+
+struct Event {
+  std::atomic<const char *> name{nullptr};
+  std::atomic<uint64_t> startNs{0};
+  std::atomic<uint64_t> endNs{0};
+};
+
+// Single producer ring: only the owning thread writes, exporters read concurrently and discard
+// any slot the writer may have lapped while it was being copied.
+struct ThreadBuffer {
+  uint32_t threadId = 0;
+  std::string threadName{};
+  std::atomic<uint64_t> written{0};
+  std::array<Event, LveCpuProfiler::EVENTS_PER_THREAD> events{};
+};
+
+struct Registry {
+  std::mutex mutex;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+};
+
+Registry &registry() {
+  static Registry instance;
+  return instance;
+}
+
+ThreadBuffer &threadBuffer() {
+  // the registry keeps the buffer alive after its thread exits so its events can still be exported
+  thread_local std::shared_ptr<ThreadBuffer> buffer = [] {
+    auto created = std::make_shared<ThreadBuffer>();
+    auto &reg = registry();
+    std::lock_guard<std::mutex> lock{reg.mutex};
+    created->threadId = static_cast<uint32_t>(reg.buffers.size() + 1);
+    reg.buffers.push_back(created);
+    return created;
+  }();
+  return *buffer;
+}
+
+std::vector<std::shared_ptr<ThreadBuffer>> registeredBuffers() {
+  auto &reg = registry();
+  std::lock_guard<std::mutex> lock{reg.mutex};
+  return reg.buffers;
+}
+
+// Appends the zones of buffer that overlap [startNs, endNs]. Slots the writer lapped while they
+// were being copied are discarded.
+void copyZones(
+    const ThreadBuffer &buffer,
+    uint64_t startNs,
+    uint64_t endNs,
+    std::vector<LveCpuProfiler::ZoneEvent> &zones) {
+  uint64_t end = buffer.written.load(std::memory_order_acquire);
+  uint64_t begin = end > LveCpuProfiler::EVENTS_PER_THREAD
+                       ? end - LveCpuProfiler::EVENTS_PER_THREAD
+                       : 0;
+
+  size_t firstCopied = zones.size();
+  for (uint64_t i = begin; i < end; i++) {
+    const auto &event = buffer.events[i % LveCpuProfiler::EVENTS_PER_THREAD];
+    zones.push_back(
+        {event.name.load(std::memory_order_relaxed),
+         buffer.threadId,
+         event.startNs.load(std::memory_order_relaxed),
+         event.endNs.load(std::memory_order_relaxed)});
+  }
+
+  // keeps the relaxed loads above from moving past the second read of written
+  std::atomic_thread_fence(std::memory_order_acquire);
+  uint64_t after = buffer.written.load(std::memory_order_relaxed);
+  // the writer may already be filling event `after`, whose slot holds after - EVENTS_PER_THREAD
+  uint64_t firstValid = after + 1 > LveCpuProfiler::EVENTS_PER_THREAD
+                            ? after + 1 - LveCpuProfiler::EVENTS_PER_THREAD
+                            : 0;
+  size_t kept = firstCopied;
+  for (size_t i = firstCopied; i < zones.size(); i++) {
+    uint64_t index = begin + (i - firstCopied);
+    const auto &zone = zones[i];
+    if (index >= firstValid && zone.endNs >= startNs && zone.startNs <= endNs) {
+      zones[kept++] = zone;
+    }
+  }
+  zones.resize(kept);
+}
+
+const std::chrono::steady_clock::time_point &epoch() {
+  static const auto start = std::chrono::steady_clock::now();
+  return start;
+}
+
+void writeJsonString(std::ofstream &out, const char *text) {
+  out << '"';
+  for (const char *c = text; *c != '\0'; c++) {
+    if (*c == '"' || *c == '\\') {
+      out << '\\';
+    }
+    out << *c;
+  }
+  out << '"';
+}
+
+}  // namespace
+
+std::atomic<bool> LveCpuProfiler::enabled{false};
+
+uint64_t LveCpuProfiler::now() {
+  auto elapsed = std::chrono::steady_clock::now() - epoch();
+  // + 1 keeps 0 free as the "not recording" marker of LveCpuZone
+  return static_cast<uint64_t>(
+             std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) +
+         1;
+}
+
+void LveCpuProfiler::record(const char *name, uint64_t startNs, uint64_t endNs) {
+  auto &buffer = threadBuffer();
+  uint64_t index = buffer.written.load(std::memory_order_relaxed);
+  auto &event = buffer.events[index % EVENTS_PER_THREAD];
+  // pairs with the fence in copyZones: a reader that sees any of the stores below also sees
+  // written == index, so it knows the slot is being overwritten
+  std::atomic_thread_fence(std::memory_order_release);
+  event.name.store(name, std::memory_order_relaxed);
+  event.startNs.store(startNs, std::memory_order_relaxed);
+  event.endNs.store(endNs, std::memory_order_relaxed);
+  buffer.written.store(index + 1, std::memory_order_release);
+}
+
+void LveCpuProfiler::setThreadName(const std::string &name) {
+  auto &buffer = threadBuffer();
+  std::lock_guard<std::mutex> lock{registry().mutex};
+  buffer.threadName = name;
+}
+
+std::vector<LveCpuProfiler::ZoneEvent> LveCpuProfiler::collectZones(
+    uint64_t startNs, uint64_t endNs) {
+  std::vector<ZoneEvent> zones;
+  for (const auto &buffer : registeredBuffers()) {
+    copyZones(*buffer, startNs, endNs, zones);
+  }
+  return zones;
+}
+
+void LveCpuProfiler::writeChromeTrace(const std::string &filepath, double seconds) {
+  std::ofstream out{filepath};
+  if (!out.is_open()) {
+    throw std::runtime_error("failed to open trace file: " + filepath);
+  }
+
+  uint64_t nowNs = now();
+  uint64_t cutoffNs = nowNs - std::min(nowNs, static_cast<uint64_t>(seconds * 1e9));
+  out << std::fixed << std::setprecision(3);  // microseconds with nanosecond resolution
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  std::vector<ZoneEvent> zones;
+  for (const auto &buffer : registeredBuffers()) {
+    std::string threadName;
+    {
+      std::lock_guard<std::mutex> lock{registry().mutex};
+      threadName = buffer->threadName.empty()
+                       ? "thread " + std::to_string(buffer->threadId)
+                       : buffer->threadName;
+    }
+    out << (first ? "" : ",") << "\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":"
+        << buffer->threadId << ",\"args\":{\"name\":";
+    writeJsonString(out, threadName.c_str());
+    out << "}}";
+    first = false;
+
+    zones.clear();
+    copyZones(*buffer, cutoffNs, nowNs, zones);
+    for (const auto &zone : zones) {
+      out << ",\n{\"ph\":\"X\",\"name\":";
+      writeJsonString(out, zone.name);
+      out << ",\"pid\":1,\"tid\":" << zone.threadId << ",\"ts\":" << zone.startNs / 1000.0
+          << ",\"dur\":" << (zone.endNs - zone.startNs) / 1000.0 << "}";
+    }
+  }
+  out << "\n]}\n";
+}
+
+}  // namespace lve
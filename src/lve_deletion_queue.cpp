@@ -0,0 +1,60 @@
+#include "lve_deletion_queue.hpp"
+
+// std
+#include <utility>
+#include <vector>
+
+namespace lve {
+
+LveDeletionQueue::LveDeletionQueue(LveTimeline &frameTimeline, LveTimeline &transferTimeline)
+    : frameTimeline{frameTimeline}, transferTimeline{transferTimeline} {}
+
+LveDeletionQueue::~LveDeletionQueue() { flush(); }
+
+void LveDeletionQueue::push(std::function<void()> destroy) {
+  std::lock_guard<std::mutex> lock{mutex};
+  // uploads are submitted as soon as they are recorded, so the latest transfer value covers every
+  // one that may still write to the object
+  entries.push_back(
+      {frameTimeline.getLastValue() + 1, transferTimeline.getLastValue(), std::move(destroy)});
+}
+
+size_t LveDeletionQueue::collect() {
+  std::vector<std::function<void()>> retired;
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    while (!entries.empty() && frameTimeline.isComplete(entries.front().frameValue) &&
+           transferTimeline.isComplete(entries.front().transferValue)) {
+      retired.push_back(std::move(entries.front().destroy));
+      entries.pop_front();
+    }
+  }
+  // destroy callbacks may release other resources, which push again
+  for (auto &destroy : retired) {
+    destroy();
+  }
+  return retired.size();
+}
+
+void LveDeletionQueue::flush() {
+  while (true) {
+    std::deque<Entry> pending;
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      if (entries.empty()) {
+        return;
+      }
+      pending.swap(entries);
+    }
+    for (auto &entry : pending) {
+      entry.destroy();
+    }
+  }
+}
+
+size_t LveDeletionQueue::size() const {
+  std::lock_guard<std::mutex> lock{mutex};
+  return entries.size();
+}
+
+}  // namespace lve
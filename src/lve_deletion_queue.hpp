@@ -0,0 +1,47 @@
+#pragma once
+
+#include "lve_timeline.hpp"
+
+// std
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace lve {
+
+// Destroys GPU objects once the frame and transfer timelines show that no submitted frame or
+// upload can still use them, so resources can be released at any time without waiting for the
+// device to go idle.
+class LveDeletionQueue {
+ public:
+  LveDeletionQueue(LveTimeline &frameTimeline, LveTimeline &transferTimeline);
+  ~LveDeletionQueue();
+
+  LveDeletionQueue(const LveDeletionQueue &) = delete;
+  LveDeletionQueue &operator=(const LveDeletionQueue &) = delete;
+
+  // Runs destroy once the GPU finished the frame being recorded (or the next one, between frames)
+  // and every transfer submitted so far. Thread safe.
+  void push(std::function<void()> destroy);
+  // Runs the deletions whose frame retired, returns how many ran
+  size_t collect();
+  // Runs every pending deletion, the caller must know the device is idle
+  void flush();
+  size_t size() const;
+
+ private:
+  struct Entry {
+    uint64_t frameValue;
+    uint64_t transferValue;
+    std::function<void()> destroy;
+  };
+
+  LveTimeline &frameTimeline;
+  LveTimeline &transferTimeline;
+  mutable std::mutex mutex;
+  // neither value ever decreases, so entries retire from the front
+  std::deque<Entry> entries;
+};
+
+}  // namespace lve
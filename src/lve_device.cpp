@@ -1,5 +1,7 @@
 #include "lve_device.hpp"
 
+#include "lve_engine_events.hpp"
+
 // std headers
 #include <cstring>
 #include <iostream>
@@ -47,16 +49,45 @@ void DestroyDebugUtilsMessengerEXT(
 }
 
 // class member functions
-LveDevice::LveDevice(LveWindow &window) : window{window} {
+LveDevice::LveDevice(LveWindow &window) : window{&window} {
   createInstance();
   setupDebugMessenger();
   createSurface();
   pickPhysicalDevice();
   createLogicalDevice();
   createCommandPool();
+  createTimelines();
+}
+
+LveDevice::LveDevice() {
+  // nothing is presented, so the swapchain extension (and the surface it needs) is not required.
+  // This keeps the device creatable on drivers without WSI support, e.g. Mesa lavapipe on a
+  // machine with no display.
+  deviceExtensions.clear();
+
+  createInstance();
+  setupDebugMessenger();
+  pickPhysicalDevice();
+  createLogicalDevice();
+  createCommandPool();
+  createTimelines();
 }
 
 LveDevice::~LveDevice() {
+  waitIdle();
+  deletionQueue.reset();
+  for (auto &transfer : pendingTransfers) {
+    destroyTransfer(transfer);
+  }
+  frameTimeline.reset();
+  transferTimeline.reset();
+  computeTimeline.reset();
+  // destroying a pool frees its command buffers, retired ones included
+  for (auto &[threadId, pools] : threadCommandPools) {
+    vkDestroyCommandPool(device_, pools->graphics, nullptr);
+    vkDestroyCommandPool(device_, pools->transfer, nullptr);
+  }
+  vkDestroyCommandPool(device_, computeCommandPool, nullptr);
   vkDestroyCommandPool(device_, commandPool, nullptr);
   vkDestroyDevice(device_, nullptr);
 
@@ -64,7 +95,9 @@ LveDevice::~LveDevice() {
     DestroyDebugUtilsMessengerEXT(instance, debugMessenger, nullptr);
   }
 
-  vkDestroySurfaceKHR(instance, surface_, nullptr);
+  if (surface_ != VK_NULL_HANDLE) {
+    vkDestroySurfaceKHR(instance, surface_, nullptr);
+  }
   vkDestroyInstance(instance, nullptr);
 }
 
@@ -79,7 +112,8 @@ void LveDevice::createInstance() {
   appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
   appInfo.pEngineName = "No Engine";
   appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-  appInfo.apiVersion = VK_API_VERSION_1_0;
+  // 1.2 for timeline semaphores
+  appInfo.apiVersion = VK_API_VERSION_1_2;
 
   VkInstanceCreateInfo createInfo = {};
   createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -137,7 +171,11 @@ void LveDevice::createLogicalDevice() {
   QueueFamilyIndices indices = findQueueFamilies(physicalDevice);
 
   std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-  std::set<uint32_t> uniqueQueueFamilies = {indices.graphicsFamily, indices.presentFamily};
+  std::set<uint32_t> uniqueQueueFamilies = {
+      indices.graphicsFamily,
+      indices.presentFamily,
+      indices.transferFamily,
+      indices.computeFamily};
 
   float queuePriority = 1.0f;
   for (uint32_t queueFamily : uniqueQueueFamilies) {
@@ -149,8 +187,13 @@ void LveDevice::createLogicalDevice() {
     queueCreateInfos.push_back(queueCreateInfo);
   }
 
+  VkPhysicalDeviceFeatures supportedFeatures;
+  vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+
   VkPhysicalDeviceFeatures deviceFeatures = {};
   deviceFeatures.samplerAnisotropy = VK_TRUE;
+  // optional, used by the pipeline statistics diagnostics
+  deviceFeatures.pipelineStatisticsQuery = supportedFeatures.pipelineStatisticsQuery;
 
   VkDeviceCreateInfo createInfo = {};
   createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -159,6 +202,11 @@ void LveDevice::createLogicalDevice() {
   createInfo.pQueueCreateInfos = queueCreateInfos.data();
 
   createInfo.pEnabledFeatures = &deviceFeatures;
+
+  VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures{};
+  timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+  timelineFeatures.timelineSemaphore = VK_TRUE;
+  createInfo.pNext = &timelineFeatures;
   createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
   createInfo.ppEnabledExtensionNames = deviceExtensions.data();
 
@@ -174,9 +222,26 @@ void LveDevice::createLogicalDevice() {
   if (vkCreateDevice(physicalDevice, &createInfo, nullptr, &device_) != VK_SUCCESS) {
     throw std::runtime_error("failed to create logical device!");
   }
+  enabledFeatures = deviceFeatures;
 
   vkGetDeviceQueue(device_, indices.graphicsFamily, 0, &graphicsQueue_);
   vkGetDeviceQueue(device_, indices.presentFamily, 0, &presentQueue_);
+  vkGetDeviceQueue(device_, indices.transferFamily, 0, &transferQueue_);
+  vkGetDeviceQueue(device_, indices.computeFamily, 0, &computeQueue_);
+  graphicsFamily = indices.graphicsFamily;
+  transferFamily = indices.transferFamily;
+  computeFamily = indices.computeFamily;
+  for (VkQueue queue : {graphicsQueue_, presentQueue_, transferQueue_, computeQueue_}) {
+    if (queueMutexes.find(queue) == queueMutexes.end()) {
+      queueMutexes.emplace(queue, std::make_unique<std::mutex>());
+    }
+  }
+  if (indices.hasDedicatedTransfer()) {
+    std::cout << "dedicated transfer queue family: " << transferFamily << std::endl;
+  }
+  if (indices.hasDedicatedCompute()) {
+    std::cout << "async compute queue family: " << computeFamily << std::endl;
+  }
 }
 
 void LveDevice::createCommandPool() {
@@ -191,17 +256,84 @@ void LveDevice::createCommandPool() {
   if (vkCreateCommandPool(device_, &poolInfo, nullptr, &commandPool) != VK_SUCCESS) {
     throw std::runtime_error("failed to create command pool!");
   }
+
+  poolInfo.queueFamilyIndex = computeFamily;
+  poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+  if (vkCreateCommandPool(device_, &poolInfo, nullptr, &computeCommandPool) != VK_SUCCESS) {
+    throw std::runtime_error("failed to create compute command pool!");
+  }
 }
 
-void LveDevice::createSurface() { window.createWindowSurface(instance, &surface_); }
+VkCommandPool LveDevice::getThreadCommandPool() { return getThreadCommandPools().graphics; }
+
+LveDevice::ThreadCommandPools &LveDevice::getThreadCommandPools() {
+  std::lock_guard<std::mutex> lock{threadCommandPoolsMutex};
+  auto &pools = threadCommandPools[std::this_thread::get_id()];
+  if (pools) {
+    return *pools;
+  }
+
+  auto newPools = std::make_unique<ThreadCommandPools>();
+  VkCommandPoolCreateInfo poolInfo = {};
+  poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+  poolInfo.queueFamilyIndex = graphicsFamily;
+  poolInfo.flags =
+      VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+  if (vkCreateCommandPool(device_, &poolInfo, nullptr, &newPools->graphics) != VK_SUCCESS) {
+    throw std::runtime_error("failed to create thread command pool!");
+  }
+
+  poolInfo.queueFamilyIndex = transferFamily;
+  poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+  if (vkCreateCommandPool(device_, &poolInfo, nullptr, &newPools->transfer) != VK_SUCCESS) {
+    vkDestroyCommandPool(device_, newPools->graphics, nullptr);
+    throw std::runtime_error("failed to create thread transfer command pool!");
+  }
+  pools = std::move(newPools);
+  return *pools;
+}
+
+VkResult LveDevice::queueSubmit(
+    VkQueue queue, uint32_t submitCount, const VkSubmitInfo *submits, VkFence fence) {
+  std::lock_guard<std::mutex> lock{*queueMutexes.at(queue)};
+  return vkQueueSubmit(queue, submitCount, submits, fence);
+}
+
+VkResult LveDevice::queuePresent(const VkPresentInfoKHR &presentInfo) {
+  std::lock_guard<std::mutex> lock{*queueMutexes.at(presentQueue_)};
+  return vkQueuePresentKHR(presentQueue_, &presentInfo);
+}
+
+void LveDevice::waitQueueIdle(VkQueue queue) {
+  std::lock_guard<std::mutex> lock{*queueMutexes.at(queue)};
+  vkQueueWaitIdle(queue);
+}
+
+void LveDevice::waitIdle() {
+  // every lock is taken in the map's order, nothing else holds more than one queue lock
+  std::vector<std::unique_lock<std::mutex>> locks;
+  for (auto &[queue, mutex] : queueMutexes) {
+    locks.emplace_back(*mutex);
+  }
+  vkDeviceWaitIdle(device_);
+}
+
+void LveDevice::createTimelines() {
+  frameTimeline = std::make_unique<LveTimeline>(device_);
+  transferTimeline = std::make_unique<LveTimeline>(device_);
+  computeTimeline = std::make_unique<LveTimeline>(device_);
+  deletionQueue = std::make_unique<LveDeletionQueue>(*frameTimeline, *transferTimeline);
+}
+
+void LveDevice::createSurface() { window->createWindowSurface(instance, &surface_); }
 
 bool LveDevice::isDeviceSuitable(VkPhysicalDevice device) {
   QueueFamilyIndices indices = findQueueFamilies(device);
 
   bool extensionsSupported = checkDeviceExtensionSupport(device);
 
-  bool swapChainAdequate = false;
-  if (extensionsSupported) {
+  bool swapChainAdequate = isHeadless();
+  if (extensionsSupported && !isHeadless()) {
     SwapChainSupportDetails swapChainSupport = querySwapChainSupport(device);
     swapChainAdequate = !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
   }
@@ -209,8 +341,21 @@ bool LveDevice::isDeviceSuitable(VkPhysicalDevice device) {
   VkPhysicalDeviceFeatures supportedFeatures;
   vkGetPhysicalDeviceFeatures(device, &supportedFeatures);
 
+  VkPhysicalDeviceProperties deviceProperties;
+  vkGetPhysicalDeviceProperties(device, &deviceProperties);
+  bool timelineSemaphoreSupported = false;
+  if (deviceProperties.apiVersion >= VK_API_VERSION_1_2) {
+    VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures{};
+    timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+    VkPhysicalDeviceFeatures2 features2{};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features2.pNext = &timelineFeatures;
+    vkGetPhysicalDeviceFeatures2(device, &features2);
+    timelineSemaphoreSupported = timelineFeatures.timelineSemaphore;
+  }
+
   return indices.isComplete() && extensionsSupported && swapChainAdequate &&
-         supportedFeatures.samplerAnisotropy;
+         supportedFeatures.samplerAnisotropy && timelineSemaphoreSupported;
 }
 
 void LveDevice::populateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT &createInfo) {
@@ -260,11 +405,13 @@ bool LveDevice::checkValidationLayerSupport() {
 }
 
 std::vector<const char *> LveDevice::getRequiredExtensions() {
-  uint32_t glfwExtensionCount = 0;
-  const char **glfwExtensions;
-  glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
-
-  std::vector<const char *> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+  std::vector<const char *> extensions;
+  if (!isHeadless()) {
+    uint32_t glfwExtensionCount = 0;
+    const char **glfwExtensions;
+    glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+    extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+  }
 
   if (enableValidationLayers) {
     extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
@@ -327,23 +474,56 @@ QueueFamilyIndices LveDevice::findQueueFamilies(VkPhysicalDevice device) {
 
   int i = 0;
   for (const auto &queueFamily : queueFamilies) {
-    if (queueFamily.queueCount > 0 && queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+    // the scan goes on after graphics and present were found, keep the first families chosen
+    if (queueFamily.queueCount > 0 && queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT &&
+        !indices.graphicsFamilyHasValue) {
       indices.graphicsFamily = i;
       indices.graphicsFamilyHasValue = true;
     }
     VkBool32 presentSupport = false;
-    vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface_, &presentSupport);
-    if (queueFamily.queueCount > 0 && presentSupport) {
+    if (isHeadless()) {
+      // nothing is presented, alias the present family to the graphics family
+      presentSupport =
+          indices.graphicsFamilyHasValue && indices.graphicsFamily == static_cast<uint32_t>(i);
+    } else {
+      vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface_, &presentSupport);
+    }
+    // presenting from the graphics family avoids sharing the swap chain images between queues
+    bool isGraphicsFamily =
+        indices.graphicsFamilyHasValue && indices.graphicsFamily == static_cast<uint32_t>(i);
+    if (queueFamily.queueCount > 0 && presentSupport &&
+        (!indices.presentFamilyHasValue || isGraphicsFamily)) {
       indices.presentFamily = i;
       indices.presentFamilyHasValue = true;
     }
-    if (indices.isComplete()) {
+    const VkQueueFlags flags = queueFamily.queueFlags;
+    bool transferOnly = (flags & VK_QUEUE_TRANSFER_BIT) &&
+                        !(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT));
+    if (queueFamily.queueCount > 0 && transferOnly && !indices.transferFamilyHasValue) {
+      indices.transferFamily = i;
+      indices.transferFamilyHasValue = true;
+    }
+    bool asyncCompute = (flags & VK_QUEUE_COMPUTE_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT);
+    if (queueFamily.queueCount > 0 && asyncCompute && !indices.computeFamilyHasValue) {
+      indices.computeFamily = i;
+      indices.computeFamilyHasValue = true;
+    }
+    if (indices.isComplete() && indices.transferFamilyHasValue && indices.computeFamilyHasValue) {
       break;
     }
 
     i++;
   }
 
+  // graphics queues support transfers and compute too
+  if (!indices.transferFamilyHasValue && indices.graphicsFamilyHasValue) {
+    indices.transferFamily = indices.graphicsFamily;
+    indices.transferFamilyHasValue = true;
+  }
+  if (!indices.computeFamilyHasValue && indices.graphicsFamilyHasValue) {
+    indices.computeFamily = indices.graphicsFamily;
+    indices.computeFamilyHasValue = true;
+  }
   return indices;
 }
 
@@ -402,17 +582,35 @@ uint32_t LveDevice::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags pr
   throw std::runtime_error("failed to find suitable memory type!");
 }
 
+bool LveDevice::hasMemoryType(VkMemoryPropertyFlags properties) {
+  VkPhysicalDeviceMemoryProperties memProperties;
+  vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+  for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
+    if ((memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void LveDevice::createBuffer(
     VkDeviceSize size,
     VkBufferUsageFlags usage,
     VkMemoryPropertyFlags properties,
     VkBuffer &buffer,
-    VkDeviceMemory &bufferMemory) {
+    VkDeviceMemory &bufferMemory,
+    bool sharedWithCompute) {
   VkBufferCreateInfo bufferInfo{};
   bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
   bufferInfo.size = size;
   bufferInfo.usage = usage;
   bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  uint32_t queueFamilyIndices[] = {graphicsFamily, computeFamily};
+  if (sharedWithCompute && hasDedicatedComputeQueue()) {
+    bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+    bufferInfo.queueFamilyIndexCount = 2;
+    bufferInfo.pQueueFamilyIndices = queueFamilyIndices;
+  }
 
   if (vkCreateBuffer(device_, &bufferInfo, nullptr, &buffer) != VK_SUCCESS) {
     throw std::runtime_error("failed to create vertex buffer!");
@@ -426,6 +624,7 @@ void LveDevice::createBuffer(
   allocInfo.allocationSize = memRequirements.size;
   allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties);
 
+  LveEngineEventScope event{"allocation", "buffer", allocInfo.allocationSize};
   if (vkAllocateMemory(device_, &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS) {
     throw std::runtime_error("failed to allocate vertex buffer memory!");
   }
@@ -437,7 +636,7 @@ VkCommandBuffer LveDevice::beginSingleTimeCommands() {
   VkCommandBufferAllocateInfo allocInfo{};
   allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
   allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-  allocInfo.commandPool = commandPool;
+  allocInfo.commandPool = getThreadCommandPool();
   allocInfo.commandBufferCount = 1;
 
   VkCommandBuffer commandBuffer;
@@ -452,6 +651,8 @@ VkCommandBuffer LveDevice::beginSingleTimeCommands() {
 }
 
 void LveDevice::endSingleTimeCommands(VkCommandBuffer commandBuffer) {
+  // submits and waits for the command buffer to finish, a stall if it happens during a frame
+  LveEngineEventScope event{"blocking transfer", "single time commands"};
   vkEndCommandBuffer(commandBuffer);
 
   VkSubmitInfo submitInfo{};
@@ -459,10 +660,18 @@ void LveDevice::endSingleTimeCommands(VkCommandBuffer commandBuffer) {
   submitInfo.commandBufferCount = 1;
   submitInfo.pCommandBuffers = &commandBuffer;
 
-  vkQueueSubmit(graphicsQueue_, 1, &submitInfo, VK_NULL_HANDLE);
-  vkQueueWaitIdle(graphicsQueue_);
+  // a fence instead of vkQueueWaitIdle, which would keep the queue locked while waiting
+  VkFenceCreateInfo fenceInfo{};
+  fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+  VkFence fence;
+  if (vkCreateFence(device_, &fenceInfo, nullptr, &fence) != VK_SUCCESS) {
+    throw std::runtime_error("failed to create single time commands fence!");
+  }
+  queueSubmit(graphicsQueue_, 1, &submitInfo, fence);
+  vkWaitForFences(device_, 1, &fence, VK_TRUE, UINT64_MAX);
+  vkDestroyFence(device_, fence, nullptr);
 
-  vkFreeCommandBuffers(device_, commandPool, 1, &commandBuffer);
+  vkFreeCommandBuffers(device_, getThreadCommandPool(), 1, &commandBuffer);
 }
 
 void LveDevice::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size) {
@@ -504,6 +713,213 @@ void LveDevice::copyBufferToImage(
   endSingleTimeCommands(commandBuffer);
 }
 
+LveTransferBatch LveDevice::beginTransfer() {
+  auto &pools = getThreadCommandPools();
+  std::vector<VkCommandBuffer> retired;
+  {
+    std::lock_guard<std::mutex> lock{pools.retiredMutex};
+    retired.swap(pools.retiredTransfers);
+  }
+  if (!retired.empty()) {
+    vkFreeCommandBuffers(
+        device_,
+        pools.transfer,
+        static_cast<uint32_t>(retired.size()),
+        retired.data());
+  }
+
+  VkCommandBufferAllocateInfo allocInfo{};
+  allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+  allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+  allocInfo.commandPool = pools.transfer;
+  allocInfo.commandBufferCount = 1;
+
+  LveTransferBatch batch{};
+  if (vkAllocateCommandBuffers(device_, &allocInfo, &batch.commandBuffer) != VK_SUCCESS) {
+    throw std::runtime_error("failed to allocate transfer command buffer!");
+  }
+
+  VkCommandBufferBeginInfo beginInfo{};
+  beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  vkBeginCommandBuffer(batch.commandBuffer, &beginInfo);
+  return batch;
+}
+
+void LveDevice::uploadBuffer(
+    LveTransferBatch &batch,
+    VkBuffer dstBuffer,
+    const void *data,
+    VkDeviceSize size,
+    VkPipelineStageFlags dstStageMask,
+    VkAccessFlags dstAccessMask) {
+  VkBuffer stagingBuffer;
+  VkDeviceMemory stagingBufferMemory;
+  createBuffer(
+      size,
+      VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+      stagingBuffer,
+      stagingBufferMemory);
+  batch.stagingBuffers.push_back(stagingBuffer);
+  batch.stagingBufferMemorys.push_back(stagingBufferMemory);
+
+  void *mapped;
+  vkMapMemory(device_, stagingBufferMemory, 0, size, 0, &mapped);
+  memcpy(mapped, data, static_cast<size_t>(size));
+  vkUnmapMemory(device_, stagingBufferMemory);
+
+  VkBufferCopy copyRegion{};
+  copyRegion.size = size;
+  vkCmdCopyBuffer(batch.commandBuffer, stagingBuffer, dstBuffer, 1, &copyRegion);
+
+  if (hasDedicatedTransferQueue()) {
+    // release half of the ownership transfer, the graphics queue acquires in
+    // recordTransferAcquires
+    VkBufferMemoryBarrier release{};
+    release.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    release.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    release.dstAccessMask = 0;
+    release.srcQueueFamilyIndex = transferFamily;
+    release.dstQueueFamilyIndex = graphicsFamily;
+    release.buffer = dstBuffer;
+    release.offset = 0;
+    release.size = VK_WHOLE_SIZE;
+    vkCmdPipelineBarrier(
+        batch.commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        0,
+        0,
+        nullptr,
+        1,
+        &release,
+        0,
+        nullptr);
+  }
+  batch.acquires.push_back({dstBuffer, dstStageMask, dstAccessMask});
+}
+
+LveDevice::TransferToken LveDevice::submitTransfer(LveTransferBatch &&batch) {
+  vkEndCommandBuffer(batch.commandBuffer);
+  auto &pools = getThreadCommandPools();
+
+  // values are taken and submitted under one lock, a timeline may only be signaled increasingly
+  std::lock_guard<std::mutex> lock{transferMutex};
+  PendingTransfer transfer{transferTimeline->nextValue(), std::move(batch), &pools};
+
+  VkTimelineSemaphoreSubmitInfo timelineInfo{};
+  timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+  timelineInfo.signalSemaphoreValueCount = 1;
+  timelineInfo.pSignalSemaphoreValues = &transfer.token;
+
+  VkSemaphore signalSemaphore = transferTimeline->getSemaphore();
+  VkSubmitInfo submitInfo{};
+  submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+  submitInfo.pNext = &timelineInfo;
+  submitInfo.commandBufferCount = 1;
+  submitInfo.pCommandBuffers = &transfer.batch.commandBuffer;
+  submitInfo.signalSemaphoreCount = 1;
+  submitInfo.pSignalSemaphores = &signalSemaphore;
+  if (queueSubmit(transferQueue_, 1, &submitInfo) != VK_SUCCESS) {
+    throw std::runtime_error("failed to submit transfer command buffer!");
+  }
+
+  TransferToken token = transfer.token;
+  pendingTransfers.push_back(std::move(transfer));
+  return token;
+}
+
+void LveDevice::collectTransfers() {
+  while (!pendingTransfers.empty()) {
+    auto &transfer = pendingTransfers.front();
+    if (!transferTimeline->isComplete(transfer.token)) {
+      break;
+    }
+    readyAcquires.insert(
+        readyAcquires.end(),
+        transfer.batch.acquires.begin(),
+        transfer.batch.acquires.end());
+    readyTransferToken = transfer.token;
+    destroyTransfer(transfer);
+    pendingTransfers.pop_front();
+  }
+}
+
+void LveDevice::destroyTransfer(PendingTransfer &transfer) {
+  {
+    std::lock_guard<std::mutex> lock{transfer.pools->retiredMutex};
+    transfer.pools->retiredTransfers.push_back(transfer.batch.commandBuffer);
+  }
+  for (size_t i = 0; i < transfer.batch.stagingBuffers.size(); i++) {
+    vkDestroyBuffer(device_, transfer.batch.stagingBuffers[i], nullptr);
+    vkFreeMemory(device_, transfer.batch.stagingBufferMemorys[i], nullptr);
+  }
+}
+
+LveTimelinePoint LveDevice::recordTransferAcquires(VkCommandBuffer commandBuffer) {
+  std::lock_guard<std::mutex> lock{transferMutex};
+  collectTransfers();
+  VkPipelineStageFlags stages = recordReadyAcquires(commandBuffer);
+  acquiredTransferToken.store(readyTransferToken, std::memory_order_release);
+  if (stages == 0) {
+    return {};
+  }
+  return transferTimeline->point(readyTransferToken, stages);
+}
+
+VkPipelineStageFlags LveDevice::recordReadyAcquires(VkCommandBuffer commandBuffer) {
+  if (readyAcquires.empty()) {
+    return 0;
+  }
+
+  const bool ownershipTransfer = hasDedicatedTransferQueue();
+  std::vector<VkBufferMemoryBarrier> barriers(readyAcquires.size());
+  VkPipelineStageFlags dstStageMask = 0;
+  for (size_t i = 0; i < readyAcquires.size(); i++) {
+    auto &barrier = barriers[i];
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = ownershipTransfer ? 0 : VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = readyAcquires[i].dstAccessMask;
+    barrier.srcQueueFamilyIndex = ownershipTransfer ? transferFamily : VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = ownershipTransfer ? graphicsFamily : VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = readyAcquires[i].buffer;
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+    dstStageMask |= readyAcquires[i].dstStageMask;
+  }
+  vkCmdPipelineBarrier(
+      commandBuffer,
+      ownershipTransfer ? VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT : VK_PIPELINE_STAGE_TRANSFER_BIT,
+      dstStageMask,
+      0,
+      0,
+      nullptr,
+      static_cast<uint32_t>(barriers.size()),
+      barriers.data(),
+      0,
+      nullptr);
+
+  readyAcquires.clear();
+  return dstStageMask;
+}
+
+void LveDevice::flushTransfers() {
+  std::lock_guard<std::mutex> lock{transferMutex};
+  if (!pendingTransfers.empty()) {
+    LveEngineEventScope event{"blocking transfer", "flush uploads"};
+    transferTimeline->wait(pendingTransfers.back().token);
+  }
+  collectTransfers();
+  if (!readyAcquires.empty()) {
+    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+    recordReadyAcquires(commandBuffer);
+    endSingleTimeCommands(commandBuffer);
+  }
+  // published after the acquires executed, another thread may start using the buffers right away
+  acquiredTransferToken.store(readyTransferToken, std::memory_order_release);
+}
+
 void LveDevice::createImageWithInfo(
     const VkImageCreateInfo &imageInfo,
     VkMemoryPropertyFlags properties,
@@ -521,6 +937,7 @@ void LveDevice::createImageWithInfo(
   allocInfo.allocationSize = memRequirements.size;
   allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties);
 
+  LveEngineEventScope event{"allocation", "image", allocInfo.allocationSize};
   if (vkAllocateMemory(device_, &allocInfo, nullptr, &imageMemory) != VK_SUCCESS) {
     throw std::runtime_error("failed to allocate image memory!");
   }
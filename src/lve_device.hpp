@@ -1,9 +1,18 @@
 #pragma once
 
+#include "lve_deletion_queue.hpp"
+#include "lve_timeline.hpp"
 #include "lve_window.hpp"
 
 // std lib headers
+#include <cstdint>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace lve {
@@ -17,9 +26,33 @@ struct SwapChainSupportDetails {
 struct QueueFamilyIndices {
   uint32_t graphicsFamily;
   uint32_t presentFamily;
+  // a transfer-only family (usually a DMA engine) when the device has one, else graphicsFamily
+  uint32_t transferFamily;
+  // a compute family without graphics support (async compute) when there is one, else
+  // graphicsFamily
+  uint32_t computeFamily;
   bool graphicsFamilyHasValue = false;
   bool presentFamilyHasValue = false;
+  bool transferFamilyHasValue = false;
+  bool computeFamilyHasValue = false;
   bool isComplete() { return graphicsFamilyHasValue && presentFamilyHasValue; }
+  bool hasDedicatedTransfer() { return transferFamilyHasValue && transferFamily != graphicsFamily; }
+  bool hasDedicatedCompute() { return computeFamilyHasValue && computeFamily != graphicsFamily; }
+};
+
+// Copies recorded for one submission to the transfer queue, see LveDevice::beginTransfer
+struct LveTransferBatch {
+  // a destination buffer and how the graphics queue will first use it
+  struct Acquire {
+    VkBuffer buffer;
+    VkPipelineStageFlags dstStageMask;
+    VkAccessFlags dstAccessMask;
+  };
+
+  VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+  std::vector<VkBuffer> stagingBuffers{};
+  std::vector<VkDeviceMemory> stagingBufferMemorys{};
+  std::vector<Acquire> acquires{};
 };
 
 class LveDevice {
@@ -31,6 +64,8 @@ class LveDevice {
 #endif
 
   LveDevice(LveWindow &window);
+  // headless device: no surface, no swapchain extension, present queue aliases graphics queue
+  LveDevice();
   ~LveDevice();
 
   // Not copyable or movable
@@ -39,31 +74,101 @@ class LveDevice {
   LveDevice(LveDevice &&) = delete;
   LveDevice &operator=(LveDevice &&) = delete;
 
+  // value of the transfer timeline signaled by a submission, later tokens complete after earlier
+  // ones
+  using TransferToken = uint64_t;
+
+  // Pools of the render thread, command buffers from the compute pool can be reset individually.
+  // Other threads record into getThreadCommandPool instead.
   VkCommandPool getCommandPool() { return commandPool; }
+  VkCommandPool getComputeCommandPool() { return computeCommandPool; }
+  // Graphics family pool owned by the calling thread, created on its first use and destroyed with
+  // the device
+  VkCommandPool getThreadCommandPool();
   VkDevice device() { return device_; }
+  VkPhysicalDevice getPhysicalDevice() { return physicalDevice; }
   VkSurfaceKHR surface() { return surface_; }
   VkQueue graphicsQueue() { return graphicsQueue_; }
   VkQueue presentQueue() { return presentQueue_; }
+  // same queue as graphicsQueue when the device has no dedicated transfer family
+  VkQueue transferQueue() { return transferQueue_; }
+  bool hasDedicatedTransferQueue() const { return transferFamily != graphicsFamily; }
+  // same queue as graphicsQueue when the device has no async compute family
+  VkQueue computeQueue() { return computeQueue_; }
+  bool hasDedicatedComputeQueue() const { return computeFamily != graphicsFamily; }
+  bool isHeadless() const { return window == nullptr; }
+
+  // Queue access is externally synchronized in Vulkan, submit through these (never vkQueueSubmit
+  // directly) so any thread may submit. Queues aliasing the same VkQueue share one lock.
+  VkResult queueSubmit(
+      VkQueue queue,
+      uint32_t submitCount,
+      const VkSubmitInfo *submits,
+      VkFence fence = VK_NULL_HANDLE);
+  VkResult queuePresent(const VkPresentInfoKHR &presentInfo);
+  // vkQueueWaitIdle with the queue locked, nothing can be submitted or presented meanwhile
+  void waitQueueIdle(VkQueue queue);
+  // vkDeviceWaitIdle with every queue locked
+  void waitIdle();
+
+  // Timeline semaphores of the graphics, transfer and compute queues. Frames signal the frame
+  // timeline, so "has the GPU finished frame N" is a comparison against its value.
+  LveTimeline &getFrameTimeline() { return *frameTimeline; }
+  LveTimeline &getTransferTimeline() { return *transferTimeline; }
+  LveTimeline &getComputeTimeline() { return *computeTimeline; }
+  // Destroy GPU objects through this instead of directly, they are freed once the frames that
+  // may use them retired
+  LveDeletionQueue &getDeletionQueue() { return *deletionQueue; }
 
   SwapChainSupportDetails getSwapChainSupport() { return querySwapChainSupport(physicalDevice); }
   uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
+  bool hasMemoryType(VkMemoryPropertyFlags properties);
   QueueFamilyIndices findPhysicalQueueFamilies() { return findQueueFamilies(physicalDevice); }
   VkFormat findSupportedFormat(
       const std::vector<VkFormat> &candidates, VkImageTiling tiling, VkFormatFeatureFlags features);
 
-  // Buffer Helper Functions
+  // Buffer Helper Functions, safe to call from any thread
+  // sharedWithCompute buffers are accessed by both the graphics and the compute queue without
+  // ownership transfers (concurrent sharing, when those are different families)
   void createBuffer(
       VkDeviceSize size,
       VkBufferUsageFlags usage,
       VkMemoryPropertyFlags properties,
       VkBuffer &buffer,
-      VkDeviceMemory &bufferMemory);
+      VkDeviceMemory &bufferMemory,
+      bool sharedWithCompute = false);
   VkCommandBuffer beginSingleTimeCommands();
   void endSingleTimeCommands(VkCommandBuffer commandBuffer);
   void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
   void copyBufferToImage(
       VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, uint32_t layerCount);
 
+  // Asynchronous uploads on the transfer queue, they overlap with rendering instead of waiting for
+  // the graphics queue to drain. Record copies into a batch, submit it for a token and use the
+  // destination buffers once isTransferComplete(token) returns true. A batch is recorded on the
+  // thread that began it, different threads may record and submit batches concurrently.
+  LveTransferBatch beginTransfer();
+  // Copies data into dstBuffer through a staging buffer owned by the batch
+  void uploadBuffer(
+      LveTransferBatch &batch,
+      VkBuffer dstBuffer,
+      const void *data,
+      VkDeviceSize size,
+      VkPipelineStageFlags dstStageMask,
+      VkAccessFlags dstAccessMask);
+  TransferToken submitTransfer(LveTransferBatch &&batch);
+  // true once the copies finished and their buffers were handed to the graphics queue
+  bool isTransferComplete(TransferToken token) const {
+    return token <= acquiredTransferToken.load(std::memory_order_acquire);
+  }
+  // Records the queue family ownership acquire (or a plain barrier, without a dedicated transfer
+  // queue) for every finished transfer. Call at the start of each graphics command buffer. The
+  // returned transfer timeline point must be waited on by that command buffer's submit, which
+  // orders the releases before the acquires on the device. No semaphore when nothing was acquired.
+  LveTimelinePoint recordTransferAcquires(VkCommandBuffer commandBuffer);
+  // Blocks until every submitted transfer is complete, acquiring them on the graphics queue
+  void flushTransfers();
+
   void createImageWithInfo(
       const VkImageCreateInfo &imageInfo,
       VkMemoryPropertyFlags properties,
@@ -71,6 +176,8 @@ class LveDevice {
       VkDeviceMemory &imageMemory);
 
   VkPhysicalDeviceProperties properties;
+  // features the logical device was created with, optional ones are enabled when supported
+  VkPhysicalDeviceFeatures enabledFeatures{};
 
  private:
   void createInstance();
@@ -79,6 +186,27 @@ class LveDevice {
   void pickPhysicalDevice();
   void createLogicalDevice();
   void createCommandPool();
+  void createTimelines();
+
+  struct ThreadCommandPools {
+    VkCommandPool graphics = VK_NULL_HANDLE;
+    VkCommandPool transfer = VK_NULL_HANDLE;
+    // finished transfer command buffers, freed by the owning thread since the pool is its alone
+    std::mutex retiredMutex;
+    std::vector<VkCommandBuffer> retiredTransfers;
+  };
+  ThreadCommandPools &getThreadCommandPools();
+
+  struct PendingTransfer {
+    TransferToken token;
+    LveTransferBatch batch;
+    ThreadCommandPools *pools;
+  };
+  // retires submissions the transfer timeline has passed, oldest first. Callers hold transferMutex
+  void collectTransfers();
+  // returns the stages the acquired buffers are used at, 0 when there was nothing to acquire
+  VkPipelineStageFlags recordReadyAcquires(VkCommandBuffer commandBuffer);
+  void destroyTransfer(PendingTransfer &transfer);
 
   // helper functions
   bool isDeviceSuitable(VkPhysicalDevice device);
@@ -93,16 +221,40 @@ class LveDevice {
   VkInstance instance;
   VkDebugUtilsMessengerEXT debugMessenger;
   VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
-  LveWindow &window;
+  LveWindow *window = nullptr;
   VkCommandPool commandPool;
+  VkCommandPool computeCommandPool;
 
   VkDevice device_;
-  VkSurfaceKHR surface_;
+  VkSurfaceKHR surface_ = VK_NULL_HANDLE;
   VkQueue graphicsQueue_;
   VkQueue presentQueue_;
+  VkQueue transferQueue_;
+  VkQueue computeQueue_;
+  uint32_t graphicsFamily = 0;
+  uint32_t transferFamily = 0;
+  uint32_t computeFamily = 0;
+
+  std::unique_ptr<LveTimeline> frameTimeline;
+  std::unique_ptr<LveTimeline> transferTimeline;
+  std::unique_ptr<LveTimeline> computeTimeline;
+  std::unique_ptr<LveDeletionQueue> deletionQueue;
+
+  // built with the logical device and read only afterwards, so lookups need no lock
+  std::unordered_map<VkQueue, std::unique_ptr<std::mutex>> queueMutexes;
+  std::mutex threadCommandPoolsMutex;
+  std::unordered_map<std::thread::id, std::unique_ptr<ThreadCommandPools>> threadCommandPools;
+
+  // guards the transfer bookkeeping below and keeps transfer timeline values in submission order
+  std::mutex transferMutex;
+  std::deque<PendingTransfer> pendingTransfers;
+  // finished copies waiting for recordTransferAcquires
+  std::vector<LveTransferBatch::Acquire> readyAcquires;
+  TransferToken readyTransferToken = 0;
+  std::atomic<TransferToken> acquiredTransferToken{0};
 
   const std::vector<const char *> validationLayers = {"VK_LAYER_KHRONOS_validation"};
-  const std::vector<const char *> deviceExtensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+  std::vector<const char *> deviceExtensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
 };
 
 }  // namespace lve
@@ -0,0 +1,87 @@
+#include "lve_engine_events.hpp"
+
+#include "lve_cpu_profiler.hpp"
+
+// std
+#include <deque>
+#include <mutex>
+
+namespace lve {
+
+namespace {
+
+struct EventLog {
+  std::mutex mutex;
+  std::deque<LveEngineEvents::Event> events;
+};
+
+EventLog &eventLog() {
+  static EventLog log;
+  return log;
+}
+
+}  // namespace
+
+void LveEngineEvents::record(
+    const char *category, std::string detail, uint64_t startNs, uint64_t endNs) {
+  if (!LveCpuProfiler::isEnabled()) {
+    return;
+  }
+  auto &log = eventLog();
+  std::lock_guard<std::mutex> lock{log.mutex};
+  if (log.events.size() == MAX_EVENTS) {
+    log.events.pop_front();
+  }
+  log.events.push_back({category, std::move(detail), startNs, endNs});
+}
+
+void LveEngineEvents::record(const char *category, std::string detail) {
+  if (!LveCpuProfiler::isEnabled()) {
+    return;
+  }
+  uint64_t now = LveCpuProfiler::now();
+  record(category, std::move(detail), now, now);
+}
+
+std::vector<LveEngineEvents::Event> LveEngineEvents::between(uint64_t startNs, uint64_t endNs) {
+  auto &log = eventLog();
+  std::lock_guard<std::mutex> lock{log.mutex};
+  std::vector<Event> result;
+  for (const auto &event : log.events) {
+    if (event.endNs >= startNs && event.startNs <= endNs) {
+      result.push_back(event);
+    }
+  }
+  return result;
+}
+
+LveEngineEventScope::LveEngineEventScope(const char *category, const std::string &detail)
+    : category{category}, startNs{LveCpuProfiler::isEnabled() ? LveCpuProfiler::now() : 0} {
+  if (startNs != 0) {
+    this->detail = detail;
+  }
+}
+
+LveEngineEventScope::LveEngineEventScope(const char *category, const char *detail)
+    : category{category},
+      label{detail},
+      startNs{LveCpuProfiler::isEnabled() ? LveCpuProfiler::now() : 0} {}
+
+LveEngineEventScope::LveEngineEventScope(const char *category, const char *label, uint64_t number)
+    : category{category},
+      label{label},
+      number{number},
+      numbered{true},
+      startNs{LveCpuProfiler::isEnabled() ? LveCpuProfiler::now() : 0} {}
+
+LveEngineEventScope::~LveEngineEventScope() {
+  if (startNs == 0) {
+    return;
+  }
+  if (label != nullptr) {
+    detail = numbered ? std::string{label} + " " + std::to_string(number) : label;
+  }
+  LveEngineEvents::record(category, std::move(detail), startNs, LveCpuProfiler::now());
+}
+
+}  // namespace lve
@@ -0,0 +1,55 @@
+#pragma once
+
+// std
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace lve {
+
+// Log of rare, potentially expensive engine operations (swapchain recreation, resizes, blocking
+// transfers, allocations, pipeline creation, asset uploads). Thread safe and only recording while
+// LveCpuProfiler is enabled; events carry timestamps on its clock so they can be matched against
+// frames and zones.
+class LveEngineEvents {
+ public:
+  static constexpr size_t MAX_EVENTS = 4096;
+
+  struct Event {
+    const char *category;  // string literal
+    std::string detail;
+    uint64_t startNs;
+    uint64_t endNs;
+  };
+
+  static void record(const char *category, std::string detail, uint64_t startNs, uint64_t endNs);
+  // instantaneous event at the current time
+  static void record(const char *category, std::string detail);
+
+  // events overlapping [startNs, endNs], oldest first
+  static std::vector<Event> between(uint64_t startNs, uint64_t endNs);
+};
+
+// Records an event spanning the lifetime of the object. Nothing is copied or formatted while the
+// profiler is disabled.
+class LveEngineEventScope {
+ public:
+  LveEngineEventScope(const char *category, const std::string &detail);
+  LveEngineEventScope(const char *category, const char *detail);
+  // detail reads "<label> <number>"
+  LveEngineEventScope(const char *category, const char *label, uint64_t number);
+  ~LveEngineEventScope();
+
+  LveEngineEventScope(const LveEngineEventScope &) = delete;
+  LveEngineEventScope &operator=(const LveEngineEventScope &) = delete;
+
+ private:
+  const char *category;
+  std::string detail;
+  const char *label = nullptr;
+  uint64_t number = 0;
+  bool numbered = false;
+  uint64_t startNs;  // 0 when the profiler was disabled at construction
+};
+
+}  // namespace lve
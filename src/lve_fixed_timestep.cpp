@@ -0,0 +1,35 @@
+#include "lve_fixed_timestep.hpp"
+
+// std
+#include <cmath>
+#include <stdexcept>
+
+namespace lve {
+
+LveFixedTimestep::LveFixedTimestep(double stepsPerSecond, int maxStepsPerAdvance)
+    : step{1.0 / stepsPerSecond}, maxStepsPerAdvance{maxStepsPerAdvance} {
+  if (!(stepsPerSecond > 0.0) || maxStepsPerAdvance < 1) {
+    throw std::invalid_argument("fixed timestep needs a positive rate and step limit");
+  }
+}
+
+int LveFixedTimestep::advance(double seconds) {
+  accumulator += seconds > 0.0 ? seconds : 0.0;
+
+  int steps = 0;
+  while (accumulator >= step && steps < maxStepsPerAdvance) {
+    accumulator -= step;
+    steps++;
+  }
+  // too far behind to catch up, fall back to slow motion instead of spiraling
+  if (accumulator >= step) {
+    double remainder = std::fmod(accumulator, step);
+    droppedSeconds += accumulator - remainder;
+    accumulator = remainder;
+  }
+
+  stepCount += steps;
+  return steps;
+}
+
+}  // namespace lve
@@ -0,0 +1,35 @@
+#pragma once
+
+// std
+#include <cstdint>
+
+namespace lve {
+
+// Accumulates real frame time and hands it out as whole simulation steps of a fixed length, so
+// simulation results don't depend on the frame rate. What is left over is the interpolation
+// factor between the last two simulated states.
+class LveFixedTimestep {
+ public:
+  // maxStepsPerAdvance bounds the catch-up work after a long frame, the excess time is dropped
+  explicit LveFixedTimestep(double stepsPerSecond, int maxStepsPerAdvance = 8);
+
+  // Adds elapsed seconds and returns how many steps to simulate now
+  int advance(double seconds);
+
+  double getStep() const { return step; }
+  // steps handed out so far
+  uint64_t getStepCount() const { return stepCount; }
+  // fraction of a step accumulated past the latest one, in [0, 1)
+  float getAlpha() const { return static_cast<float>(accumulator / step); }
+  // real time dropped because a frame needed more than maxStepsPerAdvance steps
+  double getDroppedSeconds() const { return droppedSeconds; }
+
+ private:
+  double step;
+  int maxStepsPerAdvance;
+  double accumulator = 0.0;
+  double droppedSeconds = 0.0;
+  uint64_t stepCount = 0;
+};
+
+}  // namespace lve
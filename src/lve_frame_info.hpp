@@ -1,11 +1,15 @@
 #pragma once
 
 #include "lve_camera.hpp"
+#include "lve_frame_stats.hpp"
 #include "lve_game_object.hpp"
 
 // lib
 #include <vulkan/vulkan.h>
 
+// std
+#include <vector>
+
 namespace lve {
 
 #define MAX_LIGHTS 10
@@ -31,5 +35,9 @@ struct FrameInfo {
   LveCamera &camera;
   VkDescriptorSet globalDescriptorSet;
   LveGameObject::Map &gameObjects;
+  // counters of the frame being recorded, see LveRenderer::getFrameStats
+  LveFrameCounters &stats;
+  // ids of the objects that survived culling for this view, nullptr draws every object
+  const std::vector<LveGameObject::id_t> *visibleObjects = nullptr;
 };
 }  // namespace lve
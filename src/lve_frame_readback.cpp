@@ -0,0 +1,158 @@
+#include "lve_frame_readback.hpp"
+
+#include "lve_cpu_profiler.hpp"
+#include "lve_swap_chain.hpp"
+
+// std
+#include <cassert>
+#include <cstring>
+
+namespace lve {
+
+LveFrameReadback::LveFrameReadback(
+    LveDevice &device, LveImageWriter &writer, VkExtent2D extent, VkFormat colorFormat)
+    : lveDevice{device}, writer{writer}, extent{extent} {
+  assert(
+      (colorFormat == VK_FORMAT_R8G8B8A8_SRGB || colorFormat == VK_FORMAT_R8G8B8A8_UNORM ||
+       colorFormat == VK_FORMAT_B8G8R8A8_SRGB || colorFormat == VK_FORMAT_B8G8R8A8_UNORM) &&
+      "Frame readback only supports 8 bit RGBA/BGRA color formats");
+  bgra = colorFormat == VK_FORMAT_B8G8R8A8_SRGB || colorFormat == VK_FORMAT_B8G8R8A8_UNORM;
+
+  // cached memory makes the host side memcpy several times faster where it is available
+  const VkMemoryPropertyFlags cachedProperties =
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+  VkMemoryPropertyFlags memoryProperties =
+      lveDevice.hasMemoryType(cachedProperties)
+          ? cachedProperties
+          : VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+  slots.resize(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
+  for (auto &slot : slots) {
+    slot.buffer = std::make_unique<LveBuffer>(
+        lveDevice,
+        4,
+        extent.width * extent.height,
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        memoryProperties);
+    slot.buffer->map();
+  }
+}
+
+LveFrameReadback::~LveFrameReadback() {}
+
+void LveFrameReadback::recordCopy(
+    VkCommandBuffer commandBuffer,
+    int frameIndex,
+    VkImage colorImage,
+    VkImageLayout colorLayout,
+    uint64_t frameNumber) {
+  auto &slot = slots[frameIndex];
+  assert(!slot.pending && "Readback slot reused before it was collected");
+
+  VkImageMemoryBarrier toTransfer{};
+  toTransfer.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+  toTransfer.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+  toTransfer.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+  toTransfer.oldLayout = colorLayout;
+  toTransfer.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+  toTransfer.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  toTransfer.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  toTransfer.image = colorImage;
+  toTransfer.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+  vkCmdPipelineBarrier(
+      commandBuffer,
+      VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+      VK_PIPELINE_STAGE_TRANSFER_BIT,
+      0,
+      0,
+      nullptr,
+      0,
+      nullptr,
+      1,
+      &toTransfer);
+
+  VkBufferImageCopy region{};
+  region.bufferOffset = 0;
+  region.bufferRowLength = 0;
+  region.bufferImageHeight = 0;
+  region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+  region.imageOffset = {0, 0, 0};
+  region.imageExtent = {extent.width, extent.height, 1};
+  vkCmdCopyImageToBuffer(
+      commandBuffer,
+      colorImage,
+      VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+      slot.buffer->getBuffer(),
+      1,
+      &region);
+
+  if (colorLayout != VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL) {
+    VkImageMemoryBarrier restore = toTransfer;
+    restore.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    restore.dstAccessMask = 0;
+    restore.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    restore.newLayout = colorLayout;
+    vkCmdPipelineBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        0,
+        0,
+        nullptr,
+        0,
+        nullptr,
+        1,
+        &restore);
+  }
+
+  VkBufferMemoryBarrier toHost{};
+  toHost.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+  toHost.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  toHost.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+  toHost.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  toHost.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  toHost.buffer = slot.buffer->getBuffer();
+  toHost.offset = 0;
+  toHost.size = VK_WHOLE_SIZE;
+  vkCmdPipelineBarrier(
+      commandBuffer,
+      VK_PIPELINE_STAGE_TRANSFER_BIT,
+      VK_PIPELINE_STAGE_HOST_BIT,
+      0,
+      0,
+      nullptr,
+      1,
+      &toHost,
+      0,
+      nullptr);
+
+  slot.frameNumber = frameNumber;
+  slot.pending = true;
+}
+
+void LveFrameReadback::collect(int frameIndex) {
+  auto &slot = slots[frameIndex];
+  if (!slot.pending) {
+    return;
+  }
+  LVE_CPU_ZONE("LveFrameReadback::collect");
+  slot.pending = false;
+  slot.buffer->invalidate();
+
+  LveImageWriter::Image image{};
+  image.frameNumber = slot.frameNumber;
+  image.width = extent.width;
+  image.height = extent.height;
+  image.bgra = bgra;
+  image.pixels = writer.acquirePixelBuffer(static_cast<size_t>(slot.buffer->getBufferSize()));
+  std::memcpy(image.pixels.data(), slot.buffer->getMappedMemory(), image.pixels.size());
+  writer.enqueue(std::move(image));
+}
+
+void LveFrameReadback::collectAll() {
+  for (int i = 0; i < slots.size(); i++) {
+    collect(i);
+  }
+}
+
+}  // namespace lve
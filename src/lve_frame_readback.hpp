@@ -0,0 +1,51 @@
+#pragma once
+
+#include "lve_buffer.hpp"
+#include "lve_device.hpp"
+#include "lve_image_writer.hpp"
+
+// std
+#include <memory>
+#include <vector>
+
+namespace lve {
+
+// Copies the final color image of each frame into a ring of host visible buffers, one slot per
+// frame in flight. A slot is only read once the frame timeline passed its frame (i.e.
+// MAX_FRAMES_IN_FLIGHT frames later), so capturing never stalls the GPU.
+class LveFrameReadback {
+ public:
+  LveFrameReadback(
+      LveDevice &device, LveImageWriter &writer, VkExtent2D extent, VkFormat colorFormat);
+  ~LveFrameReadback();
+
+  LveFrameReadback(const LveFrameReadback &) = delete;
+  LveFrameReadback &operator=(const LveFrameReadback &) = delete;
+
+  // Records the copy into the frame's command buffer, after the render pass has ended
+  void recordCopy(
+      VkCommandBuffer commandBuffer,
+      int frameIndex,
+      VkImage colorImage,
+      VkImageLayout colorLayout,
+      uint64_t frameNumber);
+  // Must only be called once the frame that last used frameIndex has retired
+  void collect(int frameIndex);
+  // Must only be called once the device is idle
+  void collectAll();
+
+ private:
+  struct Slot {
+    std::unique_ptr<LveBuffer> buffer;
+    uint64_t frameNumber = 0;
+    bool pending = false;
+  };
+
+  LveDevice &lveDevice;
+  LveImageWriter &writer;
+  VkExtent2D extent;
+  bool bgra;
+  std::vector<Slot> slots;
+};
+
+}  // namespace lve
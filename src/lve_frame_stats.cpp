@@ -0,0 +1,90 @@
+#include "lve_frame_stats.hpp"
+
+// std
+#include <cassert>
+#include <cstdio>
+
+namespace lve {
+
+const char *LveFrameCounters::name(size_t index) {
+  static constexpr std::array<const char *, COUNT> names = {
+      "drawCalls",
+      "instances",
+      "triangles",
+      "indices",
+      "pipelineBinds",
+      "descriptorBinds",
+      "pushConstantBytes",
+      "bufferUploads",
+      "bufferUploadBytes",
+      "culledObjects"};
+  assert(index < COUNT && "Frame counter index out of range");
+  return names[index];
+}
+
+double LveFrameCounters::value(size_t index) const {
+  switch (index) {
+    case 0:
+      return drawCalls;
+    case 1:
+      return instances;
+    case 2:
+      return static_cast<double>(triangles);
+    case 3:
+      return static_cast<double>(indices);
+    case 4:
+      return pipelineBinds;
+    case 5:
+      return descriptorBinds;
+    case 6:
+      return static_cast<double>(pushConstantBytes);
+    case 7:
+      return bufferUploads;
+    case 8:
+      return static_cast<double>(bufferUploadBytes);
+    case 9:
+      return culledObjects;
+  }
+  assert(false && "Frame counter index out of range");
+  return 0.0;
+}
+
+LveFrameStats::LveFrameStats(size_t historySize) { history.fill(LveRollingStats{historySize}); }
+
+void LveFrameStats::endFrame() {
+  lastFrame = current;
+  for (size_t i = 0; i < LveFrameCounters::COUNT; i++) {
+    history[i].add(current.value(i));
+  }
+  frameCount++;
+}
+
+void LveFrameStats::logReport(std::ostream &out) const {
+  char line[160];
+  std::snprintf(
+      line,
+      sizeof(line),
+      "%-20s %12s %12s %12s %12s  (last %zu frames)\n",
+      "counter",
+      "last",
+      "mean",
+      "p95",
+      "max",
+      history[0].count());
+  out << line;
+  for (size_t i = 0; i < LveFrameCounters::COUNT; i++) {
+    auto summary = history[i].summarize();
+    std::snprintf(
+        line,
+        sizeof(line),
+        "%-20s %12.0f %12.1f %12.0f %12.0f\n",
+        LveFrameCounters::name(i),
+        lastFrame.value(i),
+        summary.mean,
+        summary.p95,
+        summary.max);
+    out << line;
+  }
+}
+
+}  // namespace lve
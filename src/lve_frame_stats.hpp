@@ -0,0 +1,70 @@
+#pragma once
+
+#include "lve_stats.hpp"
+
+// std
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace lve {
+
+// Work recorded into a single frame, filled in by the render systems while they record
+struct LveFrameCounters {
+  static constexpr size_t COUNT = 10;
+
+  uint32_t drawCalls = 0;
+  uint32_t instances = 0;
+  uint64_t triangles = 0;
+  // vertex shader inputs submitted: indices of indexed draws, vertices of the others. Vertices
+  // shared between triangles count once per reference.
+  uint64_t indices = 0;
+  uint32_t pipelineBinds = 0;
+  uint32_t descriptorBinds = 0;
+  uint64_t pushConstantBytes = 0;
+  uint32_t bufferUploads = 0;
+  uint64_t bufferUploadBytes = 0;
+  uint32_t culledObjects = 0;
+
+  // indexCount is the number of indices (or vertices of a non indexed draw) per instance
+  void recordDraw(uint32_t indexCount, uint32_t instanceCount = 1) {
+    drawCalls++;
+    instances += instanceCount;
+    indices += static_cast<uint64_t>(indexCount) * instanceCount;
+    triangles += static_cast<uint64_t>(indexCount / 3) * instanceCount;
+  }
+  void recordUpload(uint64_t bytes) {
+    bufferUploads++;
+    bufferUploadBytes += bytes;
+  }
+
+  // every counter by index, in declaration order, for generic reporting
+  static const char *name(size_t index);
+  double value(size_t index) const;
+};
+
+// Owned by LveRenderer: collects the counters of the frame being recorded and keeps rolling
+// windows of completed frames so workload changes can be lined up with frame time changes.
+class LveFrameStats {
+ public:
+  explicit LveFrameStats(size_t historySize = 240);
+
+  void beginFrame() { current = LveFrameCounters{}; }
+  void endFrame();
+
+  LveFrameCounters &getCurrent() { return current; }
+  const LveFrameCounters &getLastFrame() const { return lastFrame; }
+  const LveRollingStats &getHistory(size_t counterIndex) const { return history[counterIndex]; }
+  uint64_t getFrameCount() const { return frameCount; }
+
+  void logReport(std::ostream &out) const;
+
+ private:
+  LveFrameCounters current{};
+  LveFrameCounters lastFrame{};
+  std::array<LveRollingStats, LveFrameCounters::COUNT> history;
+  uint64_t frameCount = 0;
+};
+
+}  // namespace lve
@@ -0,0 +1,66 @@
+#include "lve_frustum.hpp"
+
+namespace lve {
+
+LveFrustum::LveFrustum(const glm::mat4 &viewProjection) {
+  // Gribb/Hartmann plane extraction, using a [0, 1] depth range for the near plane
+  const glm::mat4 m = glm::transpose(viewProjection);
+  planes[0] = m[3] + m[0];  // left
+  planes[1] = m[3] - m[0];  // right
+  planes[2] = m[3] + m[1];  // top (vulkan y points down)
+  planes[3] = m[3] - m[1];  // bottom
+  planes[4] = m[2];         // near
+  planes[5] = m[3] - m[2];  // far
+
+  for (auto &plane : planes) {
+    plane /= glm::length(glm::vec3(plane));
+  }
+}
+
+LveFrustum LveFrustum::fromCamera(const LveCamera &camera) {
+  return LveFrustum{camera.getProjection() * camera.getView()};
+}
+
+bool LveFrustum::intersectsSphere(const glm::vec3 &center, float radius) const {
+  for (const auto &plane : planes) {
+    if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool LveFrustum::intersectsAabb(const glm::vec3 &min, const glm::vec3 &max) const {
+  for (const auto &plane : planes) {
+    // the corner furthest along the plane normal decides whether the box is fully outside
+    glm::vec3 corner{
+        plane.x > 0.f ? max.x : min.x,
+        plane.y > 0.f ? max.y : min.y,
+        plane.z > 0.f ? max.z : min.z};
+    if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.f) {
+      return false;
+    }
+  }
+  return true;
+}
+
+LveBoundingSphere computeWorldBounds(LveGameObject &gameObject) {
+  LveBoundingSphere sphere{};
+  if (gameObject.model == nullptr) {
+    sphere.center = gameObject.getWorldPosition();
+    return sphere;
+  }
+
+  const glm::mat4 &transform = gameObject.worldMatrix;
+  float maxScale = glm::sqrt(glm::max(
+      glm::dot(glm::vec3{transform[0]}, glm::vec3{transform[0]}),
+      glm::max(
+          glm::dot(glm::vec3{transform[1]}, glm::vec3{transform[1]}),
+          glm::dot(glm::vec3{transform[2]}, glm::vec3{transform[2]}))));
+  glm::vec4 localCenter{gameObject.model->getBoundingCenter(), 1.f};
+  sphere.center = glm::vec3(transform * localCenter);
+  sphere.radius = gameObject.model->getBoundingRadius() * maxScale;
+  return sphere;
+}
+
+}  // namespace lve
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "lve_camera.hpp"
+#include "lve_game_object.hpp"
+
+// libs
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+// std
+#include <array>
+#include <vector>
+
+namespace lve {
+
+struct LveBoundingSphere {
+  glm::vec3 center{0.f};
+  float radius{0.f};
+};
+
+class LveFrustum {
+ public:
+  LveFrustum() = default;
+  explicit LveFrustum(const glm::mat4 &viewProjection);
+  static LveFrustum fromCamera(const LveCamera &camera);
+
+  bool intersectsSphere(const glm::vec3 &center, float radius) const;
+  bool intersectsSphere(const LveBoundingSphere &sphere) const {
+    return intersectsSphere(sphere.center, sphere.radius);
+  }
+  // conservative: boxes near a frustum corner may pass without intersecting it
+  bool intersectsAabb(const glm::vec3 &min, const glm::vec3 &max) const;
+
+  // left, right, top, bottom, near, far as (normal, distance), for culling on the GPU
+  const std::array<glm::vec4, 6> &getPlanes() const { return planes; }
+
+ private:
+  // normalized planes as (normal, distance), normals point into the frustum
+  std::array<glm::vec4, 6> planes{};
+};
+
+// World space bounding sphere of a game object's model, radius is 0 for objects without a model
+LveBoundingSphere computeWorldBounds(LveGameObject &gameObject);
+
+}  // namespace lve
@@ -1,5 +1,11 @@
 #include "lve_game_object.hpp"
 
+// libs
+#include <glm/gtc/constants.hpp>
+
+// std
+#include <cmath>
+
 namespace lve {
 
 glm::mat4 TransformComponent::mat4() {
@@ -59,6 +65,18 @@ glm::mat3 TransformComponent::normalMatrix() {
   };
 }
 
+TransformComponent TransformComponent::interpolate(
+    const TransformComponent &from, const TransformComponent &to, float alpha) {
+  TransformComponent result{};
+  result.translation = glm::mix(from.translation, to.translation, alpha);
+  result.scale = glm::mix(from.scale, to.scale, alpha);
+  for (int i = 0; i < 3; i++) {
+    float delta = std::remainder(to.rotation[i] - from.rotation[i], glm::two_pi<float>());
+    result.rotation[i] = from.rotation[i] + delta * alpha;
+  }
+  return result;
+}
+
 LveGameObject LveGameObject::makePointLight(float intensity, float radius, glm::vec3 color) {
   LveGameObject gameObj = LveGameObject::createGameObject();
   gameObj.color = color;
@@ -68,4 +86,18 @@ LveGameObject LveGameObject::makePointLight(float intensity, float radius, glm::
   return gameObj;
 }
 
+LveGameObject LveGameObject::clone() const {
+  LveGameObject copy{id};
+  copy.color = color;
+  copy.transform = transform;
+  copy.isStatic = isStatic;
+  copy.worldMatrix = worldMatrix;
+  copy.worldNormalMatrix = worldNormalMatrix;
+  copy.model = model;
+  if (pointLight) {
+    copy.pointLight = std::make_unique<PointLightComponent>(*pointLight);
+  }
+  return copy;
+}
+
 }  // namespace lve
\ No newline at end of file
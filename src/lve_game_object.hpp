@@ -22,6 +22,10 @@ struct TransformComponent {
   glm::mat4 mat4();
 
   glm::mat3 normalMatrix();
+
+  // blends translation and scale linearly and every rotation angle the short way round
+  static TransformComponent interpolate(
+      const TransformComponent &from, const TransformComponent &to, float alpha);
 };
 
 struct PointLightComponent {
@@ -46,10 +50,21 @@ class LveGameObject {
   LveGameObject(LveGameObject &&) = default;
   LveGameObject &operator=(LveGameObject &&) = default;
 
+  // copy sharing the id and model, e.g. for a render snapshot
+  LveGameObject clone() const;
+
   id_t getId() { return id; }
 
   glm::vec3 color{};
   TransformComponent transform{};
+  // static objects never move, systems that animate the scene skip them
+  bool isStatic = false;
+  // transform composed with those of the object's ancestors, resolved by LveTransformHierarchy.
+  // Render systems read these instead of transform.
+  glm::mat4 worldMatrix{1.f};
+  glm::mat3 worldNormalMatrix{1.f};
+
+  glm::vec3 getWorldPosition() const { return glm::vec3{worldMatrix[3]}; }
 
   // Optional pointer components
   std::shared_ptr<LveModel> model{};
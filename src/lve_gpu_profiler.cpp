@@ -0,0 +1,242 @@
+#include "lve_gpu_profiler.hpp"
+
+// std
+#include <cassert>
+#include <cstdio>
+#include <stdexcept>
+
+namespace lve {
+
+LveGpuProfiler::LveGpuProfiler(LveDevice &device, int framesInFlight, size_t historySize)
+    : lveDevice{device}, historySize{historySize} {
+  VkPhysicalDevice physicalDevice = lveDevice.getPhysicalDevice();
+  uint32_t queueFamilyCount = 0;
+  vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+  std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+  vkGetPhysicalDeviceQueueFamilyProperties(
+      physicalDevice,
+      &queueFamilyCount,
+      queueFamilies.data());
+
+  uint32_t validBits =
+      queueFamilies[lveDevice.findPhysicalQueueFamilies().graphicsFamily].timestampValidBits;
+  supported = validBits > 0 && lveDevice.properties.limits.timestampPeriod > 0.f;
+  if (!supported) {
+    return;
+  }
+  timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+  timestampPeriodMs = static_cast<double>(lveDevice.properties.limits.timestampPeriod) * 1e-6;
+
+  frames.resize(framesInFlight);
+  for (auto &frame : frames) {
+    VkQueryPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    poolInfo.queryCount = MAX_ZONES_PER_FRAME * 2;
+    if (vkCreateQueryPool(lveDevice.device(), &poolInfo, nullptr, &frame.queryPool) !=
+        VK_SUCCESS) {
+      throw std::runtime_error("failed to create timestamp query pool!");
+    }
+    frame.zones.reserve(MAX_ZONES_PER_FRAME);
+  }
+  timestamps.resize(MAX_ZONES_PER_FRAME * 2);
+}
+
+LveGpuProfiler::~LveGpuProfiler() {
+  for (auto &frame : frames) {
+    vkDestroyQueryPool(lveDevice.device(), frame.queryPool, nullptr);
+  }
+}
+
+void LveGpuProfiler::beginFrame(
+    VkCommandBuffer commandBuffer, int frameIndex, uint64_t frameNumber) {
+  assert(currentFrame == nullptr && "GPU profiler frame already in progress");
+  if (!supported) {
+    return;
+  }
+
+  auto &frame = frames[frameIndex];
+  collect(frame);
+  frame.zones.clear();
+  if (!enabled) {
+    return;
+  }
+
+  vkCmdResetQueryPool(commandBuffer, frame.queryPool, 0, MAX_ZONES_PER_FRAME * 2);
+  frame.frameNumber = frameNumber;
+  currentFrame = &frame;
+}
+
+void LveGpuProfiler::endFrame() {
+  assert(openZones.empty() && "All GPU zones must be closed before the frame ends");
+  currentFrame = nullptr;
+}
+
+int LveGpuProfiler::beginZone(VkCommandBuffer commandBuffer, const char *name) {
+  if (currentFrame == nullptr || currentFrame->zones.size() == MAX_ZONES_PER_FRAME) {
+    return -1;
+  }
+
+  int zone = static_cast<int>(currentFrame->zones.size());
+  currentFrame->zones.push_back({name, static_cast<int>(openZones.size()), false});
+  openZones.push_back(zone);
+  vkCmdWriteTimestamp(
+      commandBuffer,
+      VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+      currentFrame->queryPool,
+      zone * 2);
+  return zone;
+}
+
+void LveGpuProfiler::endZone(VkCommandBuffer commandBuffer, int zone) {
+  if (zone < 0) {
+    return;
+  }
+  assert(!openZones.empty() && openZones.back() == zone && "GPU zones must nest");
+
+  openZones.pop_back();
+  currentFrame->zones[zone].closed = true;
+  vkCmdWriteTimestamp(
+      commandBuffer,
+      VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+      currentFrame->queryPool,
+      zone * 2 + 1);
+}
+
+void LveGpuProfiler::resetStats(size_t historySize) {
+  assert(currentFrame == nullptr && "Can't reset GPU profiler while a frame is in progress");
+  this->historySize = historySize;
+  history.clear();
+  historyIndex.clear();
+  for (auto &frame : frames) {
+    frame.zones.clear();
+  }
+}
+
+void LveGpuProfiler::collectAll() {
+  assert(currentFrame == nullptr && "Can't collect GPU profiler while a frame is in progress");
+  for (auto &frame : frames) {
+    collect(frame);
+    frame.zones.clear();
+  }
+}
+
+void LveGpuProfiler::collect(FrameQueries &frame) {
+  if (frame.zones.empty()) {
+    return;
+  }
+
+  uint32_t queryCount = static_cast<uint32_t>(frame.zones.size() * 2);
+  auto result = vkGetQueryPoolResults(
+      lveDevice.device(),
+      frame.queryPool,
+      0,
+      queryCount,
+      queryCount * sizeof(uint64_t),
+      timestamps.data(),
+      sizeof(uint64_t),
+      VK_QUERY_RESULT_64_BIT);
+  if (result != VK_SUCCESS) {
+    return;  // drop the frame rather than stall on it
+  }
+
+  frameTimings.clear();
+  std::vector<const std::string *> parents;
+  for (size_t i = 0; i < frame.zones.size(); i++) {
+    const auto &zone = frame.zones[i];
+    if (!zone.closed) {
+      continue;
+    }
+
+    parents.resize(zone.depth);
+    std::string path = zone.depth > 0 && parents.back() != nullptr
+                           ? *parents.back() + "/" + zone.name
+                           : std::string{zone.name};
+
+    auto it = historyIndex.find(path);
+    if (it == historyIndex.end()) {
+      it = historyIndex.emplace(path, history.size()).first;
+      history.push_back({path, zone.name, zone.depth, LveRollingStats{historySize}});
+    }
+    parents.push_back(&it->first);
+
+    uint64_t ticks = (timestamps[i * 2 + 1] - timestamps[i * 2]) & timestampMask;
+    double milliseconds = static_cast<double>(ticks) * timestampPeriodMs;
+    history[it->second].milliseconds.add(milliseconds);
+    if (frameListener) {
+      frameTimings.push_back({path, zone.depth, milliseconds});
+    }
+  }
+
+  if (frameListener) {
+    frameListener(frame.frameNumber, frameTimings);
+  }
+}
+
+std::vector<LveGpuProfiler::ZoneReport> LveGpuProfiler::getReport() const {
+  std::vector<ZoneReport> report;
+  report.reserve(history.size());
+  for (const auto &zone : history) {
+    report.push_back({zone.path, zone.name, zone.depth, zone.milliseconds.summarize()});
+  }
+  return report;
+}
+
+const LveRollingStats *LveGpuProfiler::findZone(const std::string &path) const {
+  auto it = historyIndex.find(path);
+  return it == historyIndex.end() ? nullptr : &history[it->second].milliseconds;
+}
+
+void LveGpuProfiler::logReport(std::ostream &out) const {
+  if (!supported) {
+    out << "GPU profiler: timestamps not supported on the graphics queue\n";
+    return;
+  }
+
+  char line[160];
+  std::snprintf(
+      line,
+      sizeof(line),
+      "%-32s %8s %8s %8s %8s %8s  (GPU ms)\n",
+      "zone",
+      "mean",
+      "p50",
+      "p95",
+      "p99",
+      "max");
+  out << line;
+  for (const auto &zone : getReport()) {
+    std::string name = std::string(zone.depth * 2, ' ') + zone.name;
+    const auto &ms = zone.milliseconds;
+    std::snprintf(
+        line,
+        sizeof(line),
+        "%-32s %8.3f %8.3f %8.3f %8.3f %8.3f\n",
+        name.c_str(),
+        ms.mean,
+        ms.p50,
+        ms.p95,
+        ms.p99,
+        ms.max);
+    out << line;
+  }
+}
+
+std::string LveGpuProfiler::overlayText() const {
+  std::string text = "GPU";
+  char entry[96];
+  for (const auto &zone : history) {
+    // the renderer's frame zone and the render systems recorded inside it
+    if (zone.depth > 1) continue;
+    std::snprintf(
+        entry,
+        sizeof(entry),
+        " | %s %.2fms",
+        zone.name.c_str(),
+        zone.milliseconds.mean());
+    text += entry;
+  }
+  return text;
+}
+
+}  // namespace lve
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "lve_device.hpp"
+#include "lve_stats.hpp"
+
+// vulkan headers
+#include <vulkan/vulkan.h>
+
+// std
+#include <functional>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lve {
+
+// Measures GPU time of named, nestable zones with timestamp queries. Every frame in flight owns a
+// query pool; its results are read back the next time that frame slot begins, at which point the
+// frame timeline has passed its frame, so reading never stalls the CPU.
+class LveGpuProfiler {
+ public:
+  static constexpr uint32_t MAX_ZONES_PER_FRAME = 64;
+
+  struct ZoneReport {
+    std::string path;
+    std::string name;
+    int depth;
+    LveRollingStats::Summary milliseconds;
+  };
+
+  struct ZoneTiming {
+    std::string path;
+    int depth;
+    double milliseconds;
+  };
+  // receives the zones of a single frame once its results have been read back
+  using FrameListener =
+      std::function<void(uint64_t frameNumber, const std::vector<ZoneTiming> &zones)>;
+
+  LveGpuProfiler(LveDevice &device, int framesInFlight, size_t historySize = 240);
+  ~LveGpuProfiler();
+
+  LveGpuProfiler(const LveGpuProfiler &) = delete;
+  LveGpuProfiler &operator=(const LveGpuProfiler &) = delete;
+
+  bool isSupported() const { return supported; }
+  bool isEnabled() const { return supported && enabled; }
+  void setEnabled(bool enable) { enabled = enable; }
+  void setFrameListener(FrameListener listener) { frameListener = std::move(listener); }
+
+  // Collects the results of the previous use of this frame slot and resets its queries. Must be
+  // recorded outside a render pass, after the slot's previous frame retired.
+  void beginFrame(VkCommandBuffer commandBuffer, int frameIndex, uint64_t frameNumber);
+  void endFrame();
+
+  // name must stay valid for the lifetime of the profiler, e.g. a string literal.
+  // Returns a handle for endZone, or -1 when the zone is not being measured.
+  int beginZone(VkCommandBuffer commandBuffer, const char *name);
+  void endZone(VkCommandBuffer commandBuffer, int zone);
+
+  // Drops all statistics and any results still in flight, later samples are kept in windows of
+  // historySize frames
+  void resetStats(size_t historySize);
+  // Reads every outstanding result, only valid while the device is idle
+  void collectAll();
+
+  // zones in the order they were first seen, which is their nesting order for a stable frame
+  std::vector<ZoneReport> getReport() const;
+  // rolling GPU milliseconds of the zone at path, e.g. "frame/SimpleRenderSystem"
+  const LveRollingStats *findZone(const std::string &path) const;
+  void logReport(std::ostream &out) const;
+  // compact single line summary of the frame zone and the passes directly inside it (depth 0 and
+  // 1), suitable for a window title
+  std::string overlayText() const;
+
+ private:
+  struct Zone {
+    const char *name;
+    int depth;
+    bool closed;
+  };
+
+  struct FrameQueries {
+    VkQueryPool queryPool = VK_NULL_HANDLE;
+    uint64_t frameNumber = 0;
+    std::vector<Zone> zones{};
+  };
+
+  struct ZoneHistory {
+    std::string path;
+    std::string name;
+    int depth;
+    LveRollingStats milliseconds;
+  };
+
+  void collect(FrameQueries &frame);
+
+  LveDevice &lveDevice;
+  bool supported = false;
+  bool enabled = true;
+  double timestampPeriodMs = 0.0;
+  uint64_t timestampMask = ~0ull;
+  size_t historySize;
+
+  std::vector<FrameQueries> frames;
+  FrameQueries *currentFrame = nullptr;
+  std::vector<int> openZones;
+  std::vector<uint64_t> timestamps;
+  FrameListener frameListener{};
+  std::vector<ZoneTiming> frameTimings;
+
+  std::vector<ZoneHistory> history;
+  std::unordered_map<std::string, size_t> historyIndex;
+};
+
+// Scoped helper that records a GPU zone for the lifetime of the object
+class LveGpuZone {
+ public:
+  LveGpuZone(LveGpuProfiler &profiler, VkCommandBuffer commandBuffer, const char *name)
+      : profiler{profiler}, commandBuffer{commandBuffer} {
+    zone = profiler.beginZone(commandBuffer, name);
+  }
+  ~LveGpuZone() { profiler.endZone(commandBuffer, zone); }
+
+  LveGpuZone(const LveGpuZone &) = delete;
+  LveGpuZone &operator=(const LveGpuZone &) = delete;
+
+ private:
+  LveGpuProfiler &profiler;
+  VkCommandBuffer commandBuffer;
+  int zone;
+};
+
+}  // namespace lve
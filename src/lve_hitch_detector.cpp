@@ -0,0 +1,169 @@
+#include "lve_hitch_detector.hpp"
+
+#include "lve_cpu_profiler.hpp"
+#include "lve_engine_events.hpp"
+#include "lve_swap_chain.hpp"
+
+// std
+#include <algorithm>
+#include <cstdio>
+#include <map>
+
+namespace lve {
+
+namespace {
+
+// how many frames after a hitch its GPU timings may still show up
+constexpr uint64_t GPU_RESULT_LATENCY = LveSwapChain::MAX_FRAMES_IN_FLIGHT * 2;
+constexpr size_t MAX_ZONES_LISTED = 16;
+
+}  // namespace
+
+LveHitchDetector::LveHitchDetector(
+    std::ostream &log, LveGpuProfiler &gpuProfiler, const Config &config)
+    : log{log}, gpuProfiler{gpuProfiler}, config{config}, frameMs{config.historySize} {
+  gpuProfiler.setFrameListener(
+      [this](uint64_t frameNumber, const std::vector<LveGpuProfiler::ZoneTiming> &zones) {
+        onGpuFrame(frameNumber, zones);
+      });
+}
+
+LveHitchDetector::~LveHitchDetector() {
+  gpuProfiler.setFrameListener(nullptr);
+  flush();
+}
+
+void LveHitchDetector::beginFrame(uint64_t frameNumber) {
+  currentFrameNumber = frameNumber;
+  frameStartNs = LveCpuProfiler::now();
+}
+
+void LveHitchDetector::endFrame() {
+  uint64_t frameEndNs = LveCpuProfiler::now();
+  double ms = static_cast<double>(frameEndNs - frameStartNs) * 1e-6;
+
+  double medianMs = frameMs.percentile(50.0);
+  bool isHitch = frameMs.count() >= config.warmupFrames &&
+                 ms > medianMs * config.thresholdFactor &&
+                 ms - medianMs > config.minimumExcessMs;
+  frameMs.add(ms);
+  if (!isHitch) {
+    return;
+  }
+
+  hitchCount++;
+  PendingReport report{currentFrameNumber, describeFrame(frameStartNs, frameEndNs, ms, medianMs)};
+  if (gpuProfiler.isEnabled()) {
+    pending.push_back(std::move(report));
+  } else {
+    log << report.text << std::flush;
+  }
+}
+
+void LveHitchDetector::flush() {
+  for (auto &report : pending) {
+    log << report.text << "  gpu passes: not available\n";
+  }
+  log << std::flush;
+  pending.clear();
+}
+
+void LveHitchDetector::onGpuFrame(
+    uint64_t frameNumber, const std::vector<LveGpuProfiler::ZoneTiming> &zones) {
+  char line[160];
+  while (!pending.empty() && pending.front().frameNumber <= frameNumber) {
+    auto &report = pending.front();
+    log << report.text;
+    if (report.frameNumber == frameNumber) {
+      log << "  gpu passes:\n";
+      for (const auto &zone : zones) {
+        std::string name = std::string(zone.depth * 2, ' ') + zone.path.substr(
+                                                                   zone.path.rfind('/') + 1);
+        std::snprintf(line, sizeof(line), "    %-34s %9.3fms\n", name.c_str(), zone.milliseconds);
+        log << line;
+      }
+    } else {
+      log << "  gpu passes: not recorded for this frame\n";
+    }
+    pending.pop_front();
+  }
+
+  // results of a frame can be dropped (profiler disabled, readback failed), don't wait forever
+  while (!pending.empty() && pending.front().frameNumber + GPU_RESULT_LATENCY < frameNumber) {
+    log << pending.front().text << "  gpu passes: not available\n";
+    pending.pop_front();
+  }
+  log << std::flush;
+}
+
+std::string LveHitchDetector::describeFrame(
+    uint64_t startNs, uint64_t endNs, double frameMs, double medianMs) {
+  char line[192];
+  std::string text;
+  std::snprintf(
+      line,
+      sizeof(line),
+      "hitch: frame %llu took %.2fms (median %.2fms, %.1fx)\n",
+      static_cast<unsigned long long>(currentFrameNumber),
+      frameMs,
+      medianMs,
+      medianMs > 0.0 ? frameMs / medianMs : 0.0);
+  text += line;
+
+  // time spent per zone within the frame, zones crossing the frame boundary are clipped
+  std::map<std::pair<uint32_t, std::string>, std::pair<double, int>> zoneTotals;
+  for (const auto &zone : LveCpuProfiler::collectZones(startNs, endNs)) {
+    uint64_t clippedStart = std::max(zone.startNs, startNs);
+    uint64_t clippedEnd = std::min(zone.endNs, endNs);
+    auto &total = zoneTotals[{zone.threadId, zone.name}];
+    total.first += static_cast<double>(clippedEnd - clippedStart) * 1e-6;
+    total.second++;
+  }
+  if (zoneTotals.empty()) {
+    text += "  cpu zones: none recorded (enable the CPU profiler)\n";
+  } else {
+    std::vector<std::pair<std::pair<uint32_t, std::string>, std::pair<double, int>>> sorted(
+        zoneTotals.begin(),
+        zoneTotals.end());
+    std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) {
+      return a.second.first > b.second.first;
+    });
+    text += "  cpu zones:\n";
+    for (size_t i = 0; i < sorted.size() && i < MAX_ZONES_LISTED; i++) {
+      const auto &[key, total] = sorted[i];
+      std::snprintf(
+          line,
+          sizeof(line),
+          "    [thread %u] %-40s %9.3fms (%dx)\n",
+          key.first,
+          key.second.c_str(),
+          total.first,
+          total.second);
+      text += line;
+    }
+  }
+
+  auto events = LveEngineEvents::between(startNs, endNs);
+  if (events.empty()) {
+    text += "  engine events: none\n";
+  } else {
+    text += "  engine events:\n";
+    for (const auto &event : events) {
+      double offsetMs =
+          (static_cast<double>(event.startNs) - static_cast<double>(startNs)) * 1e-6;
+      double durationMs = static_cast<double>(event.endNs - event.startNs) * 1e-6;
+      std::snprintf(
+          line,
+          sizeof(line),
+          "    %+9.3fms %s %s (%.3fms)\n",
+          offsetMs,
+          event.category,
+          event.detail.c_str(),
+          durationMs);
+      text += line;
+    }
+  }
+  return text;
+}
+
+}  // namespace lve
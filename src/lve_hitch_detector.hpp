@@ -0,0 +1,65 @@
+#pragma once
+
+#include "lve_gpu_profiler.hpp"
+#include "lve_stats.hpp"
+
+// std
+#include <cstdint>
+#include <deque>
+#include <ostream>
+#include <string>
+
+namespace lve {
+
+// Flags frames that take much longer than the recent median and logs what happened in them: the
+// CPU zones recorded during the frame (LveCpuProfiler must be enabled), engine events such as
+// swapchain recreation or blocking uploads, and the frame's GPU pass timings. GPU results arrive
+// a few frames late, so a report is held back until they are read back.
+class LveHitchDetector {
+ public:
+  struct Config {
+    // a frame is a hitch when it takes thresholdFactor times the rolling median
+    double thresholdFactor = 3.0;
+    // and at least this much longer, so tiny medians don't flag scheduler noise
+    double minimumExcessMs = 2.0;
+    size_t historySize = 120;
+    // frames needed before the median is trusted
+    size_t warmupFrames = 30;
+  };
+
+  LveHitchDetector(std::ostream &log, LveGpuProfiler &gpuProfiler, const Config &config);
+  ~LveHitchDetector();
+
+  LveHitchDetector(const LveHitchDetector &) = delete;
+  LveHitchDetector &operator=(const LveHitchDetector &) = delete;
+
+  // frameNumber must match the one the renderer passes to the GPU profiler for this frame. A
+  // frame that is never submitted is dropped by calling beginFrame again without endFrame.
+  void beginFrame(uint64_t frameNumber);
+  void endFrame();
+  // writes reports still waiting for GPU timings
+  void flush();
+
+  uint64_t getHitchCount() const { return hitchCount; }
+
+ private:
+  struct PendingReport {
+    uint64_t frameNumber;
+    std::string text;
+  };
+
+  void onGpuFrame(uint64_t frameNumber, const std::vector<LveGpuProfiler::ZoneTiming> &zones);
+  std::string describeFrame(uint64_t startNs, uint64_t endNs, double frameMs, double medianMs);
+
+  std::ostream &log;
+  LveGpuProfiler &gpuProfiler;
+  Config config;
+
+  LveRollingStats frameMs;
+  uint64_t currentFrameNumber = 0;
+  uint64_t frameStartNs = 0;
+  std::deque<PendingReport> pending;
+  uint64_t hitchCount = 0;
+};
+
+}  // namespace lve
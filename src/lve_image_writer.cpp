@@ -0,0 +1,248 @@
+#include "lve_image_writer.hpp"
+
+#include "lve_cpu_profiler.hpp"
+
+// std
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace lve {
+
+namespace {
+
+// *************** PNG helpers *********************
+// Minimal encoder using stored (uncompressed) deflate blocks, which keeps the engine free of a zlib
+// dependency. Files are larger than a real encoder would produce but encoding is memcpy speed.
+
+const std::array<uint32_t, 256> &crcTable() {
+  static const std::array<uint32_t, 256> table = [] {
+    std::array<uint32_t, 256> t{};
+    for (uint32_t n = 0; n < 256; n++) {
+      uint32_t c = n;
+      for (int k = 0; k < 8; k++) {
+        c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+      }
+      t[n] = c;
+    }
+    return t;
+  }();
+  return table;
+}
+
+uint32_t updateCrc(uint32_t crc, const uint8_t *data, size_t size) {
+  const auto &table = crcTable();
+  for (size_t i = 0; i < size; i++) {
+    crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+  }
+  return crc;
+}
+
+void appendBigEndian(std::vector<uint8_t> &out, uint32_t value) {
+  out.push_back(static_cast<uint8_t>(value >> 24));
+  out.push_back(static_cast<uint8_t>(value >> 16));
+  out.push_back(static_cast<uint8_t>(value >> 8));
+  out.push_back(static_cast<uint8_t>(value));
+}
+
+void writeChunk(std::ofstream &file, const char *type, const std::vector<uint8_t> &data) {
+  std::vector<uint8_t> header;
+  appendBigEndian(header, static_cast<uint32_t>(data.size()));
+  header.insert(header.end(), type, type + 4);
+  file.write(reinterpret_cast<const char *>(header.data()), header.size());
+  file.write(reinterpret_cast<const char *>(data.data()), data.size());
+
+  uint32_t crc = updateCrc(0xffffffffu, reinterpret_cast<const uint8_t *>(type), 4);
+  crc = updateCrc(crc, data.data(), data.size()) ^ 0xffffffffu;
+  std::vector<uint8_t> footer;
+  appendBigEndian(footer, crc);
+  file.write(reinterpret_cast<const char *>(footer.data()), footer.size());
+}
+
+void writePng(std::ofstream &file, const LveImageWriter::Image &image) {
+  static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+  file.write(reinterpret_cast<const char *>(signature), sizeof(signature));
+
+  std::vector<uint8_t> ihdr;
+  appendBigEndian(ihdr, image.width);
+  appendBigEndian(ihdr, image.height);
+  ihdr.push_back(8);  // bit depth
+  ihdr.push_back(6);  // color type RGBA
+  ihdr.push_back(0);  // compression
+  ihdr.push_back(0);  // filter
+  ihdr.push_back(0);  // interlace
+  writeChunk(file, "IHDR", ihdr);
+
+  // filtered scanlines: one filter byte (none) followed by the RGBA row
+  const size_t rowSize = static_cast<size_t>(image.width) * 4;
+  std::vector<uint8_t> raw((rowSize + 1) * image.height);
+  for (uint32_t y = 0; y < image.height; y++) {
+    uint8_t *dst = &raw[y * (rowSize + 1)];
+    const uint8_t *src = &image.pixels[y * rowSize];
+    dst[0] = 0;
+    if (image.bgra) {
+      for (size_t x = 0; x < rowSize; x += 4) {
+        dst[1 + x + 0] = src[x + 2];
+        dst[1 + x + 1] = src[x + 1];
+        dst[1 + x + 2] = src[x + 0];
+        dst[1 + x + 3] = src[x + 3];
+      }
+    } else {
+      std::copy(src, src + rowSize, dst + 1);
+    }
+  }
+
+  constexpr size_t maxBlockSize = 65535;
+  std::vector<uint8_t> idat;
+  idat.reserve(raw.size() + raw.size() / maxBlockSize * 5 + 16);
+  idat.push_back(0x78);  // zlib header, no compression
+  idat.push_back(0x01);
+  for (size_t offset = 0; offset < raw.size(); offset += maxBlockSize) {
+    size_t blockSize = std::min(maxBlockSize, raw.size() - offset);
+    bool last = offset + blockSize >= raw.size();
+    idat.push_back(last ? 1 : 0);
+    idat.push_back(static_cast<uint8_t>(blockSize));
+    idat.push_back(static_cast<uint8_t>(blockSize >> 8));
+    idat.push_back(static_cast<uint8_t>(~blockSize));
+    idat.push_back(static_cast<uint8_t>(~blockSize >> 8));
+    idat.insert(idat.end(), raw.begin() + offset, raw.begin() + offset + blockSize);
+  }
+
+  uint32_t a = 1, b = 0;
+  for (uint8_t byte : raw) {
+    a = (a + byte) % 65521;
+    b = (b + a) % 65521;
+  }
+  appendBigEndian(idat, (b << 16) | a);
+  writeChunk(file, "IDAT", idat);
+  writeChunk(file, "IEND", {});
+}
+
+void writePpm(std::ofstream &file, const LveImageWriter::Image &image) {
+  file << "P6\n" << image.width << " " << image.height << "\n255\n";
+  const size_t pixelCount = static_cast<size_t>(image.width) * image.height;
+  std::vector<uint8_t> rgb(pixelCount * 3);
+  const int r = image.bgra ? 2 : 0;
+  const int b = image.bgra ? 0 : 2;
+  for (size_t i = 0; i < pixelCount; i++) {
+    rgb[i * 3 + 0] = image.pixels[i * 4 + r];
+    rgb[i * 3 + 1] = image.pixels[i * 4 + 1];
+    rgb[i * 3 + 2] = image.pixels[i * 4 + b];
+  }
+  file.write(reinterpret_cast<const char *>(rgb.data()), rgb.size());
+}
+
+}  // namespace
+
+LveImageWriter::LveImageWriter(
+    const std::string &outputDirectory, Format format, size_t maxQueuedImages)
+    : outputDirectory{outputDirectory}, format{format}, maxQueuedImages{maxQueuedImages} {
+  std::filesystem::create_directories(outputDirectory);
+  worker = std::thread(&LveImageWriter::workerLoop, this);
+}
+
+LveImageWriter::~LveImageWriter() {
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    stopping = true;
+  }
+  queueChanged.notify_all();
+  worker.join();
+}
+
+LveImageWriter::Format LveImageWriter::parseFormat(const std::string &name) {
+  if (name == "png") return Format::Png;
+  if (name == "ppm") return Format::Ppm;
+  if (name == "raw") return Format::Raw;
+  throw std::invalid_argument("unknown image format: " + name);
+}
+
+std::vector<uint8_t> LveImageWriter::acquirePixelBuffer(size_t size) {
+  std::vector<uint8_t> buffer;
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    if (!freeBuffers.empty()) {
+      buffer = std::move(freeBuffers.back());
+      freeBuffers.pop_back();
+    }
+  }
+  buffer.resize(size);
+  return buffer;
+}
+
+void LveImageWriter::enqueue(Image image) {
+  {
+    std::unique_lock<std::mutex> lock{mutex};
+    queueChanged.wait(lock, [this] { return queue.size() < maxQueuedImages; });
+    queue.push_back(std::move(image));
+  }
+  queueChanged.notify_all();
+}
+
+uint64_t LveImageWriter::imagesWritten() const {
+  std::lock_guard<std::mutex> lock{mutex};
+  return writtenCount;
+}
+
+void LveImageWriter::workerLoop() {
+  LveCpuProfiler::setThreadName("image writer");
+  while (true) {
+    Image image;
+    {
+      std::unique_lock<std::mutex> lock{mutex};
+      queueChanged.wait(lock, [this] { return stopping || !queue.empty(); });
+      if (queue.empty()) {
+        return;  // stopping and fully drained
+      }
+      image = std::move(queue.front());
+      queue.pop_front();
+    }
+    queueChanged.notify_all();
+
+    write(image);
+
+    std::lock_guard<std::mutex> lock{mutex};
+    writtenCount++;
+    freeBuffers.push_back(std::move(image.pixels));
+  }
+}
+
+void LveImageWriter::write(const Image &image) {
+  LVE_CPU_ZONE("LveImageWriter::write");
+  std::string path = makeFilePath(image.frameNumber);
+  std::ofstream file{path, std::ios::binary};
+  if (!file.is_open()) {
+    std::cerr << "failed to open capture file: " << path << std::endl;
+    return;
+  }
+
+  switch (format) {
+    case Format::Png:
+      writePng(file, image);
+      break;
+    case Format::Ppm:
+      writePpm(file, image);
+      break;
+    case Format::Raw:
+      file.write(reinterpret_cast<const char *>(image.pixels.data()), image.pixels.size());
+      break;
+  }
+}
+
+std::string LveImageWriter::makeFilePath(uint64_t frameNumber) const {
+  const char *extension = format == Format::Png ? "png" : format == Format::Ppm ? "ppm" : "rgba";
+  char name[64];
+  std::snprintf(
+      name,
+      sizeof(name),
+      "frame_%06llu.%s",
+      static_cast<unsigned long long>(frameNumber),
+      extension);
+  return (std::filesystem::path{outputDirectory} / name).string();
+}
+
+}  // namespace lve
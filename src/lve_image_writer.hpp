@@ -0,0 +1,60 @@
+#pragma once
+
+// std
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace lve {
+
+// Encodes captured frames to disk on a background thread so the render loop only pays for a memcpy.
+class LveImageWriter {
+ public:
+  enum class Format { Png, Ppm, Raw };
+
+  struct Image {
+    uint64_t frameNumber = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    bool bgra = false;  // swapchain images are usually B8G8R8A8
+    std::vector<uint8_t> pixels{};  // tightly packed 4 bytes per pixel
+  };
+
+  LveImageWriter(const std::string &outputDirectory, Format format, size_t maxQueuedImages = 8);
+  ~LveImageWriter();
+
+  LveImageWriter(const LveImageWriter &) = delete;
+  LveImageWriter &operator=(const LveImageWriter &) = delete;
+
+  static Format parseFormat(const std::string &name);
+
+  // Returns a pixel buffer of the given size, recycled from previously written images when possible
+  std::vector<uint8_t> acquirePixelBuffer(size_t size);
+  // Queues an image for encoding, blocks while maxQueuedImages are already pending
+  void enqueue(Image image);
+  uint64_t imagesWritten() const;
+
+ private:
+  void workerLoop();
+  void write(const Image &image);
+  std::string makeFilePath(uint64_t frameNumber) const;
+
+  std::string outputDirectory;
+  Format format;
+  size_t maxQueuedImages;
+
+  mutable std::mutex mutex;
+  std::condition_variable queueChanged;
+  std::deque<Image> queue;
+  std::vector<std::vector<uint8_t>> freeBuffers;
+  uint64_t writtenCount = 0;
+  bool stopping = false;
+
+  std::thread worker;
+};
+
+}  // namespace lve
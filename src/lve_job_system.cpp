@@ -0,0 +1,302 @@
+#include "lve_job_system.hpp"
+
+#include "lve_cpu_profiler.hpp"
+
+// std
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <string>
+
+namespace lve {
+
+namespace {
+
+struct ThreadBinding {
+  const LveJobSystem *system = nullptr;
+  int index = -1;
+};
+
+thread_local ThreadBinding currentBinding{};
+
+// failed rounds of stealing before a worker goes to sleep
+constexpr int SPIN_ROUNDS = 64;
+// sleeping workers also poll, so a missed wakeup costs at most this long
+constexpr auto SLEEP_TIMEOUT = std::chrono::milliseconds(2);
+
+uint32_t nextRandom(uint32_t &state) {
+  // xorshift32
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+}  // namespace
+
+unsigned LveJobSystem::defaultWorkerCount() {
+  unsigned cores = std::thread::hardware_concurrency();
+  return cores > 1 ? cores - 1 : 0;
+}
+
+LveJobSystem::LveJobSystem(unsigned workerCount) {
+  threads.reserve(workerCount + 1);
+  for (unsigned i = 0; i <= workerCount; i++) {
+    threads.push_back(std::make_unique<ThreadState>(DEQUE_CAPACITY));
+    threads.back()->stealSeed = 0x9e3779b9u * (i + 1);
+  }
+  currentBinding = {this, 0};
+
+  workers.reserve(workerCount);
+  for (unsigned i = 1; i <= workerCount; i++) {
+    workers.emplace_back(&LveJobSystem::workerLoop, this, static_cast<int>(i));
+  }
+}
+
+LveJobSystem::~LveJobSystem() {
+  stopping.store(true);
+  {
+    std::lock_guard<std::mutex> lock{sleepMutex};
+  }
+  wakeCondition.notify_all();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  if (currentBinding.system == this) {
+    currentBinding = {};
+  }
+}
+
+int LveJobSystem::currentThreadIndex() const {
+  return currentBinding.system == this ? currentBinding.index : -1;
+}
+
+void LveJobSystem::run(Job job, LveJobCounter &counter) {
+  counter.pending.fetch_add(1, std::memory_order_relaxed);
+  auto *queued = new QueuedJob{std::move(job), &counter};
+
+  int index = currentThreadIndex();
+  if (index < 0) {
+    std::lock_guard<std::mutex> lock{injectMutex};
+    injectQueue.push_back(queued);
+    hasInjectedJobs.store(true, std::memory_order_release);
+  } else if (!threads[index]->deque.push(queued)) {
+    execute(queued, index);  // deque full, don't let the producer outrun the workers
+    return;
+  }
+
+  if (sleepingWorkers.load(std::memory_order_acquire) > 0) {
+    wakeCondition.notify_one();
+  }
+}
+
+void LveJobSystem::runBackground(Job job, LveJobCounter &counter) {
+  counter.pending.fetch_add(1, std::memory_order_relaxed);
+  {
+    std::lock_guard<std::mutex> lock{backgroundMutex};
+    backgroundQueue.push_back(new QueuedJob{std::move(job), &counter});
+    hasBackgroundJobs.store(true, std::memory_order_release);
+  }
+  if (sleepingWorkers.load(std::memory_order_acquire) > 0) {
+    wakeCondition.notify_one();
+  }
+}
+
+void LveJobSystem::wait(LveJobCounter &counter) {
+  int index = currentThreadIndex();
+  while (!counter.isDone()) {
+    if (QueuedJob *job = findJob(index)) {
+      execute(job, index);
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
+
+void LveJobSystem::parallelFor(
+    uint32_t count, uint32_t grainSize, const std::function<void(uint32_t, uint32_t)> &body) {
+  if (count == 0) {
+    return;
+  }
+  grainSize = grainSize > 0 ? grainSize : 1;
+  if (count <= grainSize || workers.empty()) {
+    body(0, count);
+    return;
+  }
+
+  std::mutex errorMutex;
+  std::exception_ptr error;
+  LveJobCounter counter;
+  for (uint32_t begin = 0; begin < count; begin += grainSize) {
+    uint32_t end = count - begin > grainSize ? begin + grainSize : count;
+    run(
+        [&, begin, end] {
+          try {
+            body(begin, end);
+          } catch (...) {
+            std::lock_guard<std::mutex> lock{errorMutex};
+            if (!error) {
+              error = std::current_exception();
+            }
+          }
+        },
+        counter);
+  }
+  wait(counter);
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+LveJobSystem::QueuedJob *LveJobSystem::findJob(int index) {
+  if (index >= 0) {
+    if (QueuedJob *job = threads[index]->deque.pop()) {
+      return job;
+    }
+  }
+
+  if (hasInjectedJobs.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lock{injectMutex};
+    if (!injectQueue.empty()) {
+      QueuedJob *job = injectQueue.front();
+      injectQueue.pop_front();
+      hasInjectedJobs.store(!injectQueue.empty(), std::memory_order_release);
+      return job;
+    }
+  }
+
+  // start at a random victim so thieves don't all hammer the same deque
+  size_t threadCount = threads.size();
+  uint32_t seed = index >= 0 ? threads[index]->stealSeed : 0x2545f491u;
+  size_t start = nextRandom(seed) % threadCount;
+  if (index >= 0) {
+    threads[index]->stealSeed = seed;
+  }
+  for (size_t i = 0; i < threadCount; i++) {
+    size_t victim = (start + i) % threadCount;
+    if (static_cast<int>(victim) == index || threads[victim]->deque.empty()) {
+      continue;
+    }
+    if (QueuedJob *job = threads[victim]->deque.steal()) {
+      if (index >= 0) {
+        threads[index]->jobsStolen.fetch_add(1, std::memory_order_relaxed);
+      }
+      return job;
+    }
+    if (index >= 0) {
+      threads[index]->failedSteals.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  // workers only, index 0 is the creating thread
+  if (index > 0 && hasBackgroundJobs.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lock{backgroundMutex};
+    if (!backgroundQueue.empty()) {
+      QueuedJob *job = backgroundQueue.front();
+      backgroundQueue.pop_front();
+      hasBackgroundJobs.store(!backgroundQueue.empty(), std::memory_order_release);
+      return job;
+    }
+  }
+  return nullptr;
+}
+
+void LveJobSystem::execute(QueuedJob *job, int index) {
+  job->job();
+  if (index >= 0) {
+    threads[index]->jobsExecuted.fetch_add(1, std::memory_order_relaxed);
+  }
+  LveJobCounter *counter = job->counter;
+  delete job;
+  counter->pending.fetch_sub(1, std::memory_order_release);
+}
+
+void LveJobSystem::workerLoop(int index) {
+  currentBinding = {this, index};
+  LveCpuProfiler::setThreadName("worker " + std::to_string(index));
+  auto &state = *threads[index];
+
+  int idleRounds = 0;
+  auto idleStart = std::chrono::steady_clock::now();
+  while (!stopping.load(std::memory_order_acquire)) {
+    if (QueuedJob *job = findJob(index)) {
+      if (idleRounds > 0) {
+        auto idle = std::chrono::steady_clock::now() - idleStart;
+        state.idleNs.fetch_add(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(idle).count(),
+            std::memory_order_relaxed);
+        idleRounds = 0;
+      }
+      execute(job, index);
+      continue;
+    }
+
+    if (idleRounds++ == 0) {
+      idleStart = std::chrono::steady_clock::now();
+    }
+    if (idleRounds < SPIN_ROUNDS) {
+      std::this_thread::yield();
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock{sleepMutex};
+    sleepingWorkers.fetch_add(1, std::memory_order_acq_rel);
+    wakeCondition.wait_for(lock, SLEEP_TIMEOUT);
+    sleepingWorkers.fetch_sub(1, std::memory_order_acq_rel);
+  }
+}
+
+std::vector<LveJobSystem::WorkerStats> LveJobSystem::getStats() const {
+  std::vector<WorkerStats> stats;
+  stats.reserve(threads.size());
+  for (const auto &state : threads) {
+    WorkerStats entry{};
+    entry.jobsExecuted = state->jobsExecuted.load(std::memory_order_relaxed);
+    entry.jobsStolen = state->jobsStolen.load(std::memory_order_relaxed);
+    entry.failedSteals = state->failedSteals.load(std::memory_order_relaxed);
+    entry.idleSeconds =
+        static_cast<double>(state->idleNs.load(std::memory_order_relaxed)) * 1e-9;
+    stats.push_back(entry);
+  }
+  return stats;
+}
+
+void LveJobSystem::resetStats() {
+  for (auto &state : threads) {
+    state->jobsExecuted.store(0, std::memory_order_relaxed);
+    state->jobsStolen.store(0, std::memory_order_relaxed);
+    state->failedSteals.store(0, std::memory_order_relaxed);
+    state->idleNs.store(0, std::memory_order_relaxed);
+  }
+}
+
+void LveJobSystem::logReport(std::ostream &out) const {
+  char line[128];
+  std::snprintf(
+      line,
+      sizeof(line),
+      "%-10s %12s %12s %12s %10s\n",
+      "thread",
+      "jobs",
+      "stolen",
+      "failed steal",
+      "idle s");
+  out << line;
+  auto stats = getStats();
+  for (size_t i = 0; i < stats.size(); i++) {
+    std::string name = i == 0 ? "main" : "worker " + std::to_string(i);
+    std::snprintf(
+        line,
+        sizeof(line),
+        "%-10s %12llu %12llu %12llu %10.3f\n",
+        name.c_str(),
+        static_cast<unsigned long long>(stats[i].jobsExecuted),
+        static_cast<unsigned long long>(stats[i].jobsStolen),
+        static_cast<unsigned long long>(stats[i].failedSteals),
+        stats[i].idleSeconds);
+    out << line;
+  }
+}
+
+}  // namespace lve
@@ -0,0 +1,197 @@
+#pragma once
+
+// std
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+namespace lve {
+
+// Counts the jobs of a batch that haven't finished yet, see LveJobSystem::wait
+class LveJobCounter {
+ public:
+  bool isDone() const { return pending.load(std::memory_order_acquire) == 0; }
+
+ private:
+  friend class LveJobSystem;
+  std::atomic<uint32_t> pending{0};
+};
+
+// Fixed size Chase-Lev deque. The owning thread pushes and pops at the bottom, any other thread
+// steals from the top, so the owner works depth first on its newest jobs while thieves take the
+// oldest, usually largest, ones.
+template <typename T>
+class LveWorkStealingDeque {
+ public:
+  // capacity must be a power of two
+  explicit LveWorkStealingDeque(size_t capacity) : mask{capacity - 1}, buffer(capacity) {}
+
+  LveWorkStealingDeque(const LveWorkStealingDeque &) = delete;
+  LveWorkStealingDeque &operator=(const LveWorkStealingDeque &) = delete;
+
+  // owner only, returns false when the deque is full
+  bool push(T *item) {
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_acquire);
+    if (b - t > static_cast<int64_t>(mask)) {
+      return false;
+    }
+    buffer[b & mask].store(item, std::memory_order_relaxed);
+    // publishes the item to thieves that read bottom with acquire
+    bottom.store(b + 1, std::memory_order_release);
+    return true;
+  }
+
+  // owner only
+  T *pop() {
+    int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_relaxed);
+    if (t > b) {
+      bottom.store(b + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+
+    T *item = buffer[b & mask].load(std::memory_order_relaxed);
+    if (t == b) {
+      // last item, race the thieves for it
+      if (!top.compare_exchange_strong(
+              t,
+              t + 1,
+              std::memory_order_seq_cst,
+              std::memory_order_relaxed)) {
+        item = nullptr;
+      }
+      bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return item;
+  }
+
+  // any thread
+  T *steal() {
+    int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom.load(std::memory_order_acquire);
+    if (t >= b) {
+      return nullptr;
+    }
+
+    T *item = buffer[t & mask].load(std::memory_order_relaxed);
+    if (!top.compare_exchange_strong(
+            t,
+            t + 1,
+            std::memory_order_seq_cst,
+            std::memory_order_relaxed)) {
+      return nullptr;  // lost the race to the owner or another thief
+    }
+    return item;
+  }
+
+  bool empty() const {
+    return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+  }
+
+ private:
+  const size_t mask;
+  std::vector<std::atomic<T *>> buffer;
+  alignas(64) std::atomic<int64_t> top{0};
+  alignas(64) std::atomic<int64_t> bottom{0};
+};
+
+// Runs jobs on a fixed set of worker threads. Every worker, and the thread that created the system,
+// owns a work-stealing deque; idle threads steal from the others and sleep once there is nothing
+// left. Threads waiting on a counter execute jobs instead of blocking, so jobs may spawn and wait
+// on their own jobs. Jobs submitted from other threads go through a shared queue.
+class LveJobSystem {
+ public:
+  using Job = std::function<void()>;
+  static constexpr size_t DEQUE_CAPACITY = 4096;
+
+  struct WorkerStats {
+    uint64_t jobsExecuted = 0;
+    uint64_t jobsStolen = 0;
+    uint64_t failedSteals = 0;
+    double idleSeconds = 0.0;
+  };
+
+  // one worker per core besides the calling thread
+  static unsigned defaultWorkerCount();
+
+  // workerCount 0 runs every job on the threads that wait for them
+  explicit LveJobSystem(unsigned workerCount = defaultWorkerCount());
+  ~LveJobSystem();
+
+  LveJobSystem(const LveJobSystem &) = delete;
+  LveJobSystem &operator=(const LveJobSystem &) = delete;
+
+  unsigned getWorkerCount() const { return static_cast<unsigned>(workers.size()); }
+
+  // Schedules job and adds it to counter. Jobs must not throw, see parallelFor for a throwing body.
+  void run(Job job, LveJobCounter &counter);
+  // Schedules a long running job, like parsing a file, that only workers pick up and only once
+  // they have nothing else to do. The creating thread never runs it, not even from wait, so its
+  // frames aren't held up by background work. Needs at least one worker.
+  void runBackground(Job job, LveJobCounter &counter);
+  // Executes queued jobs until every job added to counter has finished
+  void wait(LveJobCounter &counter);
+
+  // Calls body(begin, end) over [0, count) in chunks of at most grainSize indices and waits for
+  // all of them, without workers body gets the whole range at once. The first exception thrown by
+  // body is rethrown once every chunk has finished.
+  void parallelFor(
+      uint32_t count, uint32_t grainSize, const std::function<void(uint32_t, uint32_t)> &body);
+
+  // index 0 is the creating thread, then one entry per worker
+  std::vector<WorkerStats> getStats() const;
+  void resetStats();
+  void logReport(std::ostream &out) const;
+
+ private:
+  struct QueuedJob {
+    Job job;
+    LveJobCounter *counter;
+  };
+
+  struct alignas(64) ThreadState {
+    explicit ThreadState(size_t capacity) : deque{capacity} {}
+
+    LveWorkStealingDeque<QueuedJob> deque;
+    std::atomic<uint64_t> jobsExecuted{0};
+    std::atomic<uint64_t> jobsStolen{0};
+    std::atomic<uint64_t> failedSteals{0};
+    std::atomic<uint64_t> idleNs{0};
+    uint32_t stealSeed;
+  };
+
+  void workerLoop(int index);
+  // index of the calling thread's state, -1 for threads the system doesn't own
+  int currentThreadIndex() const;
+  QueuedJob *findJob(int index);
+  void execute(QueuedJob *job, int index);
+
+  std::vector<std::unique_ptr<ThreadState>> threads;
+  std::vector<std::thread> workers;
+
+  std::mutex injectMutex;
+  std::deque<QueuedJob *> injectQueue;
+  std::atomic<bool> hasInjectedJobs{false};
+
+  std::mutex backgroundMutex;
+  std::deque<QueuedJob *> backgroundQueue;
+  std::atomic<bool> hasBackgroundJobs{false};
+
+  std::mutex sleepMutex;
+  std::condition_variable wakeCondition;
+  std::atomic<int> sleepingWorkers{0};
+  std::atomic<bool> stopping{false};
+};
+
+}  // namespace lve
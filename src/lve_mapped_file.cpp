@@ -0,0 +1,83 @@
+#include "lve_mapped_file.hpp"
+
+// std
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace lve {
+
+#ifdef _WIN32
+
+LveMappedFile::LveMappedFile(const std::string &filepath) {
+  HANDLE file = CreateFileA(
+      filepath.c_str(),
+      GENERIC_READ,
+      FILE_SHARE_READ,
+      nullptr,
+      OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL,
+      nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    throw std::runtime_error("failed to open file: " + filepath);
+  }
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+    CloseHandle(file);
+    throw std::runtime_error("failed to map empty file: " + filepath);
+  }
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  void *view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+  if (view == nullptr) {
+    if (mapping) CloseHandle(mapping);
+    CloseHandle(file);
+    throw std::runtime_error("failed to map file: " + filepath);
+  }
+  fileHandle = file;
+  mappingHandle = mapping;
+  mapped = static_cast<const uint8_t *>(view);
+  fileSize = static_cast<size_t>(size.QuadPart);
+}
+
+LveMappedFile::~LveMappedFile() {
+  UnmapViewOfFile(mapped);
+  CloseHandle(mappingHandle);
+  CloseHandle(fileHandle);
+}
+
+#else
+
+LveMappedFile::LveMappedFile(const std::string &filepath) {
+  int file = open(filepath.c_str(), O_RDONLY);
+  if (file < 0) {
+    throw std::runtime_error("failed to open file: " + filepath);
+  }
+  struct stat info;
+  if (fstat(file, &info) != 0 || info.st_size == 0) {
+    close(file);
+    throw std::runtime_error("failed to map empty file: " + filepath);
+  }
+  void *view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+  // the mapping keeps the file referenced on its own
+  close(file);
+  if (view == MAP_FAILED) {
+    throw std::runtime_error("failed to map file: " + filepath);
+  }
+  mapped = static_cast<const uint8_t *>(view);
+  fileSize = static_cast<size_t>(info.st_size);
+}
+
+LveMappedFile::~LveMappedFile() { munmap(const_cast<uint8_t *>(mapped), fileSize); }
+
+#endif
+
+}  // namespace lve
@@ -0,0 +1,32 @@
+#pragma once
+
+// std
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace lve {
+
+// Read only memory mapping of a whole file. Pages are loaded by the OS on first touch, so opening
+// a large file costs about as much as opening a small one.
+class LveMappedFile {
+ public:
+  explicit LveMappedFile(const std::string &filepath);
+  ~LveMappedFile();
+
+  LveMappedFile(const LveMappedFile &) = delete;
+  LveMappedFile &operator=(const LveMappedFile &) = delete;
+
+  const uint8_t *data() const { return mapped; }
+  size_t size() const { return fileSize; }
+
+ private:
+  const uint8_t *mapped = nullptr;
+  size_t fileSize = 0;
+#ifdef _WIN32
+  void *fileHandle = nullptr;
+  void *mappingHandle = nullptr;
+#endif
+};
+
+}  // namespace lve
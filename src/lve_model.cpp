@@ -1,12 +1,10 @@
 #include "lve_model.hpp"
 
-#include "lve_utils.hpp"
+#include "lve_engine_events.hpp"
 
 // libs
 #define TINYOBJLOADER_IMPLEMENTATION
 #include <tiny_obj_loader.h>
-#define GLM_ENABLE_EXPERIMENTAL
-#include <glm/gtx/hash.hpp>
 
 // std
 #include <cassert>
@@ -17,50 +15,56 @@
 #define ENGINE_DIR "../"
 #endif
 
-namespace std {
-template <>
-struct hash<lve::LveModel::Vertex> {
-  size_t operator()(lve::LveModel::Vertex const &vertex) const {
-    size_t seed = 0;
-    lve::hashCombine(seed, vertex.position, vertex.color, vertex.normal, vertex.uv);
-    return seed;
-  }
-};
-}  // namespace std
-
 namespace lve {
 
 LveModel::LveModel(LveDevice &device, const LveModel::Builder &builder) : lveDevice{device} {
-  createVertexBuffers(builder.vertices);
-  createIndexBuffers(builder.indices);
+  computeBounds(builder.vertices);
+  auto upload = lveDevice.beginTransfer();
+  createVertexBuffers(upload, builder.vertices);
+  createIndexBuffers(upload, builder.indices);
+  uploadToken = lveDevice.submitTransfer(std::move(upload));
 }
 
-LveModel::~LveModel() {}
+LveModel::~LveModel() {
+  if (!isReady()) {
+    // the copy may still be writing to the buffers
+    lveDevice.flushTransfers();
+  }
+}
 
 std::unique_ptr<LveModel> LveModel::createModelFromFile(
     LveDevice &device, const std::string &filepath) {
+  LveEngineEventScope event{"asset upload", filepath};
   Builder builder{};
   builder.loadModel(ENGINE_DIR + filepath);
   return std::make_unique<LveModel>(device, builder);
 }
 
-void LveModel::createVertexBuffers(const std::vector<Vertex> &vertices) {
+void LveModel::computeBounds(const std::vector<Vertex> &vertices) {
+  if (vertices.empty()) {
+    return;
+  }
+  boundsMin = boundsMax = vertices[0].position;
+  for (const auto &vertex : vertices) {
+    boundsMin = glm::min(boundsMin, vertex.position);
+    boundsMax = glm::max(boundsMax, vertex.position);
+  }
+
+  boundingCenter = 0.5f * (boundsMin + boundsMax);
+  float radiusSquared = 0.f;
+  for (const auto &vertex : vertices) {
+    glm::vec3 offset = vertex.position - boundingCenter;
+    radiusSquared = glm::max(radiusSquared, glm::dot(offset, offset));
+  }
+  boundingRadius = glm::sqrt(radiusSquared);
+}
+
+void LveModel::createVertexBuffers(LveTransferBatch &upload, const std::vector<Vertex> &vertices) {
   vertexCount = static_cast<uint32_t>(vertices.size());
   assert(vertexCount >= 3 && "Vertex count must be at least 3");
   VkDeviceSize bufferSize = sizeof(vertices[0]) * vertexCount;
   uint32_t vertexSize = sizeof(vertices[0]);
 
-  LveBuffer stagingBuffer{
-      lveDevice,
-      vertexSize,
-      vertexCount,
-      VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-  };
-
-  stagingBuffer.map();
-  stagingBuffer.writeToBuffer((void *)vertices.data());
-
   vertexBuffer = std::make_unique<LveBuffer>(
       lveDevice,
       vertexSize,
@@ -68,10 +72,16 @@ void LveModel::createVertexBuffers(const std::vector<Vertex> &vertices) {
       VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
       VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
-  lveDevice.copyBuffer(stagingBuffer.getBuffer(), vertexBuffer->getBuffer(), bufferSize);
+  lveDevice.uploadBuffer(
+      upload,
+      vertexBuffer->getBuffer(),
+      vertices.data(),
+      bufferSize,
+      VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+      VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
 }
 
-void LveModel::createIndexBuffers(const std::vector<uint32_t> &indices) {
+void LveModel::createIndexBuffers(LveTransferBatch &upload, const std::vector<uint32_t> &indices) {
   indexCount = static_cast<uint32_t>(indices.size());
   hasIndexBuffer = indexCount > 0;
 
@@ -82,17 +92,6 @@ void LveModel::createIndexBuffers(const std::vector<uint32_t> &indices) {
   VkDeviceSize bufferSize = sizeof(indices[0]) * indexCount;
   uint32_t indexSize = sizeof(indices[0]);
 
-  LveBuffer stagingBuffer{
-      lveDevice,
-      indexSize,
-      indexCount,
-      VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-  };
-
-  stagingBuffer.map();
-  stagingBuffer.writeToBuffer((void *)indices.data());
-
   indexBuffer = std::make_unique<LveBuffer>(
       lveDevice,
       indexSize,
@@ -100,7 +99,13 @@ void LveModel::createIndexBuffers(const std::vector<uint32_t> &indices) {
       VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
       VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
-  lveDevice.copyBuffer(stagingBuffer.getBuffer(), indexBuffer->getBuffer(), bufferSize);
+  lveDevice.uploadBuffer(
+      upload,
+      indexBuffer->getBuffer(),
+      indices.data(),
+      bufferSize,
+      VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+      VK_ACCESS_INDEX_READ_BIT);
 }
 
 void LveModel::draw(VkCommandBuffer commandBuffer) {
@@ -2,14 +2,18 @@
 
 #include "lve_buffer.hpp"
 #include "lve_device.hpp"
+#include "lve_utils.hpp"
 
 // libs
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/glm.hpp>
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/hash.hpp>
 
 // std
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace lve {
@@ -46,14 +50,29 @@ class LveModel {
   static std::unique_ptr<LveModel> createModelFromFile(
       LveDevice &device, const std::string &filepath);
 
+  // false until the buffers finished uploading on the transfer queue, skip the model until then
+  bool isReady() const { return lveDevice.isTransferComplete(uploadToken); }
+
   void bind(VkCommandBuffer commandBuffer);
   void draw(VkCommandBuffer commandBuffer);
 
+  uint32_t getVertexCount() const { return vertexCount; }
+  uint32_t getIndexCount() const { return hasIndexBuffer ? indexCount : 0; }
+  uint32_t getTriangleCount() const { return (hasIndexBuffer ? indexCount : vertexCount) / 3; }
+
+  // model space bounds, computed from the vertices at load time
+  const glm::vec3 &getBoundsMin() const { return boundsMin; }
+  const glm::vec3 &getBoundsMax() const { return boundsMax; }
+  const glm::vec3 &getBoundingCenter() const { return boundingCenter; }
+  float getBoundingRadius() const { return boundingRadius; }
+
  private:
-  void createVertexBuffers(const std::vector<Vertex> &vertices);
-  void createIndexBuffers(const std::vector<uint32_t> &indices);
+  void computeBounds(const std::vector<Vertex> &vertices);
+  void createVertexBuffers(LveTransferBatch &upload, const std::vector<Vertex> &vertices);
+  void createIndexBuffers(LveTransferBatch &upload, const std::vector<uint32_t> &indices);
 
   LveDevice &lveDevice;
+  LveDevice::TransferToken uploadToken = 0;
 
   std::unique_ptr<LveBuffer> vertexBuffer;
   uint32_t vertexCount;
@@ -61,5 +80,21 @@ class LveModel {
   bool hasIndexBuffer = false;
   std::unique_ptr<LveBuffer> indexBuffer;
   uint32_t indexCount;
+
+  glm::vec3 boundsMin{0.f};
+  glm::vec3 boundsMax{0.f};
+  glm::vec3 boundingCenter{0.f};
+  float boundingRadius{0.f};
 };
 }  // namespace lve
+
+namespace std {
+template <>
+struct hash<lve::LveModel::Vertex> {
+  size_t operator()(lve::LveModel::Vertex const &vertex) const {
+    size_t seed = 0;
+    lve::hashCombine(seed, vertex.position, vertex.color, vertex.normal, vertex.uv);
+    return seed;
+  }
+};
+}  // namespace std
@@ -0,0 +1,65 @@
+#pragma once
+
+// std
+#include <atomic>
+#include <optional>
+#include <utility>
+
+namespace lve {
+
+// Unbounded multi producer, single consumer queue (Vyukov's linked list). push never takes a lock
+// and costs one allocation plus an atomic exchange, pop is wait free. Producers publish their node
+// in two steps, so pop may briefly miss an item that is being pushed; it shows up on a later pop.
+template <typename T>
+class LveMpscQueue {
+ public:
+  LveMpscQueue() : head{new Node{}}, tail{head.load(std::memory_order_relaxed)} {}
+  ~LveMpscQueue() {
+    while (tail != nullptr) {
+      Node *next = tail->next.load(std::memory_order_relaxed);
+      delete tail;
+      tail = next;
+    }
+  }
+
+  LveMpscQueue(const LveMpscQueue &) = delete;
+  LveMpscQueue &operator=(const LveMpscQueue &) = delete;
+
+  // any thread
+  void push(T value) {
+    Node *node = new Node{};
+    node->value.emplace(std::move(value));
+    Node *previous = head.exchange(node, std::memory_order_acq_rel);
+    // publishes the node (and its value) to the consumer, which reads next with acquire
+    previous->next.store(node, std::memory_order_release);
+  }
+
+  // consumer only, returns false when the queue is empty
+  bool pop(T &out) {
+    Node *next = tail->next.load(std::memory_order_acquire);
+    if (next == nullptr) {
+      return false;
+    }
+    // next becomes the new stub, its value moves out
+    out = std::move(*next->value);
+    next->value.reset();
+    delete tail;
+    tail = next;
+    return true;
+  }
+
+  // consumer only
+  bool empty() const { return tail->next.load(std::memory_order_acquire) == nullptr; }
+
+ private:
+  struct Node {
+    std::atomic<Node *> next{nullptr};
+    std::optional<T> value{};
+  };
+
+  // producers append at head, the consumer removes behind tail, which always points at a stub
+  alignas(64) std::atomic<Node *> head;
+  alignas(64) Node *tail;
+};
+
+}  // namespace lve
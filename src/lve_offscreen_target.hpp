@@ -0,0 +1,80 @@
+#pragma once
+
+#include "lve_device.hpp"
+#include "lve_swap_chain.hpp"
+
+// vulkan headers
+#include <vulkan/vulkan.h>
+
+// std lib headers
+#include <vector>
+
+namespace lve {
+
+// Headless counterpart of LveSwapChain. Owns one color + depth target per frame in flight and
+// exposes the same render pass / framebuffer interface, but frames are paced with the frame
+// timeline only and nothing is presented. The color attachment is left in TRANSFER_SRC_OPTIMAL
+// so it can be read back.
+class LveOffscreenTarget {
+ public:
+  static constexpr int MAX_FRAMES_IN_FLIGHT = LveSwapChain::MAX_FRAMES_IN_FLIGHT;
+  static constexpr VkImageLayout COLOR_FINAL_LAYOUT = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+  LveOffscreenTarget(LveDevice &deviceRef, VkExtent2D extent);
+  ~LveOffscreenTarget();
+
+  LveOffscreenTarget(const LveOffscreenTarget &) = delete;
+  LveOffscreenTarget &operator=(const LveOffscreenTarget &) = delete;
+
+  VkFramebuffer getFrameBuffer(int index) { return framebuffers[index]; }
+  VkRenderPass getRenderPass() { return renderPass; }
+  VkImage getColorImage(int index) { return colorImages[index]; }
+  VkImageView getImageView(int index) { return colorImageViews[index]; }
+  size_t imageCount() { return colorImages.size(); }
+  VkFormat getColorFormat() { return colorFormat; }
+  VkExtent2D getExtent() { return extent; }
+  uint32_t width() { return extent.width; }
+  uint32_t height() { return extent.height; }
+
+  float extentAspectRatio() {
+    return static_cast<float>(extent.width) / static_cast<float>(extent.height);
+  }
+  VkFormat findDepthFormat();
+
+  // Returns the index of the frame slot, which the caller waited to retire; always VK_SUCCESS
+  VkResult acquireNextImage(uint32_t *imageIndex);
+  // Signals frameValue on the device's frame timeline once the buffers executed. computeWait and
+  // transferWait, when set, are async compute work and uploads the frame waits for at their stage.
+  VkResult submitCommandBuffers(
+      const VkCommandBuffer *buffers,
+      uint32_t *imageIndex,
+      uint64_t frameValue,
+      LveTimelinePoint computeWait = {},
+      LveTimelinePoint transferWait = {});
+
+ private:
+  void createColorResources();
+  void createDepthResources();
+  void createRenderPass();
+  void createFramebuffers();
+
+  VkFormat colorFormat = VK_FORMAT_R8G8B8A8_SRGB;
+  VkFormat depthFormat;
+  VkExtent2D extent;
+
+  std::vector<VkFramebuffer> framebuffers;
+  VkRenderPass renderPass;
+
+  std::vector<VkImage> colorImages;
+  std::vector<VkDeviceMemory> colorImageMemorys;
+  std::vector<VkImageView> colorImageViews;
+  std::vector<VkImage> depthImages;
+  std::vector<VkDeviceMemory> depthImageMemorys;
+  std::vector<VkImageView> depthImageViews;
+
+  LveDevice &device;
+
+  size_t currentFrame = 0;
+};
+
+}  // namespace lve
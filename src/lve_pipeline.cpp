@@ -1,5 +1,6 @@
 #include "lve_pipeline.hpp"
 
+#include "lve_engine_events.hpp"
 #include "lve_model.hpp"
 
 // std
@@ -20,13 +21,16 @@ LvePipeline::LvePipeline(
     const std::string& fragFilepath,
     const PipelineConfigInfo& configInfo)
     : lveDevice{device} {
+  LveEngineEventScope event{"pipeline creation", vertFilepath + " + " + fragFilepath};
   createGraphicsPipeline(vertFilepath, fragFilepath, configInfo);
 }
 
 LvePipeline::~LvePipeline() {
   vkDestroyShaderModule(lveDevice.device(), vertShaderModule, nullptr);
   vkDestroyShaderModule(lveDevice.device(), fragShaderModule, nullptr);
-  vkDestroyPipeline(lveDevice.device(), graphicsPipeline, nullptr);
+  lveDevice.getDeletionQueue().push([device = lveDevice.device(), pipeline = graphicsPipeline] {
+    vkDestroyPipeline(device, pipeline, nullptr);
+  });
 }
 
 std::vector<char> LvePipeline::readFile(const std::string& filepath) {
@@ -45,10 +45,10 @@ class LvePipeline {
 
   static void defaultPipelineConfigInfo(PipelineConfigInfo& configInfo);
   static void enableAlphaBlending(PipelineConfigInfo& configInfo);
-
- private:
+  // reads a file relative to the engine directory, e.g. compiled shaders
   static std::vector<char> readFile(const std::string& filepath);
 
+ private:
   void createGraphicsPipeline(
       const std::string& vertFilepath,
       const std::string& fragFilepath,
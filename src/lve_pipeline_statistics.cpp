@@ -0,0 +1,215 @@
+#include "lve_pipeline_statistics.hpp"
+
+// std
+#include <cassert>
+#include <cstdio>
+#include <stdexcept>
+
+namespace lve {
+
+namespace {
+
+constexpr VkQueryPipelineStatisticFlags QUERIED_STATISTICS =
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+
+}  // namespace
+
+double LvePipelineStatistics::ScopeReport::vertexReuse() const {
+  return perFrame[VertexInvocations] > 0.0
+             ? perFrame[InputVertices] / perFrame[VertexInvocations]
+             : 0.0;
+}
+
+LvePipelineStatistics::LvePipelineStatistics(
+    LveDevice &device, int framesInFlight, size_t historySize)
+    : lveDevice{device}, historySize{historySize} {
+  supported = lveDevice.enabledFeatures.pipelineStatisticsQuery == VK_TRUE;
+  if (!supported) {
+    return;
+  }
+
+  frames.resize(framesInFlight);
+  for (auto &frame : frames) {
+    VkQueryPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    poolInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+    poolInfo.queryCount = MAX_SCOPES_PER_FRAME;
+    poolInfo.pipelineStatistics = QUERIED_STATISTICS;
+    if (vkCreateQueryPool(lveDevice.device(), &poolInfo, nullptr, &frame.queryPool) !=
+        VK_SUCCESS) {
+      throw std::runtime_error("failed to create pipeline statistics query pool!");
+    }
+    frame.scopes.reserve(MAX_SCOPES_PER_FRAME);
+  }
+  results.resize(MAX_SCOPES_PER_FRAME * COUNTER_COUNT);
+}
+
+LvePipelineStatistics::~LvePipelineStatistics() {
+  for (auto &frame : frames) {
+    vkDestroyQueryPool(lveDevice.device(), frame.queryPool, nullptr);
+  }
+}
+
+const char *LvePipelineStatistics::counterName(Counter counter) {
+  switch (counter) {
+    case InputVertices:
+      return "input vertices";
+    case InputPrimitives:
+      return "input primitives";
+    case VertexInvocations:
+      return "vertex invocations";
+    case ClippingInvocations:
+      return "clipping invocations";
+    case ClippingPrimitives:
+      return "clipping primitives";
+    case FragmentInvocations:
+      return "fragment invocations";
+    default:
+      return "unknown";
+  }
+}
+
+void LvePipelineStatistics::beginFrame(VkCommandBuffer commandBuffer, int frameIndex) {
+  assert(currentFrame == nullptr && "Pipeline statistics frame already in progress");
+  if (!supported) {
+    return;
+  }
+
+  auto &frame = frames[frameIndex];
+  collect(frame);
+  frame.scopes.clear();
+  if (!enabled) {
+    return;
+  }
+
+  vkCmdResetQueryPool(commandBuffer, frame.queryPool, 0, MAX_SCOPES_PER_FRAME);
+  currentFrame = &frame;
+}
+
+void LvePipelineStatistics::endFrame() {
+  assert(openScope < 0 && "Pipeline statistics scope left open at the end of the frame");
+  currentFrame = nullptr;
+}
+
+int LvePipelineStatistics::beginScope(VkCommandBuffer commandBuffer, const char *name) {
+  if (currentFrame == nullptr || currentFrame->scopes.size() == MAX_SCOPES_PER_FRAME) {
+    return -1;
+  }
+  assert(openScope < 0 && "Pipeline statistics scopes can't nest");
+
+  openScope = static_cast<int>(currentFrame->scopes.size());
+  currentFrame->scopes.push_back(name);
+  vkCmdBeginQuery(commandBuffer, currentFrame->queryPool, openScope, 0);
+  return openScope;
+}
+
+void LvePipelineStatistics::endScope(VkCommandBuffer commandBuffer, int scope) {
+  if (scope < 0) {
+    return;
+  }
+  assert(scope == openScope && "Ending a pipeline statistics scope that isn't open");
+
+  vkCmdEndQuery(commandBuffer, currentFrame->queryPool, scope);
+  openScope = -1;
+}
+
+void LvePipelineStatistics::collectAll() {
+  assert(currentFrame == nullptr && "Can't collect statistics while a frame is in progress");
+  for (auto &frame : frames) {
+    collect(frame);
+    frame.scopes.clear();
+  }
+}
+
+void LvePipelineStatistics::collect(FrameQueries &frame) {
+  if (frame.scopes.empty()) {
+    return;
+  }
+
+  uint32_t queryCount = static_cast<uint32_t>(frame.scopes.size());
+  auto result = vkGetQueryPoolResults(
+      lveDevice.device(),
+      frame.queryPool,
+      0,
+      queryCount,
+      queryCount * COUNTER_COUNT * sizeof(uint64_t),
+      results.data(),
+      COUNTER_COUNT * sizeof(uint64_t),
+      VK_QUERY_RESULT_64_BIT);
+  if (result != VK_SUCCESS) {
+    return;  // drop the frame rather than stall on it
+  }
+
+  for (uint32_t i = 0; i < queryCount; i++) {
+    auto it = historyIndex.find(frame.scopes[i]);
+    if (it == historyIndex.end()) {
+      it = historyIndex.emplace(frame.scopes[i], history.size()).first;
+      ScopeHistory scope;
+      scope.name = frame.scopes[i];
+      scope.counters.fill(LveRollingStats{historySize});
+      history.push_back(std::move(scope));
+    }
+    auto &counters = history[it->second].counters;
+    for (int c = 0; c < COUNTER_COUNT; c++) {
+      counters[c].add(static_cast<double>(results[i * COUNTER_COUNT + c]));
+    }
+  }
+}
+
+std::vector<LvePipelineStatistics::ScopeReport> LvePipelineStatistics::getReport() const {
+  std::vector<ScopeReport> report;
+  report.reserve(history.size());
+  for (const auto &scope : history) {
+    ScopeReport entry{scope.name, {}};
+    for (int c = 0; c < COUNTER_COUNT; c++) {
+      entry.perFrame[c] = scope.counters[c].mean();
+    }
+    report.push_back(entry);
+  }
+  return report;
+}
+
+void LvePipelineStatistics::logReport(std::ostream &out, uint64_t pixelCount) const {
+  if (!supported) {
+    out << "pipeline statistics: pipelineStatisticsQuery not supported by the device\n";
+    return;
+  }
+
+  char line[192];
+  std::snprintf(
+      line,
+      sizeof(line),
+      "%-24s %11s %11s %7s %11s %11s %11s %7s  (per frame)\n",
+      "scope",
+      "vertices",
+      "vs invoc",
+      "reuse",
+      "clip in",
+      "clip out",
+      "fs invoc",
+      "fs/px");
+  out << line;
+  for (const auto &scope : getReport()) {
+    const auto &c = scope.perFrame;
+    std::snprintf(
+        line,
+        sizeof(line),
+        "%-24s %11.0f %11.0f %7.2f %11.0f %11.0f %11.0f %7.2f\n",
+        scope.name.c_str(),
+        c[InputVertices],
+        c[VertexInvocations],
+        scope.vertexReuse(),
+        c[ClippingInvocations],
+        c[ClippingPrimitives],
+        c[FragmentInvocations],
+        pixelCount > 0 ? c[FragmentInvocations] / static_cast<double>(pixelCount) : 0.0);
+    out << line;
+  }
+}
+
+}  // namespace lve
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "lve_device.hpp"
+#include "lve_stats.hpp"
+
+// vulkan headers
+#include <vulkan/vulkan.h>
+
+// std
+#include <array>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lve {
+
+// Counts the vertex, clipping and fragment work of named scopes with pipeline statistics queries.
+// Like LveGpuProfiler every frame in flight owns a query pool that is read back once its slot
+// comes around again. Only one query of a type can be active at a time, so scopes don't nest and
+// must begin and end within the same subpass. Needs the pipelineStatisticsQuery device feature.
+class LvePipelineStatistics {
+ public:
+  static constexpr uint32_t MAX_SCOPES_PER_FRAME = 32;
+
+  // in the order vkGetQueryPoolResults returns them for the queried statistics
+  enum Counter {
+    InputVertices,
+    InputPrimitives,
+    VertexInvocations,
+    ClippingInvocations,
+    ClippingPrimitives,
+    FragmentInvocations,
+    COUNTER_COUNT
+  };
+
+  struct ScopeReport {
+    std::string name;
+    // mean per frame over the history window
+    std::array<double, COUNTER_COUNT> perFrame;
+
+    // indices fetched per vertex shader invocation, higher means better post-transform reuse
+    double vertexReuse() const;
+  };
+
+  LvePipelineStatistics(LveDevice &device, int framesInFlight, size_t historySize = 240);
+  ~LvePipelineStatistics();
+
+  LvePipelineStatistics(const LvePipelineStatistics &) = delete;
+  LvePipelineStatistics &operator=(const LvePipelineStatistics &) = delete;
+
+  static const char *counterName(Counter counter);
+
+  bool isSupported() const { return supported; }
+  bool isEnabled() const { return supported && enabled; }
+  void setEnabled(bool enable) { enabled = enable; }
+
+  // Collects the previous results of this frame slot and resets its queries. Must be recorded
+  // outside a render pass, after the slot's previous frame retired.
+  void beginFrame(VkCommandBuffer commandBuffer, int frameIndex);
+  void endFrame();
+
+  // name must stay valid for the lifetime of the object, e.g. a string literal.
+  // Returns a handle for endScope, or -1 when the scope is not being measured.
+  int beginScope(VkCommandBuffer commandBuffer, const char *name);
+  void endScope(VkCommandBuffer commandBuffer, int scope);
+
+  // Reads every outstanding result, only valid while the device is idle
+  void collectAll();
+
+  std::vector<ScopeReport> getReport() const;
+  // pixelCount turns fragment invocations into fragments per pixel, the scope's overdraw
+  void logReport(std::ostream &out, uint64_t pixelCount) const;
+
+ private:
+  struct FrameQueries {
+    VkQueryPool queryPool = VK_NULL_HANDLE;
+    std::vector<const char *> scopes{};
+  };
+
+  struct ScopeHistory {
+    std::string name;
+    std::array<LveRollingStats, COUNTER_COUNT> counters;
+  };
+
+  void collect(FrameQueries &frame);
+
+  LveDevice &lveDevice;
+  bool supported = false;
+  bool enabled = false;
+  size_t historySize;
+
+  std::vector<FrameQueries> frames;
+  FrameQueries *currentFrame = nullptr;
+  int openScope = -1;
+  std::vector<uint64_t> results;
+
+  std::vector<ScopeHistory> history;
+  std::unordered_map<std::string, size_t> historyIndex;
+};
+
+// Scoped helper that records a pipeline statistics query for the lifetime of the object
+class LvePipelineStatisticsScope {
+ public:
+  LvePipelineStatisticsScope(
+      LvePipelineStatistics &statistics, VkCommandBuffer commandBuffer, const char *name)
+      : statistics{statistics}, commandBuffer{commandBuffer} {
+    scope = statistics.beginScope(commandBuffer, name);
+  }
+  ~LvePipelineStatisticsScope() { statistics.endScope(commandBuffer, scope); }
+
+  LvePipelineStatisticsScope(const LvePipelineStatisticsScope &) = delete;
+  LvePipelineStatisticsScope &operator=(const LvePipelineStatisticsScope &) = delete;
+
+ private:
+  LvePipelineStatistics &statistics;
+  VkCommandBuffer commandBuffer;
+  int scope;
+};
+
+}  // namespace lve
@@ -0,0 +1,61 @@
+#include "lve_render_snapshot.hpp"
+
+#include "lve_cpu_profiler.hpp"
+
+// std
+#include <iterator>
+
+namespace lve {
+
+void LveRenderSnapshot::capture(const LveGameObject::Map &source) {
+  LVE_CPU_ZONE("LveRenderSnapshot::capture");
+  for (const auto &kv : source) {
+    auto it = gameObjects.find(kv.first);
+    if (it == gameObjects.end()) {
+      gameObjects.emplace(kv.first, kv.second.clone());
+      continue;
+    }
+
+    auto &copy = it->second;
+    const auto &obj = kv.second;
+    copy.color = obj.color;
+    copy.transform = obj.transform;
+    copy.isStatic = obj.isStatic;
+    copy.worldMatrix = obj.worldMatrix;
+    copy.worldNormalMatrix = obj.worldNormalMatrix;
+    if (copy.model != obj.model) {
+      copy.model = obj.model;  // skips the reference count traffic in the common case
+    }
+    if (obj.pointLight == nullptr) {
+      copy.pointLight.reset();
+    } else if (copy.pointLight == nullptr) {
+      copy.pointLight = std::make_unique<PointLightComponent>(*obj.pointLight);
+    } else {
+      *copy.pointLight = *obj.pointLight;
+    }
+  }
+
+  // every source object is in the snapshot now, anything beyond that was destroyed
+  if (gameObjects.size() > source.size()) {
+    for (auto it = gameObjects.begin(); it != gameObjects.end();) {
+      it = source.count(it->first) == 0 ? gameObjects.erase(it) : std::next(it);
+    }
+  }
+}
+
+void LveRenderSnapshot::interpolate(
+    const std::vector<std::pair<LveGameObject::id_t, TransformComponent>> &previous,
+    float alpha) {
+  if (alpha >= 1.f) {
+    return;
+  }
+  for (const auto &[id, transform] : previous) {
+    auto it = gameObjects.find(id);
+    if (it != gameObjects.end()) {
+      auto &current = it->second.transform;
+      current = TransformComponent::interpolate(transform, current, alpha);
+    }
+  }
+}
+
+}  // namespace lve
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "lve_camera.hpp"
+#include "lve_frame_info.hpp"
+#include "lve_game_object.hpp"
+
+// std
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace lve {
+
+// Everything the render systems read for one frame, captured at the end of a simulation step so
+// the simulation can move on to the next frame while this one is being recorded.
+struct LveRenderSnapshot {
+  uint64_t frameNumber = 0;
+  float frameTime = 0.f;
+  LveCamera camera{};
+  GlobalUbo ubo{};
+  LveGameObject::Map gameObjects{};
+
+  // Copies the render state of source. Entries that already exist are updated in place, so a
+  // snapshot that is reused every other frame stops allocating once the scene is stable.
+  void capture(const LveGameObject::Map &source);
+  // Moves every captured object that has an entry in previous that far back towards it, for
+  // rendering between the last two fixed simulation steps. alpha 1 keeps the captured state.
+  void interpolate(
+      const std::vector<std::pair<LveGameObject::id_t, TransformComponent>> &previous,
+      float alpha);
+};
+
+}  // namespace lve
@@ -1,5 +1,8 @@
 #include "lve_renderer.hpp"
 
+#include "lve_cpu_profiler.hpp"
+#include "lve_engine_events.hpp"
+
 // std
 #include <array>
 #include <cassert>
@@ -8,21 +11,50 @@
 namespace lve {
 
 LveRenderer::LveRenderer(LveWindow& window, LveDevice& device)
-    : lveWindow{window}, lveDevice{device} {
+    : lveWindow{&window}, lveDevice{device} {
   recreateSwapChain();
   createCommandBuffers();
+  createComputeCommandBuffers();
+  gpuProfiler = std::make_unique<LveGpuProfiler>(lveDevice, LveSwapChain::MAX_FRAMES_IN_FLIGHT);
+  pipelineStatistics =
+      std::make_unique<LvePipelineStatistics>(lveDevice, LveSwapChain::MAX_FRAMES_IN_FLIGHT);
+}
+
+LveRenderer::LveRenderer(LveDevice& device, VkExtent2D extent) : lveDevice{device} {
+  offscreenTarget = std::make_unique<LveOffscreenTarget>(lveDevice, extent);
+  createCommandBuffers();
+  createComputeCommandBuffers();
+  gpuProfiler = std::make_unique<LveGpuProfiler>(lveDevice, LveSwapChain::MAX_FRAMES_IN_FLIGHT);
+  pipelineStatistics =
+      std::make_unique<LvePipelineStatistics>(lveDevice, LveSwapChain::MAX_FRAMES_IN_FLIGHT);
 }
 
-LveRenderer::~LveRenderer() { freeCommandBuffers(); }
+LveRenderer::~LveRenderer() {
+  if (frameReadback) {
+    // hand the frames still in flight to the writer before it shuts down
+    lveDevice.waitIdle();
+    frameReadback->collectAll();
+  }
+  freeComputeCommandBuffers();
+  freeCommandBuffers();
+}
 
 void LveRenderer::recreateSwapChain() {
-  auto extent = lveWindow.getExtent();
+  auto extent = lveWindow->getExtent();
   while (extent.width == 0 || extent.height == 0) {
-    extent = lveWindow.getExtent();
+    extent = lveWindow->getExtent();
     glfwWaitEvents();
   }
-  vkDeviceWaitIdle(lveDevice.device());
+  LveEngineEventScope event{
+      "swapchain recreate",
+      std::to_string(extent.width) + "x" + std::to_string(extent.height)};
+  if (frameReadback) {
+    // readback buffers are sized to the old extent, so every pending capture is collected first
+    lveDevice.waitIdle();
+    frameReadback->collectAll();
+  }
 
+  // the old swap chain's objects go through the deletion queue, frames in flight keep running
   if (lveSwapChain == nullptr) {
     lveSwapChain = std::make_unique<LveSwapChain>(lveDevice, extent);
   } else {
@@ -33,10 +65,36 @@ void LveRenderer::recreateSwapChain() {
       throw std::runtime_error("Swap chain image(or depth) format has changed!");
     }
   }
+
+  if (frameReadback) {
+    createFrameReadback();
+  }
+}
+
+void LveRenderer::enableReadback(
+    const std::string& outputDirectory, LveImageWriter::Format format) {
+  assert(!isFrameStarted && "Can't enable readback while frame is in progress");
+  imageWriter = std::make_unique<LveImageWriter>(outputDirectory, format);
+  createFrameReadback();
+}
+
+void LveRenderer::createFrameReadback() {
+  VkFormat colorFormat;
+  if (isHeadless()) {
+    colorFormat = offscreenTarget->getColorFormat();
+  } else {
+    if (!lveSwapChain->supportsTransferSrc()) {
+      throw std::runtime_error("swap chain images can not be used as a transfer source!");
+    }
+    colorFormat = lveSwapChain->getSwapChainImageFormat();
+  }
+  frameReadback =
+      std::make_unique<LveFrameReadback>(lveDevice, *imageWriter, getExtent(), colorFormat);
 }
 
 void LveRenderer::createCommandBuffers() {
   commandBuffers.resize(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
+  frameSlotValues.assign(LveSwapChain::MAX_FRAMES_IN_FLIGHT, 0);
 
   VkCommandBufferAllocateInfo allocInfo{};
   allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -50,6 +108,30 @@ void LveRenderer::createCommandBuffers() {
   }
 }
 
+void LveRenderer::createComputeCommandBuffers() {
+  computeCommandBuffers.resize(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
+
+  VkCommandBufferAllocateInfo allocInfo{};
+  allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+  allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+  allocInfo.commandPool = lveDevice.getComputeCommandPool();
+  allocInfo.commandBufferCount = static_cast<uint32_t>(computeCommandBuffers.size());
+
+  if (vkAllocateCommandBuffers(lveDevice.device(), &allocInfo, computeCommandBuffers.data()) !=
+      VK_SUCCESS) {
+    throw std::runtime_error("failed to allocate compute command buffers!");
+  }
+}
+
+void LveRenderer::freeComputeCommandBuffers() {
+  vkFreeCommandBuffers(
+      lveDevice.device(),
+      lveDevice.getComputeCommandPool(),
+      static_cast<uint32_t>(computeCommandBuffers.size()),
+      computeCommandBuffers.data());
+  computeCommandBuffers.clear();
+}
+
 void LveRenderer::freeCommandBuffers() {
   vkFreeCommandBuffers(
       lveDevice.device(),
@@ -61,8 +143,19 @@ void LveRenderer::freeCommandBuffers() {
 
 VkCommandBuffer LveRenderer::beginFrame() {
   assert(!isFrameStarted && "Can't call beginFrame while already in progress");
+  LVE_CPU_ZONE("LveRenderer::beginFrame");
 
-  auto result = lveSwapChain->acquireNextImage(&currentImageIndex);
+  {
+    LVE_CPU_ZONE("frame slot wait");
+    lveDevice.getFrameTimeline().wait(frameSlotValues[currentFrameIndex]);
+  }
+  lveDevice.getDeletionQueue().collect();
+  VkResult result;
+  {
+    LVE_CPU_ZONE("acquire");
+    result = lveSwapChain ? lveSwapChain->acquireNextImage(&currentImageIndex)
+                          : offscreenTarget->acquireNextImage(&currentImageIndex);
+  }
   if (result == VK_ERROR_OUT_OF_DATE_KHR) {
     recreateSwapChain();
     return nullptr;
@@ -72,6 +165,11 @@ VkCommandBuffer LveRenderer::beginFrame() {
     throw std::runtime_error("failed to acquire swap chain image!");
   }
 
+  if (frameReadback) {
+    // the frame that last used this slot is done
+    frameReadback->collect(currentFrameIndex);
+  }
+
   isFrameStarted = true;
 
   auto commandBuffer = getCurrentCommandBuffer();
@@ -81,29 +179,133 @@ VkCommandBuffer LveRenderer::beginFrame() {
   if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
     throw std::runtime_error("failed to begin recording command buffer!");
   }
+  // uploads that finished on the transfer queue become usable from this frame on
+  transferWait = lveDevice.recordTransferAcquires(commandBuffer);
+
+  frameStats.beginFrame();
+  gpuProfiler->beginFrame(commandBuffer, currentFrameIndex, frameCounter);
+  pipelineStatistics->beginFrame(commandBuffer, currentFrameIndex);
+  frameZone = gpuProfiler->beginZone(commandBuffer, "frame");
   return commandBuffer;
 }
 
 void LveRenderer::endFrame() {
   assert(isFrameStarted && "Can't call endFrame while frame is not in progress");
+  assert(!isComputeStarted && "Can't call endFrame while compute pass is in progress");
+  LVE_CPU_ZONE("LveRenderer::endFrame");
   auto commandBuffer = getCurrentCommandBuffer();
+  if (frameReadback) {
+    if (isHeadless()) {
+      frameReadback->recordCopy(
+          commandBuffer,
+          currentFrameIndex,
+          offscreenTarget->getColorImage(currentImageIndex),
+          LveOffscreenTarget::COLOR_FINAL_LAYOUT,
+          frameCounter);
+    } else {
+      frameReadback->recordCopy(
+          commandBuffer,
+          currentFrameIndex,
+          lveSwapChain->getImage(currentImageIndex),
+          VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+          frameCounter);
+    }
+  }
+
+  gpuProfiler->endZone(commandBuffer, frameZone);
+  gpuProfiler->endFrame();
+  pipelineStatistics->endFrame();
+
   if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
     throw std::runtime_error("failed to record command buffer!");
   }
 
-  auto result = lveSwapChain->submitCommandBuffers(&commandBuffer, &currentImageIndex);
-  if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR ||
-      lveWindow.wasWindowResized()) {
-    lveWindow.resetWindowResizedFlag();
-    recreateSwapChain();
-  } else if (result != VK_SUCCESS) {
-    throw std::runtime_error("failed to present swap chain image!");
+  uint64_t frameValue = lveDevice.getFrameTimeline().nextValue();
+  frameSlotValues[currentFrameIndex] = frameValue;
+  if (isHeadless()) {
+    LVE_CPU_ZONE("submit");
+    offscreenTarget->submitCommandBuffers(
+        &commandBuffer,
+        &currentImageIndex,
+        frameValue,
+        computeWait,
+        transferWait);
+  } else {
+    VkResult result;
+    {
+      LVE_CPU_ZONE("submit + present");
+      result = lveSwapChain->submitCommandBuffers(
+          &commandBuffer,
+          &currentImageIndex,
+          frameValue,
+          computeWait,
+          transferWait);
+    }
+    if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR ||
+        lveWindow->wasWindowResized()) {
+      lveWindow->resetWindowResizedFlag();
+      recreateSwapChain();
+    } else if (result != VK_SUCCESS) {
+      throw std::runtime_error("failed to present swap chain image!");
+    }
   }
 
   isFrameStarted = false;
+  computeWait = {};
+  transferWait = {};
+  frameStats.endFrame();
+  frameCounter++;
   currentFrameIndex = (currentFrameIndex + 1) % LveSwapChain::MAX_FRAMES_IN_FLIGHT;
 }
 
+VkCommandBuffer LveRenderer::beginCompute() {
+  assert(isFrameStarted && "Can't call beginCompute if frame is not in progress");
+  assert(
+      !isComputeStarted && computeWait.semaphore == VK_NULL_HANDLE &&
+      "Only one compute pass can be recorded per frame");
+
+  // beginFrame waited for this slot's previous graphics submit, which waited for its compute pass
+  auto commandBuffer = computeCommandBuffers[currentFrameIndex];
+  VkCommandBufferBeginInfo beginInfo{};
+  beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+    throw std::runtime_error("failed to begin recording compute command buffer!");
+  }
+  isComputeStarted = true;
+  return commandBuffer;
+}
+
+void LveRenderer::endCompute(VkPipelineStageFlags graphicsWaitStage) {
+  assert(isComputeStarted && "Can't call endCompute if compute pass is not in progress");
+  assert(graphicsWaitStage != 0 && "Graphics work must wait for the compute pass at some stage");
+  LVE_CPU_ZONE("compute submit");
+  auto commandBuffer = computeCommandBuffers[currentFrameIndex];
+  if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+    throw std::runtime_error("failed to record compute command buffer!");
+  }
+
+  auto& computeTimeline = lveDevice.getComputeTimeline();
+  computeWait = computeTimeline.point(computeTimeline.nextValue(), graphicsWaitStage);
+
+  VkTimelineSemaphoreSubmitInfo timelineInfo{};
+  timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+  timelineInfo.signalSemaphoreValueCount = 1;
+  timelineInfo.pSignalSemaphoreValues = &computeWait.value;
+
+  VkSubmitInfo submitInfo{};
+  submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+  submitInfo.pNext = &timelineInfo;
+  submitInfo.commandBufferCount = 1;
+  submitInfo.pCommandBuffers = &commandBuffer;
+  submitInfo.signalSemaphoreCount = 1;
+  submitInfo.pSignalSemaphores = &computeWait.semaphore;
+  if (lveDevice.queueSubmit(lveDevice.computeQueue(), 1, &submitInfo) != VK_SUCCESS) {
+    throw std::runtime_error("failed to submit compute command buffer!");
+  }
+  isComputeStarted = false;
+}
+
 void LveRenderer::beginSwapChainRenderPass(VkCommandBuffer commandBuffer) {
   assert(isFrameStarted && "Can't call beginSwapChainRenderPass if frame is not in progress");
   assert(
@@ -112,11 +314,13 @@ void LveRenderer::beginSwapChainRenderPass(VkCommandBuffer commandBuffer) {
 
   VkRenderPassBeginInfo renderPassInfo{};
   renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-  renderPassInfo.renderPass = lveSwapChain->getRenderPass();
-  renderPassInfo.framebuffer = lveSwapChain->getFrameBuffer(currentImageIndex);
+  renderPassInfo.renderPass = getSwapChainRenderPass();
+  renderPassInfo.framebuffer = lveSwapChain ? lveSwapChain->getFrameBuffer(currentImageIndex)
+                                            : offscreenTarget->getFrameBuffer(currentImageIndex);
 
+  VkExtent2D extent = getExtent();
   renderPassInfo.renderArea.offset = {0, 0};
-  renderPassInfo.renderArea.extent = lveSwapChain->getSwapChainExtent();
+  renderPassInfo.renderArea.extent = extent;
 
   std::array<VkClearValue, 2> clearValues{};
   clearValues[0].color = {0.01f, 0.01f, 0.01f, 1.0f};
@@ -129,11 +333,11 @@ void LveRenderer::beginSwapChainRenderPass(VkCommandBuffer commandBuffer) {
   VkViewport viewport{};
   viewport.x = 0.0f;
   viewport.y = 0.0f;
-  viewport.width = static_cast<float>(lveSwapChain->getSwapChainExtent().width);
-  viewport.height = static_cast<float>(lveSwapChain->getSwapChainExtent().height);
+  viewport.width = static_cast<float>(extent.width);
+  viewport.height = static_cast<float>(extent.height);
   viewport.minDepth = 0.0f;
   viewport.maxDepth = 1.0f;
-  VkRect2D scissor{{0, 0}, lveSwapChain->getSwapChainExtent()};
+  VkRect2D scissor{{0, 0}, extent};
   vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
   vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 }
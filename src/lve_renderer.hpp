@@ -1,26 +1,50 @@
 #pragma once
 
 #include "lve_device.hpp"
+#include "lve_frame_readback.hpp"
+#include "lve_frame_stats.hpp"
+#include "lve_gpu_profiler.hpp"
+#include "lve_image_writer.hpp"
+#include "lve_offscreen_target.hpp"
+#include "lve_pipeline_statistics.hpp"
 #include "lve_swap_chain.hpp"
 #include "lve_window.hpp"
 
 // std
 #include <cassert>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace lve {
 class LveRenderer {
  public:
   LveRenderer(LveWindow &window, LveDevice &device);
+  // headless renderer: frames go to an offscreen target of the given extent instead of a swapchain
+  LveRenderer(LveDevice &device, VkExtent2D extent);
   ~LveRenderer();
 
   LveRenderer(const LveRenderer &) = delete;
   LveRenderer &operator=(const LveRenderer &) = delete;
 
-  VkRenderPass getSwapChainRenderPass() const { return lveSwapChain->getRenderPass(); }
-  float getAspectRatio() const { return lveSwapChain->extentAspectRatio(); }
+  VkRenderPass getSwapChainRenderPass() const {
+    return lveSwapChain ? lveSwapChain->getRenderPass() : offscreenTarget->getRenderPass();
+  }
+  float getAspectRatio() const {
+    return lveSwapChain ? lveSwapChain->extentAspectRatio() : offscreenTarget->extentAspectRatio();
+  }
+  VkExtent2D getExtent() const {
+    return lveSwapChain ? lveSwapChain->getSwapChainExtent() : offscreenTarget->getExtent();
+  }
+  bool isHeadless() const { return offscreenTarget != nullptr; }
   bool isFrameInProgress() const { return isFrameStarted; }
+  // number of the frame being recorded, or of the next one between frames
+  uint64_t getFrameNumber() const { return frameCounter; }
+  // Frame timeline value the current frame will signal, or the next frame between frames. Once
+  // the frame timeline reaches it, the GPU is done with everything recorded until now.
+  uint64_t getFrameTimelineValue() const {
+    return lveDevice.getFrameTimeline().getLastValue() + 1;
+  }
 
   VkCommandBuffer getCurrentCommandBuffer() const {
     assert(isFrameStarted && "Cannot get command buffer when frame not in progress");
@@ -32,23 +56,62 @@ class LveRenderer {
     return currentFrameIndex;
   }
 
+  // GPU timings of the "frame" zone and any zones recorded into the current command buffer
+  LveGpuProfiler &getGpuProfiler() { return *gpuProfiler; }
+  // vertex/clipping/fragment counts of scopes recorded into the current command buffer, disabled
+  // by default
+  LvePipelineStatistics &getPipelineStatistics() { return *pipelineStatistics; }
+
+  // Workload counters: getCurrent() while recording, completed frames in the rolling windows
+  LveFrameStats &getFrameStats() { return frameStats; }
+
+  // Captures the color image of every following frame into outputDirectory. Images are read back
+  // asynchronously once their frame retires and encoded on a background thread.
+  void enableReadback(const std::string &outputDirectory, LveImageWriter::Format format);
+
   VkCommandBuffer beginFrame();
   void endFrame();
+  // Async compute pass of the current frame, recorded between beginFrame and endFrame. endCompute
+  // submits it to the compute queue right away, so it overlaps the previous frame's rasterization,
+  // and the frame's graphics submit waits for it at graphicsWaitStage.
+  VkCommandBuffer beginCompute();
+  void endCompute(VkPipelineStageFlags graphicsWaitStage);
   void beginSwapChainRenderPass(VkCommandBuffer commandBuffer);
   void endSwapChainRenderPass(VkCommandBuffer commandBuffer);
 
  private:
   void createCommandBuffers();
   void freeCommandBuffers();
+  void createComputeCommandBuffers();
+  void freeComputeCommandBuffers();
   void recreateSwapChain();
+  void createFrameReadback();
 
-  LveWindow &lveWindow;
+  LveWindow *lveWindow = nullptr;
   LveDevice &lveDevice;
   std::unique_ptr<LveSwapChain> lveSwapChain;
+  std::unique_ptr<LveOffscreenTarget> offscreenTarget;
   std::vector<VkCommandBuffer> commandBuffers;
+  std::vector<VkCommandBuffer> computeCommandBuffers;
+  // frame timeline value each frame slot signaled last, waited for before the slot is reused
+  std::vector<uint64_t> frameSlotValues;
+
+  // note: writer must outlive the readback that feeds it
+  std::unique_ptr<LveImageWriter> imageWriter;
+  std::unique_ptr<LveFrameReadback> frameReadback;
+  std::unique_ptr<LveGpuProfiler> gpuProfiler;
+  std::unique_ptr<LvePipelineStatistics> pipelineStatistics;
+  LveFrameStats frameStats{};
 
   uint32_t currentImageIndex;
+  uint64_t frameCounter{0};
   int currentFrameIndex{0};
+  int frameZone{-1};
   bool isFrameStarted{false};
+  bool isComputeStarted{false};
+  // compute pass submitted for the current frame, no semaphore when there is none
+  LveTimelinePoint computeWait{};
+  // uploads the frame's command buffer acquired, no semaphore when there are none
+  LveTimelinePoint transferWait{};
 };
 }  // namespace lve
@@ -0,0 +1,354 @@
+#include "lve_scene.hpp"
+
+// std
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+
+#ifndef ENGINE_DIR
+#define ENGINE_DIR "../"
+#endif
+
+namespace lve {
+
+namespace {
+
+// *************** Binary format *********************
+// header | model paths (uint32 length + characters each) | lights | instances, sections start on
+// 16 byte boundaries. Values are stored in native byte order.
+
+constexpr char BINARY_MAGIC[4] = {'L', 'V', 'S', 'C'};
+constexpr uint32_t BINARY_VERSION = 2;
+constexpr uint64_t SECTION_ALIGNMENT = 16;
+
+struct BinaryHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t modelCount;
+  uint32_t lightCount;
+  uint64_t instanceCount;
+  uint64_t modelPathsOffset;
+  uint64_t lightsOffset;
+  uint64_t instancesOffset;
+};
+
+static_assert(std::is_trivially_copyable<LveScene::Instance>::value, "instances are mapped as is");
+static_assert(sizeof(LveScene::Instance) == 48, "instance layout is part of the binary format");
+static_assert(sizeof(LveScene::Light) == 36, "light layout is part of the binary format");
+
+// instances a single array or scatter line may create
+constexpr int64_t MAX_REPEAT_COUNT = 10000000;
+
+uint64_t alignSection(uint64_t offset) {
+  return (offset + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1);
+}
+
+bool readVec3(std::istream &in, glm::vec3 &value) {
+  return static_cast<bool>(in >> value.x >> value.y >> value.z);
+}
+
+// uniform in [min, max) from the raw generator output, unlike std::uniform_real_distribution it
+// gives the same numbers with every standard library
+float uniform(std::mt19937 &rng, float min, float max) {
+  return min + (max - min) * static_cast<float>(rng() >> 8) * (1.f / 16777216.f);
+}
+
+}  // namespace
+
+LveScene LveScene::loadFromFile(const std::string &filepath) {
+  std::string path = filepath;
+  if (!std::filesystem::exists(path)) {
+    path = ENGINE_DIR + filepath;
+  }
+  std::ifstream file{path, std::ios::binary};
+  if (!file.is_open()) {
+    throw std::runtime_error("failed to open scene file: " + filepath);
+  }
+
+  char magic[sizeof(BINARY_MAGIC)]{};
+  file.read(magic, sizeof(magic));
+  if (file.gcount() == sizeof(magic) && std::memcmp(magic, BINARY_MAGIC, sizeof(magic)) == 0) {
+    file.close();
+    return loadBinary(std::make_unique<LveMappedFile>(path), filepath);
+  }
+  file.clear();
+  file.seekg(0);
+  return parseText(file, filepath);
+}
+
+LveScene LveScene::parseText(std::istream &in, const std::string &name) {
+  LveScene scene{};
+  std::unordered_map<std::string, uint32_t> modelIndices;
+  // group names to instance indices, and the group new instances are placed in
+  std::unordered_map<std::string, uint32_t> groupIndices;
+  uint32_t currentParent = NO_PARENT;
+  std::string line;
+  int lineNumber = 0;
+  while (std::getline(in, line)) {
+    lineNumber++;
+    std::istringstream stream{line};
+    std::string command;
+    if (!(stream >> command) || command[0] == '#') continue;
+
+    auto error = [&](const std::string &reason) {
+      return std::runtime_error(
+          reason + " on line " + std::to_string(lineNumber) + " of scene " + name);
+    };
+    auto readModel = [&]() {
+      std::string modelName;
+      stream >> modelName;
+      auto index = modelIndices.find(modelName);
+      if (index == modelIndices.end()) {
+        throw error("unknown model '" + modelName + "'");
+      }
+      return index->second;
+    };
+    // read signed, so a negative count is reported instead of wrapping around
+    auto readCount = [&](const std::string &what) {
+      int64_t count;
+      if (!(stream >> count)) {
+        throw error("invalid " + what);
+      }
+      if (count < 0 || count > MAX_REPEAT_COUNT) {
+        throw error(
+            what + " count " + std::to_string(count) + " outside [0, " +
+            std::to_string(MAX_REPEAT_COUNT) + "]");
+      }
+      return static_cast<uint32_t>(count);
+    };
+    // optional trailing flag, objects and lights are dynamic unless marked static
+    auto readFlags = [&]() {
+      uint32_t flags = 0;
+      std::string word;
+      if (stream >> word) {
+        if (word == "static") {
+          flags = FLAG_STATIC;
+        } else if (word != "dynamic") {
+          throw error("unknown flag '" + word + "'");
+        }
+      }
+      if (stream >> word) {
+        throw error("unexpected '" + word + "'");
+      }
+      return flags;
+    };
+
+    if (command == "model") {
+      // model <name> <path>
+      std::string modelName, path;
+      if (!(stream >> modelName >> path)) {
+        throw error("invalid model");
+      }
+      if (!modelIndices.emplace(modelName, static_cast<uint32_t>(scene.modelPaths.size())).second) {
+        throw error("duplicate model '" + modelName + "'");
+      }
+      scene.modelPaths.push_back(path);
+    } else if (command == "group") {
+      // group <name> <translation> <rotation> <scale> [static|dynamic]
+      std::string groupName;
+      Instance instance{};
+      instance.model = NO_MODEL;
+      instance.parent = currentParent;
+      if (!(stream >> groupName) || !readVec3(stream, instance.translation) ||
+          !readVec3(stream, instance.rotation) || !readVec3(stream, instance.scale)) {
+        throw error("invalid group");
+      }
+      instance.flags = readFlags();
+      const auto index = static_cast<uint32_t>(scene.ownedInstances.size());
+      if (!groupIndices.emplace(groupName, index).second) {
+        throw error("duplicate group '" + groupName + "'");
+      }
+      scene.ownedInstances.push_back(instance);
+    } else if (command == "parent") {
+      // parent [<group>], without a group the following instances are top level again
+      std::string groupName;
+      if (!(stream >> groupName)) {
+        currentParent = NO_PARENT;
+        continue;
+      }
+      auto group = groupIndices.find(groupName);
+      if (group == groupIndices.end()) {
+        throw error("unknown group '" + groupName + "'");
+      }
+      currentParent = group->second;
+      if (stream >> groupName) {
+        throw error("unexpected '" + groupName + "'");
+      }
+    } else if (command == "object") {
+      // object <model> <translation> <rotation> <scale> [static|dynamic]
+      Instance instance{};
+      instance.model = readModel();
+      instance.parent = currentParent;
+      if (!readVec3(stream, instance.translation) || !readVec3(stream, instance.rotation) ||
+          !readVec3(stream, instance.scale)) {
+        throw error("invalid object");
+      }
+      instance.flags = readFlags();
+      scene.ownedInstances.push_back(instance);
+    } else if (command == "array") {
+      // array <model> <count> <first translation> <step> <rotation> <scale> [static|dynamic]
+      Instance instance{};
+      instance.model = readModel();
+      instance.parent = currentParent;
+      const uint32_t count = readCount("array");
+      glm::vec3 step;
+      if (!readVec3(stream, instance.translation) ||
+          !readVec3(stream, step) || !readVec3(stream, instance.rotation) ||
+          !readVec3(stream, instance.scale)) {
+        throw error("invalid array");
+      }
+      instance.flags = readFlags();
+      for (uint32_t i = 0; i < count; i++) {
+        scene.ownedInstances.push_back(instance);
+        instance.translation += step;
+      }
+    } else if (command == "scatter") {
+      // scatter <model> <count> <seed> <min x z> <max x z> <y> <min max scale> <rotation> [flags]
+      // places count instances uniformly in the rectangle, the same seed gives the same layout
+      Instance instance{};
+      instance.model = readModel();
+      instance.parent = currentParent;
+      const uint32_t count = readCount("scatter");
+      uint32_t seed;
+      glm::vec2 min, max;
+      float y, minScale, maxScale;
+      if (!(stream >> seed >> min.x >> min.y >> max.x >> max.y >> y >> minScale >>
+            maxScale) ||
+          !readVec3(stream, instance.rotation)) {
+        throw error("invalid scatter");
+      }
+      instance.flags = readFlags();
+      std::mt19937 rng{seed};
+      for (uint32_t i = 0; i < count; i++) {
+        const float x = uniform(rng, min.x, max.x);
+        const float z = uniform(rng, min.y, max.y);
+        instance.translation = {x, y, z};
+        instance.scale = glm::vec3{uniform(rng, minScale, maxScale)};
+        scene.ownedInstances.push_back(instance);
+      }
+    } else if (command == "light") {
+      // light <intensity> <radius> <color> <position> [static|dynamic]
+      Light light{};
+      if (!(stream >> light.intensity >> light.radius) || !readVec3(stream, light.color) ||
+          !readVec3(stream, light.position)) {
+        throw error("invalid light");
+      }
+      light.flags = readFlags();
+      scene.lights.push_back(light);
+    } else {
+      throw error("unknown command '" + command + "'");
+    }
+  }
+  return scene;
+}
+
+LveScene LveScene::loadBinary(std::unique_ptr<LveMappedFile> file, const std::string &filepath) {
+  auto invalid = [&](const std::string &reason) {
+    return std::runtime_error("invalid binary scene " + filepath + ": " + reason);
+  };
+  const uint8_t *data = file->data();
+  const uint64_t size = file->size();
+
+  BinaryHeader header;
+  if (size < sizeof(header)) {
+    throw invalid("truncated header");
+  }
+  std::memcpy(&header, data, sizeof(header));
+  if (header.version != BINARY_VERSION) {
+    throw invalid("unsupported version " + std::to_string(header.version));
+  }
+  if (header.lightsOffset > size ||
+      header.lightCount > (size - header.lightsOffset) / sizeof(Light)) {
+    throw invalid("lights out of bounds");
+  }
+  if (header.instancesOffset % alignof(Instance) != 0 || header.instancesOffset > size ||
+      header.instanceCount > (size - header.instancesOffset) / sizeof(Instance)) {
+    throw invalid("instances out of bounds");
+  }
+
+  LveScene scene{};
+  uint64_t offset = header.modelPathsOffset;
+  for (uint32_t i = 0; i < header.modelCount; i++) {
+    uint32_t length;
+    if (offset > size || size - offset < sizeof(length)) {
+      throw invalid("model paths out of bounds");
+    }
+    std::memcpy(&length, data + offset, sizeof(length));
+    offset += sizeof(length);
+    if (size - offset < length) {
+      throw invalid("model paths out of bounds");
+    }
+    scene.modelPaths.emplace_back(reinterpret_cast<const char *>(data + offset), length);
+    offset += length;
+  }
+
+  scene.lights.resize(header.lightCount);
+  if (header.lightCount > 0) {
+    std::memcpy(scene.lights.data(), data + header.lightsOffset, header.lightCount * sizeof(Light));
+  }
+
+  scene.mappedInstances = reinterpret_cast<const Instance *>(data + header.instancesOffset);
+  scene.mappedInstanceCount = static_cast<size_t>(header.instanceCount);
+  for (size_t i = 0; i < scene.mappedInstanceCount; i++) {
+    const auto &instance = scene.mappedInstances[i];
+    if (instance.model >= header.modelCount && instance.model != NO_MODEL) {
+      throw invalid("instance " + std::to_string(i) + " references a missing model");
+    }
+    // parents come first, which also rules out cycles
+    if (instance.parent >= i && instance.parent != NO_PARENT) {
+      throw invalid("instance " + std::to_string(i) + " references a later parent");
+    }
+  }
+  scene.mapping = std::move(file);
+  return scene;
+}
+
+void LveScene::writeBinary(const std::string &filepath) const {
+  std::ofstream file{filepath, std::ios::binary};
+  if (!file.is_open()) {
+    throw std::runtime_error("failed to write scene file: " + filepath);
+  }
+
+  BinaryHeader header{};
+  std::memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+  header.version = BINARY_VERSION;
+  header.modelCount = static_cast<uint32_t>(modelPaths.size());
+  header.lightCount = static_cast<uint32_t>(lights.size());
+  header.instanceCount = getInstanceCount();
+  header.modelPathsOffset = sizeof(BinaryHeader);
+  uint64_t pathsSize = 0;
+  for (const auto &path : modelPaths) {
+    pathsSize += sizeof(uint32_t) + path.size();
+  }
+  header.lightsOffset = alignSection(header.modelPathsOffset + pathsSize);
+  header.instancesOffset = alignSection(header.lightsOffset + lights.size() * sizeof(Light));
+
+  const char padding[SECTION_ALIGNMENT]{};
+  auto padTo = [&](uint64_t offset) {
+    file.write(padding, static_cast<std::streamsize>(offset - static_cast<uint64_t>(file.tellp())));
+  };
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  for (const auto &path : modelPaths) {
+    uint32_t length = static_cast<uint32_t>(path.size());
+    file.write(reinterpret_cast<const char *>(&length), sizeof(length));
+    file.write(path.data(), length);
+  }
+  padTo(header.lightsOffset);
+  file.write(
+      reinterpret_cast<const char *>(lights.data()),
+      static_cast<std::streamsize>(lights.size() * sizeof(Light)));
+  padTo(header.instancesOffset);
+  file.write(
+      reinterpret_cast<const char *>(getInstances()),
+      static_cast<std::streamsize>(getInstanceCount() * sizeof(Instance)));
+  if (!file) {
+    throw std::runtime_error("failed to write scene file: " + filepath);
+  }
+}
+
+}  // namespace lve
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "lve_mapped_file.hpp"
+
+// libs
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+// std
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lve {
+
+// Scene description: the models it uses, where instances of them are placed, the groups placing
+// instances relative to each other and its point lights.
+// Scenes are written as text (see scenes/park.scene for the syntax) and can be compiled to a
+// binary form whose instance array is used straight from a memory mapping of the file.
+class LveScene {
+ public:
+  // static objects never move, systems that animate the scene leave them alone
+  static constexpr uint32_t FLAG_STATIC = 1u << 0;
+  // model of a group, which only places its children
+  static constexpr uint32_t NO_MODEL = ~0u;
+  static constexpr uint32_t NO_PARENT = ~0u;
+
+  // plain data, the binary file stores an array of these as is
+  struct Instance {
+    glm::vec3 translation{};
+    glm::vec3 rotation{};
+    glm::vec3 scale{1.f};
+    uint32_t model = 0;  // index into getModelPaths or NO_MODEL
+    uint32_t flags = 0;
+    // index of an earlier instance the transform is relative to, or NO_PARENT
+    uint32_t parent = NO_PARENT;
+  };
+
+  struct Light {
+    glm::vec3 position{};
+    glm::vec3 color{1.f};
+    float intensity = 1.f;
+    float radius = .1f;
+    uint32_t flags = 0;
+  };
+
+  // Loads a text or binary scene, told apart by the binary header. Relative paths are tried as
+  // given and then relative to the engine directory, like model paths.
+  static LveScene loadFromFile(const std::string &filepath);
+  // name is only used in error messages
+  static LveScene parseText(std::istream &in, const std::string &name);
+  void writeBinary(const std::string &filepath) const;
+
+  const std::vector<std::string> &getModelPaths() const { return modelPaths; }
+  const Instance *getInstances() const {
+    return mapping ? mappedInstances : ownedInstances.data();
+  }
+  size_t getInstanceCount() const { return mapping ? mappedInstanceCount : ownedInstances.size(); }
+  const std::vector<Light> &getLights() const { return lights; }
+
+ private:
+  static LveScene loadBinary(std::unique_ptr<LveMappedFile> file, const std::string &filepath);
+
+  std::vector<std::string> modelPaths;
+  std::vector<Light> lights;
+  std::vector<Instance> ownedInstances;
+  // binary scenes keep the file mapped and point into it instead of copying the instances
+  std::unique_ptr<LveMappedFile> mapping;
+  const Instance *mappedInstances = nullptr;
+  size_t mappedInstanceCount = 0;
+};
+
+}  // namespace lve
@@ -0,0 +1,118 @@
+#include "lve_scene_index.hpp"
+
+#include "lve_cpu_profiler.hpp"
+
+// std
+#include <unordered_set>
+
+namespace lve {
+
+void LveSceneIndex::build(LveGameObject::Map &gameObjects, LveJobSystem *jobSystem) {
+  std::vector<LveBvh::Item> items;
+  for (auto &kv : gameObjects) {
+    if (kv.second.model == nullptr) continue;
+    items.push_back({computeWorldAabb(kv.second), kv.first, kv.second.isStatic});
+  }
+  build(std::move(items), jobSystem);
+}
+
+void LveSceneIndex::build(std::vector<LveBvh::Item> items, LveJobSystem *jobSystem) {
+  LVE_CPU_ZONE("LveSceneIndex::build");
+  std::vector<LveBvh::Item> staticItems;
+  dynamicObjects.clear();
+  for (auto &item : items) {
+    if (item.isStatic) {
+      staticItems.push_back(item);
+    } else {
+      dynamicObjects.insert(item.id, item.bounds);
+    }
+  }
+  staticObjects.build(std::move(staticItems), jobSystem);
+}
+
+void LveSceneIndex::update(LveGameObject::Map &gameObjects) {
+  std::vector<LveBvh::Item> items;
+  for (auto &kv : gameObjects) {
+    if (kv.second.model == nullptr || kv.second.isStatic) continue;
+    items.push_back({computeWorldAabb(kv.second), kv.first, false});
+  }
+  update(items);
+}
+
+void LveSceneIndex::update(const std::vector<LveBvh::Item> &items) {
+  LVE_CPU_ZONE("LveSceneIndex::update");
+  std::unordered_set<LveGameObject::id_t> current;
+  for (auto &item : items) {
+    if (!item.isStatic) {
+      current.insert(item.id);
+    }
+  }
+  for (LveGameObject::id_t id : dynamicObjects.getIds()) {
+    if (current.count(id) == 0) {
+      dynamicObjects.remove(id);
+    }
+  }
+  for (auto &item : items) {
+    if (item.isStatic) continue;
+    dynamicObjects.update(item.id, item.bounds);
+  }
+}
+
+void LveSceneIndex::queryFrustums(
+    const std::vector<LveFrustum> &frustums,
+    std::vector<std::vector<LveGameObject::id_t>> &visible) const {
+  staticObjects.queryFrustums(frustums, visible);
+  std::vector<std::vector<LveGameObject::id_t>> dynamicVisible;
+  dynamicObjects.queryFrustums(frustums, dynamicVisible);
+  for (size_t v = 0; v < frustums.size(); v++) {
+    visible[v].insert(visible[v].end(), dynamicVisible[v].begin(), dynamicVisible[v].end());
+  }
+}
+
+void LveSceneIndex::querySphere(
+    const glm::vec3 &center, float radius, std::vector<LveGameObject::id_t> &results) const {
+  staticObjects.querySphere(center, radius, results);
+  dynamicObjects.querySphere(center, radius, results);
+}
+
+void LveSceneIndex::querySpheres(
+    const std::vector<LveBoundingSphere> &spheres,
+    std::vector<std::vector<LveGameObject::id_t>> &results,
+    LveJobSystem *jobSystem) const {
+  staticObjects.querySpheres(spheres, results, jobSystem);
+  std::vector<std::vector<LveGameObject::id_t>> dynamicResults;
+  dynamicObjects.querySpheres(spheres, dynamicResults, jobSystem);
+  for (size_t i = 0; i < spheres.size(); i++) {
+    results[i].insert(results[i].end(), dynamicResults[i].begin(), dynamicResults[i].end());
+  }
+}
+
+LveBvh::RayHit LveSceneIndex::intersectRay(const LveRay &ray) const {
+  LveBvh::RayHit staticHit = staticObjects.intersectRay(ray);
+  LveRay closer = ray;
+  if (staticHit.hit) {
+    closer.maxDistance = staticHit.distance;
+  }
+  LveBvh::RayHit dynamicHit = dynamicObjects.intersectRay(closer);
+  return dynamicHit.hit ? dynamicHit : staticHit;
+}
+
+void LveSceneIndex::intersectRays(
+    const std::vector<LveRay> &rays,
+    std::vector<LveBvh::RayHit> &hits,
+    LveJobSystem *jobSystem) const {
+  LVE_CPU_ZONE("LveSceneIndex::intersectRays");
+  hits.resize(rays.size());
+  auto query = [&](uint32_t begin, uint32_t end) {
+    for (uint32_t i = begin; i < end; i++) {
+      hits[i] = intersectRay(rays[i]);
+    }
+  };
+  if (jobSystem != nullptr) {
+    jobSystem->parallelFor(static_cast<uint32_t>(rays.size()), 64, query);
+  } else {
+    query(0, static_cast<uint32_t>(rays.size()));
+  }
+}
+
+}  // namespace lve
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "lve_bvh.hpp"
+#include "lve_frustum.hpp"
+#include "lve_game_object.hpp"
+#include "lve_job_system.hpp"
+#include "lve_spatial_hash.hpp"
+
+// std
+#include <vector>
+
+namespace lve {
+
+// Spatial index over a whole scene: static objects in a BVH that is only rebuilt when the static
+// set changes, moving objects in a loose grid that is cheap to update every frame. Queries search
+// both and merge the results.
+class LveSceneIndex {
+ public:
+  explicit LveSceneIndex(float cellSize = 8.f) : dynamicObjects{cellSize} {}
+
+  void build(LveGameObject::Map &gameObjects, LveJobSystem *jobSystem = nullptr);
+  // items marked static go to the BVH, the others to the grid
+  void build(std::vector<LveBvh::Item> items, LveJobSystem *jobSystem = nullptr);
+  // Moves the dynamic objects to their current bounds, adding new ones and dropping removed ones.
+  // Static objects added or removed since the build need a rebuild.
+  void update(LveGameObject::Map &gameObjects);
+  // items are the whole current scene, static ones are skipped
+  void update(const std::vector<LveBvh::Item> &items);
+
+  void queryFrustums(
+      const std::vector<LveFrustum> &frustums,
+      std::vector<std::vector<LveGameObject::id_t>> &visible) const;
+  void querySphere(
+      const glm::vec3 &center, float radius, std::vector<LveGameObject::id_t> &results) const;
+  void querySpheres(
+      const std::vector<LveBoundingSphere> &spheres,
+      std::vector<std::vector<LveGameObject::id_t>> &results,
+      LveJobSystem *jobSystem = nullptr) const;
+  LveBvh::RayHit intersectRay(const LveRay &ray) const;
+  void intersectRays(
+      const std::vector<LveRay> &rays,
+      std::vector<LveBvh::RayHit> &hits,
+      LveJobSystem *jobSystem = nullptr) const;
+
+  size_t getItemCount() const {
+    return staticObjects.getItemCount() + dynamicObjects.getItemCount();
+  }
+  const LveBvh &getStaticObjects() const { return staticObjects; }
+  const LveSpatialHash &getDynamicObjects() const { return dynamicObjects; }
+
+ private:
+  LveBvh staticObjects;
+  LveSpatialHash dynamicObjects;
+};
+
+}  // namespace lve
@@ -0,0 +1,245 @@
+#include "lve_spatial_hash.hpp"
+
+#include "lve_cpu_profiler.hpp"
+
+// std
+#include <cmath>
+
+namespace lve {
+
+LveSpatialHash::LveSpatialHash(float cellSize) : cellSize{cellSize} {}
+
+glm::ivec3 LveSpatialHash::cellCoord(const glm::vec3 &point) const {
+  return glm::ivec3{glm::floor(point / cellSize)};
+}
+
+uint64_t LveSpatialHash::cellKey(const glm::ivec3 &coord) {
+  // 21 bits per axis, cells further than a million cells from the origin wrap around
+  constexpr uint64_t mask = (1u << 21) - 1;
+  return (static_cast<uint64_t>(coord.x) & mask) << 42 |
+         (static_cast<uint64_t>(coord.y) & mask) << 21 | (static_cast<uint64_t>(coord.z) & mask);
+}
+
+LveAabb LveSpatialHash::looseBounds(const Cell &cell) const {
+  glm::vec3 min = glm::vec3{cell.coord} * cellSize;
+  return {min - maxHalfExtent, min + glm::vec3{cellSize} + maxHalfExtent};
+}
+
+// *************** Updates *********************
+
+void LveSpatialHash::insert(LveGameObject::id_t id, const LveAabb &bounds) {
+  if (contains(id)) {
+    update(id, bounds);
+    return;
+  }
+  auto index = static_cast<uint32_t>(entries.size());
+  entries.push_back({bounds, id, 0, 0});
+  entryIndices[id] = index;
+  addToCell(index);
+}
+
+void LveSpatialHash::update(LveGameObject::id_t id, const LveAabb &bounds) {
+  auto index = entryIndices.find(id);
+  if (index == entryIndices.end()) {
+    insert(id, bounds);
+    return;
+  }
+  Entry &entry = entries[index->second];
+  entry.bounds = bounds;
+  maxHalfExtent = glm::max(maxHalfExtent, .5f * (bounds.max - bounds.min));
+  if (cellKey(cellCoord(bounds.center())) != entry.cellKey) {
+    removeFromCell(index->second);
+    addToCell(index->second);
+  }
+}
+
+void LveSpatialHash::remove(LveGameObject::id_t id) {
+  auto index = entryIndices.find(id);
+  if (index == entryIndices.end()) {
+    return;
+  }
+  const uint32_t removed = index->second;
+  entryIndices.erase(index);
+  removeFromCell(removed);
+
+  // keep entries packed by moving the last one into the gap
+  const auto last = static_cast<uint32_t>(entries.size() - 1);
+  if (removed != last) {
+    entries[removed] = entries[last];
+    entryIndices[entries[removed].id] = removed;
+    cells[entries[removed].cellKey].entries[entries[removed].slot] = removed;
+  }
+  entries.pop_back();
+}
+
+void LveSpatialHash::clear() {
+  entries.clear();
+  entryIndices.clear();
+  cells.clear();
+  maxHalfExtent = glm::vec3{0.f};
+}
+
+void LveSpatialHash::addToCell(uint32_t entryIndex) {
+  Entry &entry = entries[entryIndex];
+  maxHalfExtent = glm::max(maxHalfExtent, .5f * (entry.bounds.max - entry.bounds.min));
+  glm::ivec3 coord = cellCoord(entry.bounds.center());
+  entry.cellKey = cellKey(coord);
+  Cell &cell = cells[entry.cellKey];
+  cell.coord = coord;
+  entry.slot = static_cast<uint32_t>(cell.entries.size());
+  cell.entries.push_back(entryIndex);
+}
+
+void LveSpatialHash::removeFromCell(uint32_t entryIndex) {
+  const Entry &entry = entries[entryIndex];
+  auto cell = cells.find(entry.cellKey);
+  auto &cellEntries = cell->second.entries;
+  const uint32_t moved = cellEntries.back();
+  cellEntries[entry.slot] = moved;
+  entries[moved].slot = entry.slot;
+  cellEntries.pop_back();
+  if (cellEntries.empty()) {
+    cells.erase(cell);
+  }
+}
+
+std::vector<LveGameObject::id_t> LveSpatialHash::getIds() const {
+  std::vector<LveGameObject::id_t> ids;
+  ids.reserve(entries.size());
+  for (const auto &entry : entries) {
+    ids.push_back(entry.id);
+  }
+  return ids;
+}
+
+// *************** Queries *********************
+
+void LveSpatialHash::queryFrustums(
+    const std::vector<LveFrustum> &frustums,
+    std::vector<std::vector<LveGameObject::id_t>> &visible) const {
+  LVE_CPU_ZONE("LveSpatialHash::queryFrustums");
+  visible.resize(frustums.size());
+  for (auto &list : visible) {
+    list.clear();
+  }
+
+  std::vector<uint32_t> views;
+  for (const auto &kv : cells) {
+    const Cell &cell = kv.second;
+    LveAabb bounds = looseBounds(cell);
+    views.clear();
+    for (uint32_t v = 0; v < frustums.size(); v++) {
+      if (frustums[v].intersectsAabb(bounds.min, bounds.max)) {
+        views.push_back(v);
+      }
+    }
+    if (views.empty()) continue;
+
+    for (uint32_t entryIndex : cell.entries) {
+      const Entry &entry = entries[entryIndex];
+      for (uint32_t v : views) {
+        if (frustums[v].intersectsAabb(entry.bounds.min, entry.bounds.max)) {
+          visible[v].push_back(entry.id);
+        }
+      }
+    }
+  }
+}
+
+void LveSpatialHash::querySphere(
+    const glm::vec3 &center, float radius, std::vector<LveGameObject::id_t> &results) const {
+  auto queryCell = [&](const Cell &cell) {
+    for (uint32_t entryIndex : cell.entries) {
+      if (entries[entryIndex].bounds.intersectsSphere(center, radius)) {
+        results.push_back(entries[entryIndex].id);
+      }
+    }
+  };
+
+  // any box touching the sphere has its center, and so its cell, within this range
+  glm::vec3 reach = glm::vec3{radius} + maxHalfExtent;
+  glm::ivec3 first = cellCoord(center - reach);
+  glm::ivec3 last = cellCoord(center + reach);
+  glm::vec3 range = glm::vec3{last - first} + 1.f;
+  if (range.x * range.y * range.z > static_cast<float>(cells.size())) {
+    // a large sphere over a sparse grid, cheaper to visit the occupied cells
+    for (const auto &kv : cells) {
+      if (looseBounds(kv.second).intersectsSphere(center, radius)) {
+        queryCell(kv.second);
+      }
+    }
+    return;
+  }
+  for (int x = first.x; x <= last.x; x++) {
+    for (int y = first.y; y <= last.y; y++) {
+      for (int z = first.z; z <= last.z; z++) {
+        auto cell = cells.find(cellKey({x, y, z}));
+        if (cell != cells.end()) {
+          queryCell(cell->second);
+        }
+      }
+    }
+  }
+}
+
+void LveSpatialHash::querySpheres(
+    const std::vector<LveBoundingSphere> &spheres,
+    std::vector<std::vector<LveGameObject::id_t>> &results,
+    LveJobSystem *jobSystem) const {
+  LVE_CPU_ZONE("LveSpatialHash::querySpheres");
+  results.resize(spheres.size());
+  auto query = [&](uint32_t begin, uint32_t end) {
+    for (uint32_t i = begin; i < end; i++) {
+      results[i].clear();
+      querySphere(spheres[i].center, spheres[i].radius, results[i]);
+    }
+  };
+  if (jobSystem != nullptr) {
+    jobSystem->parallelFor(static_cast<uint32_t>(spheres.size()), 64, query);
+  } else {
+    query(0, static_cast<uint32_t>(spheres.size()));
+  }
+}
+
+LveBvh::RayHit LveSpatialHash::intersectRay(const LveRay &ray) const {
+  LveBvh::RayHit closest{};
+  closest.distance = ray.maxDistance;
+  const glm::vec3 inverseDirection = 1.f / ray.direction;
+  for (const auto &kv : cells) {
+    const Cell &cell = kv.second;
+    if (looseBounds(cell).intersectRay(ray.origin, inverseDirection, closest.distance) < 0.f) {
+      continue;
+    }
+    for (uint32_t entryIndex : cell.entries) {
+      const Entry &entry = entries[entryIndex];
+      float distance = entry.bounds.intersectRay(ray.origin, inverseDirection, closest.distance);
+      if (distance >= 0.f) {
+        closest = {true, entry.id, distance};
+      }
+    }
+  }
+  if (!closest.hit) {
+    closest.distance = std::numeric_limits<float>::max();
+  }
+  return closest;
+}
+
+void LveSpatialHash::intersectRays(
+    const std::vector<LveRay> &rays,
+    std::vector<LveBvh::RayHit> &hits,
+    LveJobSystem *jobSystem) const {
+  LVE_CPU_ZONE("LveSpatialHash::intersectRays");
+  hits.resize(rays.size());
+  auto query = [&](uint32_t begin, uint32_t end) {
+    for (uint32_t i = begin; i < end; i++) {
+      hits[i] = intersectRay(rays[i]);
+    }
+  };
+  if (jobSystem != nullptr) {
+    jobSystem->parallelFor(static_cast<uint32_t>(rays.size()), 64, query);
+  } else {
+    query(0, static_cast<uint32_t>(rays.size()));
+  }
+}
+
+}  // namespace lve
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "lve_bvh.hpp"
+#include "lve_frustum.hpp"
+#include "lve_game_object.hpp"
+#include "lve_job_system.hpp"
+
+// libs
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+// std
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace lve {
+
+// Loose uniform grid over the world space boxes of moving objects, hashed so only occupied cells
+// take memory. Each object lives in the single cell containing its box center, which makes
+// insert, update and remove O(1); queries make up for it by growing every cell by the largest
+// half extent stored. Queries match LveBvh so the two can be used side by side.
+class LveSpatialHash {
+ public:
+  explicit LveSpatialHash(float cellSize = 8.f);
+
+  void insert(LveGameObject::id_t id, const LveAabb &bounds);
+  // moves an object, inserting it if it isn't stored yet
+  void update(LveGameObject::id_t id, const LveAabb &bounds);
+  void remove(LveGameObject::id_t id);
+  bool contains(LveGameObject::id_t id) const { return entryIndices.count(id) > 0; }
+  void clear();
+
+  void queryFrustums(
+      const std::vector<LveFrustum> &frustums,
+      std::vector<std::vector<LveGameObject::id_t>> &visible) const;
+  void querySphere(
+      const glm::vec3 &center, float radius, std::vector<LveGameObject::id_t> &results) const;
+  void querySpheres(
+      const std::vector<LveBoundingSphere> &spheres,
+      std::vector<std::vector<LveGameObject::id_t>> &results,
+      LveJobSystem *jobSystem = nullptr) const;
+  LveBvh::RayHit intersectRay(const LveRay &ray) const;
+  void intersectRays(
+      const std::vector<LveRay> &rays,
+      std::vector<LveBvh::RayHit> &hits,
+      LveJobSystem *jobSystem = nullptr) const;
+
+  std::vector<LveGameObject::id_t> getIds() const;
+  size_t getItemCount() const { return entries.size(); }
+  size_t getCellCount() const { return cells.size(); }
+  float getCellSize() const { return cellSize; }
+
+ private:
+  struct Entry {
+    LveAabb bounds;
+    LveGameObject::id_t id;
+    uint64_t cellKey;
+    uint32_t slot;  // position in the cell's entry list
+  };
+
+  struct Cell {
+    glm::ivec3 coord;
+    std::vector<uint32_t> entries;
+  };
+
+  glm::ivec3 cellCoord(const glm::vec3 &point) const;
+  static uint64_t cellKey(const glm::ivec3 &coord);
+  // the cell's bounds grown by the largest stored half extent, contains every box stored in it
+  LveAabb looseBounds(const Cell &cell) const;
+  void addToCell(uint32_t entryIndex);
+  void removeFromCell(uint32_t entryIndex);
+
+  float cellSize;
+  std::vector<Entry> entries;
+  std::unordered_map<LveGameObject::id_t, uint32_t> entryIndices;
+  std::unordered_map<uint64_t, Cell> cells;
+  // only grows until clear, objects that shrink or leave don't shrink it
+  glm::vec3 maxHalfExtent{0.f};
+};
+
+}  // namespace lve
@@ -0,0 +1,70 @@
+#include "lve_stats.hpp"
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace lve {
+
+LveRollingStats::LveRollingStats(size_t capacity) : samples(capacity) {
+  assert(capacity > 0 && "Rolling stats need room for at least one sample");
+}
+
+void LveRollingStats::add(double sample) {
+  if (size == samples.size()) {
+    sum -= samples[next];
+  } else {
+    size++;
+  }
+  samples[next] = sample;
+  sum += sample;
+  next = (next + 1) % samples.size();
+}
+
+void LveRollingStats::clear() {
+  next = 0;
+  size = 0;
+  sum = 0.0;
+}
+
+double LveRollingStats::last() const {
+  if (size == 0) return 0.0;
+  return samples[(next + samples.size() - 1) % samples.size()];
+}
+
+double LveRollingStats::max() const {
+  if (size == 0) return 0.0;
+  return *std::max_element(samples.begin(), samples.begin() + size);
+}
+
+double LveRollingStats::percentile(double p) const {
+  if (size == 0) return 0.0;
+  scratch.assign(samples.begin(), samples.begin() + size);
+  auto rank = static_cast<size_t>(std::ceil(std::clamp(p, 0.0, 100.0) / 100.0 * size));
+  auto nth = scratch.begin() + (rank == 0 ? 0 : rank - 1);
+  std::nth_element(scratch.begin(), nth, scratch.end());
+  return *nth;
+}
+
+LveRollingStats::Summary LveRollingStats::summarize() const {
+  Summary summary{};
+  summary.count = size;
+  if (size == 0) return summary;
+
+  // one sort serves every percentile
+  scratch.assign(samples.begin(), samples.begin() + size);
+  std::sort(scratch.begin(), scratch.end());
+  auto rank = [&](double p) {
+    auto r = static_cast<size_t>(std::ceil(p / 100.0 * size));
+    return scratch[r == 0 ? 0 : r - 1];
+  };
+  summary.mean = mean();
+  summary.p50 = rank(50.0);
+  summary.p95 = rank(95.0);
+  summary.p99 = rank(99.0);
+  summary.max = scratch.back();
+  return summary;
+}
+
+}  // namespace lve
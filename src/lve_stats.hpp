@@ -0,0 +1,43 @@
+#pragma once
+
+// std
+#include <cstddef>
+#include <vector>
+
+namespace lve {
+
+// Fixed size window over the most recent samples, used for frame time style statistics.
+class LveRollingStats {
+ public:
+  struct Summary {
+    size_t count = 0;
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+  };
+
+  explicit LveRollingStats(size_t capacity = 240);
+
+  void add(double sample);
+  void clear();
+
+  size_t count() const { return size; }
+  size_t capacity() const { return samples.size(); }
+  double last() const;
+  double mean() const { return size == 0 ? 0.0 : sum / static_cast<double>(size); }
+  double max() const;
+  // nearest rank percentile, p in [0, 100]
+  double percentile(double p) const;
+  Summary summarize() const;
+
+ private:
+  std::vector<double> samples;
+  size_t next = 0;
+  size_t size = 0;
+  double sum = 0.0;
+  mutable std::vector<double> scratch;
+};
+
+}  // namespace lve
@@ -33,44 +33,47 @@ void LveSwapChain::init() {
 }
 
 LveSwapChain::~LveSwapChain() {
-  for (auto imageView : swapChainImageViews) {
-    vkDestroyImageView(device.device(), imageView, nullptr);
-  }
-  swapChainImageViews.clear();
-
-  if (swapChain != nullptr) {
-    vkDestroySwapchainKHR(device.device(), swapChain, nullptr);
-    swapChain = nullptr;
-  }
+  // The frame timeline only covers the graphics submits. A present still queued may wait on one
+  // of the render finished semaphores, so the present queue has to drain first.
+  device.waitQueueIdle(device.presentQueue());
+  // frames still in flight render to these, they go once the frame timeline passed them
+  device.getDeletionQueue().push([device = device.device(),
+                                  swapChain = swapChain,
+                                  imageViews = std::move(swapChainImageViews),
+                                  depthImages = std::move(depthImages),
+                                  depthImageMemorys = std::move(depthImageMemorys),
+                                  depthImageViews = std::move(depthImageViews),
+                                  framebuffers = std::move(swapChainFramebuffers),
+                                  renderPass = renderPass,
+                                  renderFinishedSemaphores = std::move(renderFinishedSemaphores),
+                                  imageAvailableSemaphores = std::move(imageAvailableSemaphores)] {
+    for (auto imageView : imageViews) {
+      vkDestroyImageView(device, imageView, nullptr);
+    }
+    vkDestroySwapchainKHR(device, swapChain, nullptr);
 
-  for (int i = 0; i < depthImages.size(); i++) {
-    vkDestroyImageView(device.device(), depthImageViews[i], nullptr);
-    vkDestroyImage(device.device(), depthImages[i], nullptr);
-    vkFreeMemory(device.device(), depthImageMemorys[i], nullptr);
-  }
+    for (int i = 0; i < depthImages.size(); i++) {
+      vkDestroyImageView(device, depthImageViews[i], nullptr);
+      vkDestroyImage(device, depthImages[i], nullptr);
+      vkFreeMemory(device, depthImageMemorys[i], nullptr);
+    }
 
-  for (auto framebuffer : swapChainFramebuffers) {
-    vkDestroyFramebuffer(device.device(), framebuffer, nullptr);
-  }
+    for (auto framebuffer : framebuffers) {
+      vkDestroyFramebuffer(device, framebuffer, nullptr);
+    }
 
-  vkDestroyRenderPass(device.device(), renderPass, nullptr);
+    vkDestroyRenderPass(device, renderPass, nullptr);
 
-  // cleanup synchronization objects
-  for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-    vkDestroySemaphore(device.device(), renderFinishedSemaphores[i], nullptr);
-    vkDestroySemaphore(device.device(), imageAvailableSemaphores[i], nullptr);
-    vkDestroyFence(device.device(), inFlightFences[i], nullptr);
-  }
+    // cleanup synchronization objects
+    for (size_t i = 0; i < renderFinishedSemaphores.size(); i++) {
+      vkDestroySemaphore(device, renderFinishedSemaphores[i], nullptr);
+      vkDestroySemaphore(device, imageAvailableSemaphores[i], nullptr);
+    }
+  });
 }
 
 VkResult LveSwapChain::acquireNextImage(uint32_t *imageIndex) {
-  vkWaitForFences(
-      device.device(),
-      1,
-      &inFlightFences[currentFrame],
-      VK_TRUE,
-      std::numeric_limits<uint64_t>::max());
-
+  // the caller waited on the frame timeline for the frame that last used currentFrame
   VkResult result = vkAcquireNextImageKHR(
       device.device(),
       swapChain,
@@ -82,31 +85,54 @@ VkResult LveSwapChain::acquireNextImage(uint32_t *imageIndex) {
   return result;
 }
 
-VkResult LveSwapChain::submitCommandBuffers(const VkCommandBuffer *buffers, uint32_t *imageIndex) {
-  if (imagesInFlight[*imageIndex] != VK_NULL_HANDLE) {
-    vkWaitForFences(device.device(), 1, &imagesInFlight[*imageIndex], VK_TRUE, UINT64_MAX);
-  }
-  imagesInFlight[*imageIndex] = inFlightFences[currentFrame];
+VkResult LveSwapChain::submitCommandBuffers(
+    const VkCommandBuffer *buffers,
+    uint32_t *imageIndex,
+    uint64_t frameValue,
+    LveTimelinePoint computeWait,
+    LveTimelinePoint transferWait) {
+  auto &frameTimeline = device.getFrameTimeline();
+  frameTimeline.wait(imagesInFlight[*imageIndex]);
+  imagesInFlight[*imageIndex] = frameValue;
 
   VkSubmitInfo submitInfo = {};
   submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-  VkSemaphore waitSemaphores[] = {imageAvailableSemaphores[currentFrame]};
-  VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+  // acquire and present only work with binary semaphores, their timeline values are ignored
+  VkSemaphore waitSemaphores[3] = {imageAvailableSemaphores[currentFrame]};
+  uint64_t waitValues[3] = {0};
+  VkPipelineStageFlags waitStages[3] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
   submitInfo.waitSemaphoreCount = 1;
+  for (const auto &point : {computeWait, transferWait}) {
+    if (point.semaphore != VK_NULL_HANDLE) {
+      waitSemaphores[submitInfo.waitSemaphoreCount] = point.semaphore;
+      waitValues[submitInfo.waitSemaphoreCount] = point.value;
+      waitStages[submitInfo.waitSemaphoreCount] = point.stage;
+      submitInfo.waitSemaphoreCount++;
+    }
+  }
   submitInfo.pWaitSemaphores = waitSemaphores;
   submitInfo.pWaitDstStageMask = waitStages;
 
   submitInfo.commandBufferCount = 1;
   submitInfo.pCommandBuffers = buffers;
 
-  VkSemaphore signalSemaphores[] = {renderFinishedSemaphores[currentFrame]};
-  submitInfo.signalSemaphoreCount = 1;
+  VkSemaphore signalSemaphores[] = {
+      renderFinishedSemaphores[currentFrame],
+      frameTimeline.getSemaphore()};
+  uint64_t signalValues[] = {0, frameValue};
+  submitInfo.signalSemaphoreCount = 2;
   submitInfo.pSignalSemaphores = signalSemaphores;
 
-  vkResetFences(device.device(), 1, &inFlightFences[currentFrame]);
-  if (vkQueueSubmit(device.graphicsQueue(), 1, &submitInfo, inFlightFences[currentFrame]) !=
-      VK_SUCCESS) {
+  VkTimelineSemaphoreSubmitInfo timelineInfo{};
+  timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+  timelineInfo.waitSemaphoreValueCount = submitInfo.waitSemaphoreCount;
+  timelineInfo.pWaitSemaphoreValues = waitValues;
+  timelineInfo.signalSemaphoreValueCount = submitInfo.signalSemaphoreCount;
+  timelineInfo.pSignalSemaphoreValues = signalValues;
+  submitInfo.pNext = &timelineInfo;
+
+  if (device.queueSubmit(device.graphicsQueue(), 1, &submitInfo) != VK_SUCCESS) {
     throw std::runtime_error("failed to submit draw command buffer!");
   }
 
@@ -114,7 +140,7 @@ VkResult LveSwapChain::submitCommandBuffers(const VkCommandBuffer *buffers, uint
   presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
 
   presentInfo.waitSemaphoreCount = 1;
-  presentInfo.pWaitSemaphores = signalSemaphores;
+  presentInfo.pWaitSemaphores = &renderFinishedSemaphores[currentFrame];
 
   VkSwapchainKHR swapChains[] = {swapChain};
   presentInfo.swapchainCount = 1;
@@ -122,7 +148,7 @@ VkResult LveSwapChain::submitCommandBuffers(const VkCommandBuffer *buffers, uint
 
   presentInfo.pImageIndices = imageIndex;
 
-  auto result = vkQueuePresentKHR(device.presentQueue(), &presentInfo);
+  auto result = device.queuePresent(presentInfo);
 
   currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
 
@@ -152,6 +178,12 @@ void LveSwapChain::createSwapChain() {
   createInfo.imageExtent = extent;
   createInfo.imageArrayLayers = 1;
   createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+  // allows frames to be copied out for capture
+  transferSrcSupported =
+      swapChainSupport.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+  if (transferSrcSupported) {
+    createInfo.imageUsage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+  }
 
   QueueFamilyIndices indices = device.findPhysicalQueueFamilies();
   uint32_t queueFamilyIndices[] = {indices.graphicsFamily, indices.presentFamily};
@@ -349,22 +381,16 @@ void LveSwapChain::createDepthResources() {
 void LveSwapChain::createSyncObjects() {
   imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
   renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-  inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
-  imagesInFlight.resize(imageCount(), VK_NULL_HANDLE);
+  imagesInFlight.resize(imageCount(), 0);
 
   VkSemaphoreCreateInfo semaphoreInfo = {};
   semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-  VkFenceCreateInfo fenceInfo = {};
-  fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-  fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
   for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
     if (vkCreateSemaphore(device.device(), &semaphoreInfo, nullptr, &imageAvailableSemaphores[i]) !=
             VK_SUCCESS ||
         vkCreateSemaphore(device.device(), &semaphoreInfo, nullptr, &renderFinishedSemaphores[i]) !=
-            VK_SUCCESS ||
-        vkCreateFence(device.device(), &fenceInfo, nullptr, &inFlightFences[i]) != VK_SUCCESS) {
+            VK_SUCCESS) {
       throw std::runtime_error("failed to create synchronization objects for a frame!");
     }
   }
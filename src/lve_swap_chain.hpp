@@ -27,6 +27,7 @@ class LveSwapChain {
 
   VkFramebuffer getFrameBuffer(int index) { return swapChainFramebuffers[index]; }
   VkRenderPass getRenderPass() { return renderPass; }
+  VkImage getImage(int index) { return swapChainImages[index]; }
   VkImageView getImageView(int index) { return swapChainImageViews[index]; }
   size_t imageCount() { return swapChainImages.size(); }
   VkFormat getSwapChainImageFormat() { return swapChainImageFormat; }
@@ -38,9 +39,17 @@ class LveSwapChain {
     return static_cast<float>(swapChainExtent.width) / static_cast<float>(swapChainExtent.height);
   }
   VkFormat findDepthFormat();
+  bool supportsTransferSrc() const { return transferSrcSupported; }
 
   VkResult acquireNextImage(uint32_t *imageIndex);
-  VkResult submitCommandBuffers(const VkCommandBuffer *buffers, uint32_t *imageIndex);
+  // Signals frameValue on the device's frame timeline once the buffers executed. computeWait and
+  // transferWait, when set, are async compute work and uploads the frame waits for at their stage.
+  VkResult submitCommandBuffers(
+      const VkCommandBuffer *buffers,
+      uint32_t *imageIndex,
+      uint64_t frameValue,
+      LveTimelinePoint computeWait = {},
+      LveTimelinePoint transferWait = {});
 
   bool compareSwapFormats(const LveSwapChain &swapChain) const {
     return swapChain.swapChainDepthFormat == swapChainDepthFormat &&
@@ -65,6 +74,7 @@ class LveSwapChain {
 
   VkFormat swapChainImageFormat;
   VkFormat swapChainDepthFormat;
+  bool transferSrcSupported = false;
   VkExtent2D swapChainExtent;
 
   std::vector<VkFramebuffer> swapChainFramebuffers;
@@ -84,8 +94,8 @@ class LveSwapChain {
 
   std::vector<VkSemaphore> imageAvailableSemaphores;
   std::vector<VkSemaphore> renderFinishedSemaphores;
-  std::vector<VkFence> inFlightFences;
-  std::vector<VkFence> imagesInFlight;
+  // frame timeline value of the last frame that rendered to each image
+  std::vector<uint64_t> imagesInFlight;
   size_t currentFrame = 0;
 };
 
@@ -0,0 +1,64 @@
+#include "lve_timeline.hpp"
+
+// std
+#include <stdexcept>
+
+namespace lve {
+
+LveTimeline::LveTimeline(VkDevice device) : device{device} {
+  VkSemaphoreTypeCreateInfo typeInfo{};
+  typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+  typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+  typeInfo.initialValue = 0;
+
+  VkSemaphoreCreateInfo createInfo{};
+  createInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+  createInfo.pNext = &typeInfo;
+  if (vkCreateSemaphore(device, &createInfo, nullptr, &semaphore) != VK_SUCCESS) {
+    throw std::runtime_error("failed to create timeline semaphore!");
+  }
+}
+
+LveTimeline::~LveTimeline() { vkDestroySemaphore(device, semaphore, nullptr); }
+
+uint64_t LveTimeline::getCompletedValue() {
+  uint64_t value = 0;
+  if (vkGetSemaphoreCounterValue(device, semaphore, &value) != VK_SUCCESS) {
+    throw std::runtime_error("failed to query timeline semaphore!");
+  }
+  updateCompleted(value);
+  return value;
+}
+
+bool LveTimeline::isComplete(uint64_t value) {
+  return value <= completedValue.load() || value <= getCompletedValue();
+}
+
+bool LveTimeline::wait(uint64_t value, uint64_t timeoutNs) {
+  if (isComplete(value)) {
+    return true;
+  }
+
+  VkSemaphoreWaitInfo waitInfo{};
+  waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+  waitInfo.semaphoreCount = 1;
+  waitInfo.pSemaphores = &semaphore;
+  waitInfo.pValues = &value;
+  VkResult result = vkWaitSemaphores(device, &waitInfo, timeoutNs);
+  if (result == VK_TIMEOUT) {
+    return false;
+  }
+  if (result != VK_SUCCESS) {
+    throw std::runtime_error("failed to wait for timeline semaphore!");
+  }
+  updateCompleted(value);
+  return true;
+}
+
+void LveTimeline::updateCompleted(uint64_t value) {
+  uint64_t current = completedValue.load();
+  while (current < value && !completedValue.compare_exchange_weak(current, value)) {
+  }
+}
+
+}  // namespace lve
@@ -0,0 +1,56 @@
+#pragma once
+
+// vulkan headers
+#include <vulkan/vulkan.h>
+
+// std
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+namespace lve {
+
+// A semaphore value for a submission to signal, or to wait for at stage
+struct LveTimelinePoint {
+  VkSemaphore semaphore = VK_NULL_HANDLE;
+  uint64_t value = 0;
+  VkPipelineStageFlags stage = 0;
+};
+
+// Timeline semaphore (Vulkan 1.2) of one queue. Each submission signals the next value of a
+// monotonically increasing counter, so the CPU can tell whether any earlier submission finished
+// by comparing numbers instead of keeping a fence per submission.
+class LveTimeline {
+ public:
+  explicit LveTimeline(VkDevice device);
+  ~LveTimeline();
+
+  LveTimeline(const LveTimeline &) = delete;
+  LveTimeline &operator=(const LveTimeline &) = delete;
+
+  VkSemaphore getSemaphore() const { return semaphore; }
+  // Hands out the value for the next submission on this timeline, submit in the same order
+  uint64_t nextValue() { return lastValue.fetch_add(1) + 1; }
+  // latest value handed out, work that isn't submitted yet will signal a greater one
+  uint64_t getLastValue() const { return lastValue.load(); }
+  LveTimelinePoint point(uint64_t value, VkPipelineStageFlags stage = 0) const {
+    return {semaphore, value, stage};
+  }
+
+  // queries the semaphore's current value
+  uint64_t getCompletedValue();
+  // cheap when value is already known to be reached, queries the semaphore otherwise
+  bool isComplete(uint64_t value);
+  // Blocks until value is reached, returns false if timeoutNs passed first
+  bool wait(uint64_t value, uint64_t timeoutNs = std::numeric_limits<uint64_t>::max());
+
+ private:
+  void updateCompleted(uint64_t value);
+
+  VkDevice device;
+  VkSemaphore semaphore;
+  std::atomic<uint64_t> lastValue{0};
+  std::atomic<uint64_t> completedValue{0};
+};
+
+}  // namespace lve
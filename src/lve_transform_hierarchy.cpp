@@ -0,0 +1,137 @@
+#include "lve_transform_hierarchy.hpp"
+
+#include "lve_cpu_profiler.hpp"
+
+// std
+#include <atomic>
+#include <stdexcept>
+#include <string>
+
+namespace lve {
+
+namespace {
+
+bool sameTransform(const TransformComponent &a, const TransformComponent &b) {
+  return a.translation == b.translation && a.rotation == b.rotation && a.scale == b.scale;
+}
+
+}  // namespace
+
+void LveTransformHierarchy::setParent(LveGameObject::id_t child, LveGameObject::id_t parent) {
+  for (LveGameObject::id_t ancestor = parent;;) {
+    if (ancestor == child) {
+      throw std::runtime_error(
+          "parenting object " + std::to_string(child) + " to " + std::to_string(parent) +
+          " would create a cycle");
+    }
+    auto next = parents.find(ancestor);
+    if (next == parents.end()) break;
+    ancestor = next->second;
+  }
+  parents[child] = parent;
+  layoutDirty = true;
+}
+
+void LveTransformHierarchy::clearParent(LveGameObject::id_t child) {
+  if (parents.erase(child) > 0) {
+    layoutDirty = true;
+  }
+}
+
+void LveTransformHierarchy::rebuildLayout(LveGameObject::Map &gameObjects) {
+  LVE_CPU_ZONE("LveTransformHierarchy::rebuildLayout");
+  std::unordered_map<LveGameObject::id_t, std::vector<LveGameObject::id_t>> children;
+  nodeIds.clear();
+  for (auto &kv : gameObjects) {
+    auto parent = parents.find(kv.first);
+    if (parent != parents.end() && gameObjects.count(parent->second) > 0) {
+      children[parent->second].push_back(kv.first);
+    } else {
+      nodeIds.push_back(kv.first);
+    }
+  }
+
+  // breadth first from the roots, which leaves the nodes sorted by depth
+  nodeParents.assign(nodeIds.size(), NO_PARENT);
+  levelStarts.assign(1, 0);
+  while (levelStarts.back() < nodeIds.size()) {
+    const auto levelStart = levelStarts.back();
+    const auto levelEnd = static_cast<uint32_t>(nodeIds.size());
+    levelStarts.push_back(levelEnd);
+    for (uint32_t node = levelStart; node < levelEnd; node++) {
+      auto nodeChildren = children.find(nodeIds[node]);
+      if (nodeChildren == children.end()) continue;
+      for (LveGameObject::id_t child : nodeChildren->second) {
+        nodeIds.push_back(child);
+        nodeParents.push_back(node);
+      }
+    }
+  }
+
+  localTransforms.resize(nodeIds.size());
+  worldMatrices.resize(nodeIds.size());
+  worldNormalMatrices.resize(nodeIds.size());
+  recomputed.resize(nodeIds.size());
+  recomputeAll = true;
+  layoutDirty = false;
+}
+
+void LveTransformHierarchy::update(LveGameObject::Map &gameObjects, LveJobSystem *jobSystem) {
+  LVE_CPU_ZONE("LveTransformHierarchy::update");
+  if (layoutDirty || gameObjects.size() != nodeIds.size()) {
+    rebuildLayout(gameObjects);
+  }
+
+  // objects destroyed since the layout was built
+  std::atomic<bool> missingObjects{false};
+  std::atomic<uint32_t> recomputedCount{0};
+  for (size_t level = 0; level + 1 < levelStarts.size(); level++) {
+    const uint32_t levelStart = levelStarts[level];
+    auto resolve = [&](uint32_t begin, uint32_t end) {
+      uint32_t count = 0;
+      for (uint32_t node = levelStart + begin; node < levelStart + end; node++) {
+        auto object = gameObjects.find(nodeIds[node]);
+        if (object == gameObjects.end()) {
+          missingObjects.store(true, std::memory_order_relaxed);
+          recomputed[node] = true;
+          continue;
+        }
+
+        auto &obj = object->second;
+        const uint32_t parent = nodeParents[node];
+        recomputed[node] = recomputeAll || !sameTransform(obj.transform, localTransforms[node]) ||
+                           (parent != NO_PARENT && recomputed[parent]);
+        if (recomputed[node]) {
+          localTransforms[node] = obj.transform;
+          worldMatrices[node] = obj.transform.mat4();
+          worldNormalMatrices[node] = obj.transform.normalMatrix();
+          if (parent != NO_PARENT) {
+            worldMatrices[node] = worldMatrices[parent] * worldMatrices[node];
+            worldNormalMatrices[node] = worldNormalMatrices[parent] * worldNormalMatrices[node];
+          }
+          count++;
+        }
+        obj.worldMatrix = worldMatrices[node];
+        obj.worldNormalMatrix = worldNormalMatrices[node];
+      }
+      recomputedCount.fetch_add(count, std::memory_order_relaxed);
+    };
+
+    const uint32_t levelSize = levelStarts[level + 1] - levelStart;
+    if (jobSystem != nullptr) {
+      jobSystem->parallelFor(levelSize, PARALLEL_GRAIN_SIZE, resolve);
+    } else {
+      resolve(0, levelSize);
+    }
+  }
+
+  recomputeAll = false;
+  lastRecomputedCount = recomputedCount.load();
+  if (missingObjects.load()) {
+    // the map swapped objects without changing size, objects added in their place were skipped
+    layoutDirty = true;
+    update(gameObjects, jobSystem);
+  }
+}
+
+}  // namespace lve
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "lve_game_object.hpp"
+#include "lve_job_system.hpp"
+
+// libs
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+// std
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace lve {
+
+// Parent links between game objects. Once attached, a child's transform is relative to its
+// parent, so moving the parent moves the whole group. The objects are kept in flat arrays sorted
+// by depth: update resolves one level after another and the objects of a level in parallel,
+// recomputing only those whose transform or an ancestor's transform changed.
+class LveTransformHierarchy {
+ public:
+  // levels smaller than this are resolved on the calling thread
+  static constexpr uint32_t PARALLEL_GRAIN_SIZE = 1024;
+
+  // Throws when parent is child or one of its descendants
+  void setParent(LveGameObject::id_t child, LveGameObject::id_t parent);
+  void clearParent(LveGameObject::id_t child);
+  bool hasParent(LveGameObject::id_t child) const { return parents.count(child) > 0; }
+
+  // Writes worldMatrix and worldNormalMatrix of every object in gameObjects. Objects whose parent
+  // isn't in gameObjects are treated as roots.
+  void update(LveGameObject::Map &gameObjects, LveJobSystem *jobSystem = nullptr);
+
+  size_t getLevelCount() const { return levelStarts.empty() ? 0 : levelStarts.size() - 1; }
+  // objects whose world matrix the last update recomputed
+  uint32_t getLastRecomputedCount() const { return lastRecomputedCount; }
+
+ private:
+  static constexpr uint32_t NO_PARENT = ~0u;
+
+  void rebuildLayout(LveGameObject::Map &gameObjects);
+
+  // child id to parent id, what the layout is built from
+  std::unordered_map<LveGameObject::id_t, LveGameObject::id_t> parents;
+  bool layoutDirty = true;
+
+  // one entry per object, parents always before their children. Level d spans
+  // [levelStarts[d], levelStarts[d + 1]).
+  std::vector<LveGameObject::id_t> nodeIds;
+  std::vector<uint32_t> nodeParents;
+  std::vector<uint32_t> levelStarts;
+  // local transforms as of the last update, to tell which ones changed
+  std::vector<TransformComponent> localTransforms;
+  std::vector<glm::mat4> worldMatrices;
+  std::vector<glm::mat3> worldNormalMatrices;
+  std::vector<uint8_t> recomputed;
+  bool recomputeAll = true;
+  uint32_t lastRecomputedCount = 0;
+};
+
+}  // namespace lve
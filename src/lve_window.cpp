@@ -1,5 +1,7 @@
 #include "lve_window.hpp"
 
+#include "lve_engine_events.hpp"
+
 // std
 #include <stdexcept>
 
@@ -32,6 +34,7 @@ void LveWindow::createWindowSurface(VkInstance instance, VkSurfaceKHR *surface)
 
 void LveWindow::framebufferResizeCallback(GLFWwindow *window, int width, int height) {
   auto lveWindow = reinterpret_cast<LveWindow *>(glfwGetWindowUserPointer(window));
+  LveEngineEvents::record("window resize", std::to_string(width) + "x" + std::to_string(height));
   lveWindow->framebufferResized = true;
   lveWindow->width = width;
   lveWindow->height = height;
@@ -19,6 +19,8 @@ class LveWindow {
   bool wasWindowResized() { return framebufferResized; }
   void resetWindowResizedFlag() { framebufferResized = false; }
   GLFWwindow *getGLFWwindow() const { return window; }
+  void setTitle(const std::string &title) { glfwSetWindowTitle(window, title.c_str()); }
+  const std::string &getName() const { return windowName; }
 
   void createWindowSurface(VkInstance instance, VkSurfaceKHR *surface);
 
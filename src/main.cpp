@@ -1,15 +1,156 @@
-
 #include "first_app.hpp"
+#include "lve_scene.hpp"
 
 // std
 #include <cstdlib>
 #include <iostream>
 #include <stdexcept>
+#include <string>
+
+namespace {
+
+void printUsage(const char *program) {
+  std::cerr << "usage: " << program
+            << " [--scene FILE] [--headless] [--frames N]"
+            << " [--capture DIR [--capture-format png|ppm|raw]]"
+            << " [--batch POSES] [--gpu-profile] [--frame-stats] [--pipeline-stats]"
+            << " [--overdraw [--overdraw-image FILE]] [--workers N] [--job-stats]"
+            << " [--no-pipelining] [--sim-hz HZ] [--stream-budget-ms MS]"
+            << " [--vegetation N [--vegetation-seed S] [--vegetation-density FILE]]"
+            << " [--cpu-trace FILE [--cpu-trace-seconds S]]"
+            << " [--hitches [--hitch-factor F] [--hitch-log FILE]]"
+            << " [--benchmark OUT [--benchmark-frames N] [--benchmark-warmup N]"
+            << " [--camera-path FILE]]\n"
+            << "       " << program << " --compile-scene TEXT_SCENE BINARY_SCENE\n"
+            << "  --scene FILE      text or binary scene to load (default: scenes/park.scene)\n"
+            << "  --compile-scene   convert a text scene to the memory mappable binary format\n"
+            << "  --headless        render offscreen without a window (e.g. on lavapipe)\n"
+            << "  --frames N        exit after N frames (headless default: "
+            << lve::FirstApp::DEFAULT_HEADLESS_FRAMES << ")\n"
+            << "  --capture DIR     write every frame to DIR as an image sequence\n"
+            << "  --capture-format  image format of captured frames (default: png)\n"
+            << "  --batch POSES     render each 'px py pz rx ry rz' line of POSES once and exit\n"
+            << "  --gpu-profile     time render systems on the GPU, print the results on exit\n"
+            << "  --frame-stats     print draw, triangle, bind and upload counters on exit\n"
+            << "  --pipeline-stats  print vertex, clipping and fragment invocations per system\n"
+            << "  --overdraw        count fragments per pixel, print a histogram on exit\n"
+            << "  --overdraw-image FILE  write the last frame's overdraw as a PGM heat map\n"
+            << "  --workers N       job system threads besides the main thread (default: "
+            << lve::LveJobSystem::defaultWorkerCount() << ")\n"
+            << "  --job-stats       print jobs run, stolen and idle time per thread on exit\n"
+            << "  --no-pipelining   simulate each frame right before rendering it\n"
+            << "  --sim-hz HZ       fixed simulation steps per second (default: 60)\n"
+            << "  --stream-budget-ms MS  per frame time for streamed model uploads (default: 2)\n"
+            << "  --vegetation N    plants scattered and culled on the GPU, 0 disables them "
+            << "(default: " << lve::AppConfig{}.vegetationCount << ")\n"
+            << "  --vegetation-seed S  seed of the plant layout (default: 1)\n"
+            << "  --vegetation-density FILE  8 bit PGM of planting density over the ground\n"
+            << "  --cpu-trace FILE  record CPU zones, write a Chrome trace on exit or on F12\n"
+            << "  --cpu-trace-seconds  length of the exported trace window (default: 10)\n"
+            << "  --hitches         log slow frames with their CPU zones, GPU passes and events\n"
+            << "  --hitch-factor F  hitch threshold as a multiple of the median (default: 3)\n"
+            << "  --hitch-log FILE  write hitch reports to FILE instead of stdout\n"
+            << "  --benchmark OUT   fly a scripted camera at a fixed timestep, write JSON stats\n"
+            << "  --benchmark-frames  measured frames (default: 600)\n"
+            << "  --benchmark-warmup  frames rendered before measuring (default: 60)\n"
+            << "  --camera-path FILE  'px py pz rx ry rz' camera keys, default orbits the scene\n";
+}
+
+lve::AppConfig parseArgs(int argc, char **argv) {
+  lve::AppConfig config{};
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--scene" && i + 1 < argc) {
+      config.sceneFile = argv[++i];
+    } else if (arg == "--headless") {
+      config.headless = true;
+    } else if (arg == "--frames" && i + 1 < argc) {
+      config.frameCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+    } else if (arg == "--capture" && i + 1 < argc) {
+      config.captureDirectory = argv[++i];
+    } else if (arg == "--capture-format" && i + 1 < argc) {
+      config.captureFormat = lve::LveImageWriter::parseFormat(argv[++i]);
+    } else if (arg == "--batch" && i + 1 < argc) {
+      config.batchPosesFile = argv[++i];
+    } else if (arg == "--gpu-profile") {
+      config.gpuProfile = true;
+    } else if (arg == "--frame-stats") {
+      config.frameStats = true;
+    } else if (arg == "--pipeline-stats") {
+      config.pipelineStatistics = true;
+    } else if (arg == "--overdraw") {
+      config.overdraw = true;
+    } else if (arg == "--overdraw-image" && i + 1 < argc) {
+      config.overdraw = true;
+      config.overdrawImageFile = argv[++i];
+    } else if (arg == "--workers" && i + 1 < argc) {
+      config.workerCount = static_cast<unsigned>(std::stoul(argv[++i]));
+    } else if (arg == "--job-stats") {
+      config.jobStats = true;
+    } else if (arg == "--no-pipelining") {
+      config.pipelined = false;
+    } else if (arg == "--sim-hz" && i + 1 < argc) {
+      config.simulationHz = std::stod(argv[++i]);
+    } else if (arg == "--stream-budget-ms" && i + 1 < argc) {
+      config.streamingBudgetMs = std::stod(argv[++i]);
+    } else if (arg == "--vegetation" && i + 1 < argc) {
+      config.vegetationCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+    } else if (arg == "--vegetation-seed" && i + 1 < argc) {
+      config.vegetationSeed = static_cast<uint32_t>(std::stoul(argv[++i]));
+    } else if (arg == "--vegetation-density" && i + 1 < argc) {
+      config.vegetationDensityMap = argv[++i];
+    } else if (arg == "--cpu-trace" && i + 1 < argc) {
+      config.cpuTraceFile = argv[++i];
+    } else if (arg == "--cpu-trace-seconds" && i + 1 < argc) {
+      config.cpuTraceSeconds = std::stod(argv[++i]);
+    } else if (arg == "--hitches") {
+      config.detectHitches = true;
+    } else if (arg == "--hitch-factor" && i + 1 < argc) {
+      config.hitchFactor = std::stod(argv[++i]);
+    } else if (arg == "--hitch-log" && i + 1 < argc) {
+      config.hitchLogFile = argv[++i];
+    } else if (arg == "--benchmark" && i + 1 < argc) {
+      config.benchmark.outputFile = argv[++i];
+    } else if (arg == "--benchmark-frames" && i + 1 < argc) {
+      config.benchmark.measuredFrames = static_cast<uint32_t>(std::stoul(argv[++i]));
+    } else if (arg == "--benchmark-warmup" && i + 1 < argc) {
+      config.benchmark.warmupFrames = static_cast<uint32_t>(std::stoul(argv[++i]));
+    } else if (arg == "--camera-path" && i + 1 < argc) {
+      config.benchmark.cameraPathFile = argv[++i];
+    } else {
+      throw std::invalid_argument("unknown argument: " + arg);
+    }
+  }
+  if (config.headless && config.frameCount == 0) {
+    config.frameCount = lve::FirstApp::DEFAULT_HEADLESS_FRAMES;
+  }
+  return config;
+}
+
+}  // namespace
 
-int main() {
-  lve::FirstApp app{};
+int main(int argc, char **argv) {
+  if (argc == 4 && std::string{argv[1]} == "--compile-scene") {
+    try {
+      lve::LveScene::loadFromFile(argv[2]).writeBinary(argv[3]);
+    } catch (const std::exception &e) {
+      std::cerr << e.what() << '\n';
+      return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+  }
+
+  lve::AppConfig config{};
+  try {
+    config = parseArgs(argc, argv);
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << '\n';
+    printUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
 
   try {
+    lve::FirstApp app{config};
     app.run();
   } catch (const std::exception &e) {
     std::cerr << e.what() << '\n';
@@ -17,4 +158,4 @@ int main() {
   }
 
   return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
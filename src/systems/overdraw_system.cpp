@@ -0,0 +1,445 @@
+#include "overdraw_system.hpp"
+
+#include "lve_cpu_profiler.hpp"
+#include "lve_swap_chain.hpp"
+
+// libs
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+namespace lve {
+
+namespace {
+
+constexpr VkFormat OVERDRAW_FORMAT = VK_FORMAT_R16_SFLOAT;
+
+struct OverdrawPushConstantData {
+  glm::mat4 modelMatrix{1.f};
+};
+
+// fragment counts are small whole numbers, exact in half precision up to 2048
+uint32_t halfToLayers(uint16_t half) {
+  uint32_t exponent = (half >> 10) & 0x1f;
+  uint32_t mantissa = half & 0x3ff;
+  if (exponent == 0) {
+    return 0;  // zero or subnormal, a texel nothing was drawn to
+  }
+  if (exponent == 0x1f) {
+    return 0xffff;  // blending overflowed to infinity
+  }
+  return static_cast<uint32_t>(std::ldexp(static_cast<double>(1024 + mantissa), exponent - 25));
+}
+
+}  // namespace
+
+double OverdrawSystem::Histogram::averageLayers() const {
+  return coveredPixels > 0 ? static_cast<double>(fragments) / coveredPixels : 0.0;
+}
+
+double OverdrawSystem::Histogram::fragmentsPerPixel() const {
+  return totalPixels > 0 ? static_cast<double>(fragments) / totalPixels : 0.0;
+}
+
+OverdrawSystem::OverdrawSystem(LveDevice &device, VkDescriptorSetLayout globalSetLayout)
+    : lveDevice{device} {
+  createPipelineLayout(globalSetLayout);
+  createRenderPass();
+  createPipeline();
+}
+
+OverdrawSystem::~OverdrawSystem() {
+  destroyTargets();
+  vegetationPipeline.reset();
+  lvePipeline.reset();
+  vkDestroyRenderPass(lveDevice.device(), renderPass, nullptr);
+  vkDestroyPipelineLayout(lveDevice.device(), pipelineLayout, nullptr);
+}
+
+void OverdrawSystem::createPipelineLayout(VkDescriptorSetLayout globalSetLayout) {
+  VkPushConstantRange pushConstantRange{};
+  pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+  pushConstantRange.offset = 0;
+  pushConstantRange.size = sizeof(OverdrawPushConstantData);
+
+  std::vector<VkDescriptorSetLayout> descriptorSetLayouts{globalSetLayout};
+
+  VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+  pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+  pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(descriptorSetLayouts.size());
+  pipelineLayoutInfo.pSetLayouts = descriptorSetLayouts.data();
+  pipelineLayoutInfo.pushConstantRangeCount = 1;
+  pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+  if (vkCreatePipelineLayout(lveDevice.device(), &pipelineLayoutInfo, nullptr, &pipelineLayout) !=
+      VK_SUCCESS) {
+    throw std::runtime_error("failed to create pipeline layout!");
+  }
+}
+
+void OverdrawSystem::createRenderPass() {
+  VkAttachmentDescription colorAttachment = {};
+  colorAttachment.format = OVERDRAW_FORMAT;
+  colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+  colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+  colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+  colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+  colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+  colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  colorAttachment.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+  VkAttachmentReference colorAttachmentRef = {};
+  colorAttachmentRef.attachment = 0;
+  colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+  VkSubpassDescription subpass = {};
+  subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+  subpass.colorAttachmentCount = 1;
+  subpass.pColorAttachments = &colorAttachmentRef;
+
+  std::array<VkSubpassDependency, 2> dependencies{};
+  dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+  dependencies[0].dstSubpass = 0;
+  dependencies[0].srcStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+  dependencies[0].srcAccessMask = 0;
+  dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  dependencies[0].dstAccessMask =
+      VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+  // make the counts visible to the copy recorded after the render pass
+  dependencies[1].srcSubpass = 0;
+  dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+  dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+  dependencies[1].dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+  dependencies[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+  VkRenderPassCreateInfo renderPassInfo = {};
+  renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+  renderPassInfo.attachmentCount = 1;
+  renderPassInfo.pAttachments = &colorAttachment;
+  renderPassInfo.subpassCount = 1;
+  renderPassInfo.pSubpasses = &subpass;
+  renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+  renderPassInfo.pDependencies = dependencies.data();
+
+  if (vkCreateRenderPass(lveDevice.device(), &renderPassInfo, nullptr, &renderPass) !=
+      VK_SUCCESS) {
+    throw std::runtime_error("failed to create overdraw render pass!");
+  }
+}
+
+void OverdrawSystem::overdrawPipelineConfig(PipelineConfigInfo &pipelineConfig) {
+  LvePipeline::defaultPipelineConfigInfo(pipelineConfig);
+  // every rasterized fragment counts, hidden ones included
+  pipelineConfig.depthStencilInfo.depthTestEnable = VK_FALSE;
+  pipelineConfig.depthStencilInfo.depthWriteEnable = VK_FALSE;
+  pipelineConfig.colorBlendAttachment.blendEnable = VK_TRUE;
+  pipelineConfig.colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT;
+  pipelineConfig.colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+  pipelineConfig.colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
+  pipelineConfig.colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+  pipelineConfig.colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+  pipelineConfig.colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+  pipelineConfig.colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+  pipelineConfig.renderPass = renderPass;
+}
+
+void OverdrawSystem::createPipeline() {
+  assert(pipelineLayout != nullptr && "Cannot create pipeline before pipeline layout");
+
+  PipelineConfigInfo pipelineConfig{};
+  overdrawPipelineConfig(pipelineConfig);
+  pipelineConfig.pipelineLayout = pipelineLayout;
+  lvePipeline = std::make_unique<LvePipeline>(
+      lveDevice,
+      "shaders/overdraw.vert.spv",
+      "shaders/overdraw.frag.spv",
+      pipelineConfig);
+}
+
+void OverdrawSystem::setVegetation(VegetationSystem *vegetation) {
+  vegetationSystem = vegetation;
+  vegetationPipeline.reset();
+  if (vegetationSystem != nullptr) {
+    PipelineConfigInfo pipelineConfig{};
+    overdrawPipelineConfig(pipelineConfig);
+    vegetationPipeline =
+        vegetationSystem->createPipelineVariant(pipelineConfig, "shaders/overdraw.frag.spv");
+  }
+}
+
+void OverdrawSystem::createTargets(VkExtent2D newExtent) {
+  extent = newExtent;
+  targets.resize(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
+  for (auto &target : targets) {
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent.width = extent.width;
+    imageInfo.extent.height = extent.height;
+    imageInfo.extent.depth = 1;
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = OVERDRAW_FORMAT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.flags = 0;
+
+    lveDevice.createImageWithInfo(
+        imageInfo,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        target.image,
+        target.memory);
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = target.image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = OVERDRAW_FORMAT;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.baseMipLevel = 0;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = 1;
+    if (vkCreateImageView(lveDevice.device(), &viewInfo, nullptr, &target.view) != VK_SUCCESS) {
+      throw std::runtime_error("failed to create overdraw image view!");
+    }
+
+    VkFramebufferCreateInfo framebufferInfo = {};
+    framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    framebufferInfo.renderPass = renderPass;
+    framebufferInfo.attachmentCount = 1;
+    framebufferInfo.pAttachments = &target.view;
+    framebufferInfo.width = extent.width;
+    framebufferInfo.height = extent.height;
+    framebufferInfo.layers = 1;
+    if (vkCreateFramebuffer(lveDevice.device(), &framebufferInfo, nullptr, &target.framebuffer) !=
+        VK_SUCCESS) {
+      throw std::runtime_error("failed to create overdraw framebuffer!");
+    }
+
+    target.readback = std::make_unique<LveBuffer>(
+        lveDevice,
+        sizeof(uint16_t),
+        extent.width * extent.height,
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    target.readback->map();
+  }
+}
+
+void OverdrawSystem::destroyTargets() {
+  for (auto &target : targets) {
+    vkDestroyFramebuffer(lveDevice.device(), target.framebuffer, nullptr);
+    vkDestroyImageView(lveDevice.device(), target.view, nullptr);
+    vkDestroyImage(lveDevice.device(), target.image, nullptr);
+    vkFreeMemory(lveDevice.device(), target.memory, nullptr);
+  }
+  targets.clear();
+}
+
+void OverdrawSystem::render(FrameInfo &frameInfo, VkExtent2D newExtent) {
+  if (newExtent.width != extent.width || newExtent.height != extent.height) {
+    // diagnostics only, so a stall on resize is fine
+    lveDevice.waitIdle();
+    collectAll();
+    destroyTargets();
+    createTargets(newExtent);
+  }
+
+  auto &target = targets[frameInfo.frameIndex];
+  collect(target);
+
+  VkClearValue clearValue{};
+  clearValue.color = {{0.f, 0.f, 0.f, 0.f}};
+  VkRenderPassBeginInfo renderPassInfo{};
+  renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+  renderPassInfo.renderPass = renderPass;
+  renderPassInfo.framebuffer = target.framebuffer;
+  renderPassInfo.renderArea.offset = {0, 0};
+  renderPassInfo.renderArea.extent = extent;
+  renderPassInfo.clearValueCount = 1;
+  renderPassInfo.pClearValues = &clearValue;
+  vkCmdBeginRenderPass(frameInfo.commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+  VkViewport viewport{};
+  viewport.x = 0.0f;
+  viewport.y = 0.0f;
+  viewport.width = static_cast<float>(extent.width);
+  viewport.height = static_cast<float>(extent.height);
+  viewport.minDepth = 0.0f;
+  viewport.maxDepth = 1.0f;
+  VkRect2D scissor{{0, 0}, extent};
+  vkCmdSetViewport(frameInfo.commandBuffer, 0, 1, &viewport);
+  vkCmdSetScissor(frameInfo.commandBuffer, 0, 1, &scissor);
+
+  lvePipeline->bind(frameInfo.commandBuffer);
+  frameInfo.stats.pipelineBinds++;
+  vkCmdBindDescriptorSets(
+      frameInfo.commandBuffer,
+      VK_PIPELINE_BIND_POINT_GRAPHICS,
+      pipelineLayout,
+      0,
+      1,
+      &frameInfo.globalDescriptorSet,
+      0,
+      nullptr);
+  frameInfo.stats.descriptorBinds++;
+
+  if (frameInfo.visibleObjects != nullptr) {
+    for (auto id : *frameInfo.visibleObjects) {
+      renderGameObject(frameInfo, frameInfo.gameObjects.at(id));
+    }
+  } else {
+    for (auto &kv : frameInfo.gameObjects) {
+      renderGameObject(frameInfo, kv.second);
+    }
+  }
+  if (vegetationSystem != nullptr) {
+    // the same indirect draws as the frame, so the cull pass must have been recorded already
+    vegetationSystem->render(frameInfo, *vegetationPipeline);
+  }
+  vkCmdEndRenderPass(frameInfo.commandBuffer);
+
+  VkBufferImageCopy region{};
+  region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+  region.imageExtent = {extent.width, extent.height, 1};
+  vkCmdCopyImageToBuffer(
+      frameInfo.commandBuffer,
+      target.image,
+      VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+      target.readback->getBuffer(),
+      1,
+      &region);
+
+  VkBufferMemoryBarrier toHost{};
+  toHost.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+  toHost.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  toHost.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+  toHost.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  toHost.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  toHost.buffer = target.readback->getBuffer();
+  toHost.offset = 0;
+  toHost.size = VK_WHOLE_SIZE;
+  vkCmdPipelineBarrier(
+      frameInfo.commandBuffer,
+      VK_PIPELINE_STAGE_TRANSFER_BIT,
+      VK_PIPELINE_STAGE_HOST_BIT,
+      0,
+      0,
+      nullptr,
+      1,
+      &toHost,
+      0,
+      nullptr);
+  target.pending = true;
+}
+
+void OverdrawSystem::renderGameObject(FrameInfo &frameInfo, LveGameObject &obj) {
+  if (obj.model == nullptr || !obj.model->isReady()) return;
+  OverdrawPushConstantData push{};
+  push.modelMatrix = obj.worldMatrix;
+
+  vkCmdPushConstants(
+      frameInfo.commandBuffer,
+      pipelineLayout,
+      VK_SHADER_STAGE_VERTEX_BIT,
+      0,
+      sizeof(OverdrawPushConstantData),
+      &push);
+  obj.model->bind(frameInfo.commandBuffer);
+  obj.model->draw(frameInfo.commandBuffer);
+  frameInfo.stats.pushConstantBytes += sizeof(OverdrawPushConstantData);
+  frameInfo.stats.recordDraw(obj.model->getTriangleCount() * 3);
+}
+
+void OverdrawSystem::collectAll() {
+  for (auto &target : targets) {
+    collect(target);
+  }
+}
+
+void OverdrawSystem::collect(FrameTarget &target) {
+  if (!target.pending) {
+    return;
+  }
+  LVE_CPU_ZONE("OverdrawSystem::collect");
+  target.pending = false;
+
+  const size_t pixelCount = static_cast<size_t>(extent.width) * extent.height;
+  const auto *texels = static_cast<const uint16_t *>(target.readback->getMappedMemory());
+  lastFrame.resize(pixelCount);
+  lastFrameExtent = extent;
+  for (size_t i = 0; i < pixelCount; i++) {
+    uint32_t layers = halfToLayers(texels[i]);
+    lastFrame[i] = static_cast<uint16_t>(std::min<uint32_t>(layers, 0xffff));
+    histogram.pixels[std::min(layers, HISTOGRAM_BUCKETS - 1)]++;
+    histogram.fragments += layers;
+    histogram.coveredPixels += layers > 0 ? 1 : 0;
+    histogram.maxLayers = std::max(histogram.maxLayers, layers);
+  }
+  histogram.totalPixels += pixelCount;
+  histogram.frames++;
+}
+
+void OverdrawSystem::logReport(std::ostream &out) const {
+  if (histogram.frames == 0) {
+    out << "overdraw: no frames collected\n";
+    return;
+  }
+
+  char line[128];
+  std::snprintf(
+      line,
+      sizeof(line),
+      "overdraw over %llu frames: %.2f layers per covered pixel, %.2f fragments per pixel, "
+      "max %u\n",
+      static_cast<unsigned long long>(histogram.frames),
+      histogram.averageLayers(),
+      histogram.fragmentsPerPixel(),
+      histogram.maxLayers);
+  out << line;
+  for (uint32_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+    double share = 100.0 * histogram.pixels[i] / histogram.totalPixels;
+    std::snprintf(
+        line,
+        sizeof(line),
+        "  %2u%s layers %6.2f%% %s\n",
+        i,
+        i == HISTOGRAM_BUCKETS - 1 ? "+" : " ",
+        share,
+        std::string(static_cast<size_t>(share / 2.0), '#').c_str());
+    out << line;
+  }
+}
+
+void OverdrawSystem::writeImage(const std::string &filepath) const {
+  if (lastFrame.empty()) {
+    return;
+  }
+  std::ofstream file{filepath, std::ios::binary};
+  if (!file.is_open()) {
+    throw std::runtime_error("failed to open file: " + filepath);
+  }
+
+  file << "P5\n" << lastFrameExtent.width << " " << lastFrameExtent.height << "\n255\n";
+  std::vector<uint8_t> gray(lastFrame.size());
+  for (size_t i = 0; i < lastFrame.size(); i++) {
+    uint32_t layers = std::min<uint32_t>(lastFrame[i], HISTOGRAM_BUCKETS - 1);
+    gray[i] = static_cast<uint8_t>(layers * 255 / (HISTOGRAM_BUCKETS - 1));
+  }
+  file.write(reinterpret_cast<const char *>(gray.data()), gray.size());
+}
+
+}  // namespace lve
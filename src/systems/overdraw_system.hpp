@@ -0,0 +1,99 @@
+#pragma once
+
+#include "lve_buffer.hpp"
+#include "lve_device.hpp"
+#include "lve_frame_info.hpp"
+#include "lve_game_object.hpp"
+#include "lve_pipeline.hpp"
+#include "vegetation_system.hpp"
+
+// std
+#include <array>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace lve {
+
+// Diagnostics pass that redraws the scene's meshes into an offscreen R16_SFLOAT target with
+// additive blending and no depth test, so every texel ends up holding the number of fragments
+// rasterized there. The target is copied to host memory and reduced to a histogram once its frame
+// slot retires. GPU vegetation is redrawn from the same cull results once set with setVegetation.
+class OverdrawSystem {
+ public:
+  // the last bucket collects every pixel with HISTOGRAM_BUCKETS - 1 or more layers
+  static constexpr uint32_t HISTOGRAM_BUCKETS = 16;
+
+  struct Histogram {
+    std::array<uint64_t, HISTOGRAM_BUCKETS> pixels{};
+    uint64_t fragments = 0;
+    uint64_t coveredPixels = 0;
+    uint64_t totalPixels = 0;
+    uint32_t maxLayers = 0;
+    uint64_t frames = 0;
+
+    // fragments per covered pixel, 1.0 means no overdraw at all
+    double averageLayers() const;
+    // fragments per pixel of the whole target
+    double fragmentsPerPixel() const;
+  };
+
+  OverdrawSystem(LveDevice &device, VkDescriptorSetLayout globalSetLayout);
+  ~OverdrawSystem();
+
+  OverdrawSystem(const OverdrawSystem &) = delete;
+  OverdrawSystem &operator=(const OverdrawSystem &) = delete;
+
+  // Counts vegetation's instances too, they aren't game objects. vegetation must outlive this.
+  void setVegetation(VegetationSystem *vegetation);
+
+  // Collects the previous result of this frame slot and records the overdraw pass. Must be called
+  // outside a render pass, after the frame slot's previous frame retired.
+  void render(FrameInfo &frameInfo, VkExtent2D extent);
+  // Reads every outstanding result, only valid while the device is idle
+  void collectAll();
+
+  // accumulated over every collected frame
+  const Histogram &getHistogram() const { return histogram; }
+  void logReport(std::ostream &out) const;
+  // writes the last collected frame as a binary PGM heat map, white at HISTOGRAM_BUCKETS - 1 layers
+  void writeImage(const std::string &filepath) const;
+
+ private:
+  struct FrameTarget {
+    VkImage image = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkImageView view = VK_NULL_HANDLE;
+    VkFramebuffer framebuffer = VK_NULL_HANDLE;
+    std::unique_ptr<LveBuffer> readback;
+    bool pending = false;
+  };
+
+  void createPipelineLayout(VkDescriptorSetLayout globalSetLayout);
+  void createRenderPass();
+  // additive counting state for a pipeline of the overdraw render pass
+  void overdrawPipelineConfig(PipelineConfigInfo &pipelineConfig);
+  void createPipeline();
+  void createTargets(VkExtent2D newExtent);
+  void destroyTargets();
+  void collect(FrameTarget &target);
+  void renderGameObject(FrameInfo &frameInfo, LveGameObject &obj);
+
+  LveDevice &lveDevice;
+
+  std::unique_ptr<LvePipeline> lvePipeline;
+  VegetationSystem *vegetationSystem = nullptr;
+  std::unique_ptr<LvePipeline> vegetationPipeline;
+  VkPipelineLayout pipelineLayout;
+  VkRenderPass renderPass;
+
+  VkExtent2D extent{0, 0};
+  std::vector<FrameTarget> targets;
+
+  Histogram histogram{};
+  std::vector<uint16_t> lastFrame;
+  VkExtent2D lastFrameExtent{0, 0};
+};
+
+}  // namespace lve
@@ -69,19 +69,31 @@ void PointLightSystem::createPipeline(VkRenderPass renderPass) {
 }
 
 void PointLightSystem::update(FrameInfo& frameInfo, GlobalUbo& ubo) {
-  auto rotateLight = glm::rotate(glm::mat4(1.f), 0.5f * frameInfo.frameTime, {0.f, -1.f, 0.f});
+  animateLights(frameInfo.frameTime, frameInfo.gameObjects);
+  writeLights(frameInfo.gameObjects, ubo);
+}
+
+void PointLightSystem::animateLights(float frameTime, LveGameObject::Map& gameObjects) {
+  auto rotateLight = glm::rotate(glm::mat4(1.f), 0.5f * frameTime, {0.f, -1.f, 0.f});
+  for (auto& kv : gameObjects) {
+    auto& obj = kv.second;
+    if (obj.pointLight == nullptr || obj.isStatic) continue;
+
+    // update light position
+    obj.transform.translation = glm::vec3(rotateLight * glm::vec4(obj.transform.translation, 1.f));
+  }
+}
+
+void PointLightSystem::writeLights(LveGameObject::Map& gameObjects, GlobalUbo& ubo) {
   int lightIndex = 0;
-  for (auto& kv : frameInfo.gameObjects) {
+  for (auto& kv : gameObjects) {
     auto& obj = kv.second;
     if (obj.pointLight == nullptr) continue;
 
     assert(lightIndex < MAX_LIGHTS && "Point lights exceed maximum specified");
 
-    // update light position
-    obj.transform.translation = glm::vec3(rotateLight * glm::vec4(obj.transform.translation, 1.f));
-
     // copy light to ubo
-    ubo.pointLights[lightIndex].position = glm::vec4(obj.transform.translation, 1.f);
+    ubo.pointLights[lightIndex].position = glm::vec4(obj.getWorldPosition(), 1.f);
     ubo.pointLights[lightIndex].color = glm::vec4(obj.color, obj.pointLight->lightIntensity);
 
     lightIndex += 1;
@@ -89,20 +101,27 @@ void PointLightSystem::update(FrameInfo& frameInfo, GlobalUbo& ubo) {
   ubo.numLights = lightIndex;
 }
 
-void PointLightSystem::render(FrameInfo& frameInfo) {
-  // sort lights
+std::map<float, LveGameObject::id_t> PointLightSystem::sortLightsByDistance(
+    LveGameObject::Map& gameObjects, const glm::vec3& cameraPosition) {
   std::map<float, LveGameObject::id_t> sorted;
-  for (auto& kv : frameInfo.gameObjects) {
+  for (auto& kv : gameObjects) {
     auto& obj = kv.second;
     if (obj.pointLight == nullptr) continue;
 
     // calculate distance
-    auto offset = frameInfo.camera.getPosition() - obj.transform.translation;
+    auto offset = cameraPosition - obj.getWorldPosition();
     float disSquared = glm::dot(offset, offset);
     sorted[disSquared] = obj.getId();
   }
+  return sorted;
+}
+
+void PointLightSystem::render(FrameInfo& frameInfo) {
+  // sort lights
+  auto sorted = sortLightsByDistance(frameInfo.gameObjects, frameInfo.camera.getPosition());
 
   lvePipeline->bind(frameInfo.commandBuffer);
+  frameInfo.stats.pipelineBinds++;
 
   vkCmdBindDescriptorSets(
       frameInfo.commandBuffer,
@@ -113,6 +132,7 @@ void PointLightSystem::render(FrameInfo& frameInfo) {
       &frameInfo.globalDescriptorSet,
       0,
       nullptr);
+  frameInfo.stats.descriptorBinds++;
 
   // iterate through sorted lights in reverse order
   for (auto it = sorted.rbegin(); it != sorted.rend(); ++it) {
@@ -120,7 +140,7 @@ void PointLightSystem::render(FrameInfo& frameInfo) {
     auto& obj = frameInfo.gameObjects.at(it->second);
 
     PointLightPushConstants push{};
-    push.position = glm::vec4(obj.transform.translation, 1.f);
+    push.position = glm::vec4(obj.getWorldPosition(), 1.f);
     push.color = glm::vec4(obj.color, obj.pointLight->lightIntensity);
     push.radius = obj.transform.scale.x;
 
@@ -132,6 +152,8 @@ void PointLightSystem::render(FrameInfo& frameInfo) {
         sizeof(PointLightPushConstants),
         &push);
     vkCmdDraw(frameInfo.commandBuffer, 6, 1, 0, 0);
+    frameInfo.stats.pushConstantBytes += sizeof(PointLightPushConstants);
+    frameInfo.stats.recordDraw(6);
   }
 }
 
@@ -7,6 +7,7 @@
 #include "lve_pipeline.hpp"
 
 // std
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -21,8 +22,16 @@ class PointLightSystem {
   PointLightSystem &operator=(const PointLightSystem &) = delete;
 
   void update(FrameInfo &frameInfo, GlobalUbo &ubo);
+  // the two halves of update, they touch no render state so they can run on the simulation side of
+  // a pipelined frame
+  static void animateLights(float frameTime, LveGameObject::Map &gameObjects);
+  static void writeLights(LveGameObject::Map &gameObjects, GlobalUbo &ubo);
   void render(FrameInfo &frameInfo);
 
+  // point lights keyed by squared distance to the camera, iterate in reverse for back to front
+  static std::map<float, LveGameObject::id_t> sortLightsByDistance(
+      LveGameObject::Map &gameObjects, const glm::vec3 &cameraPosition);
+
  private:
   void createPipelineLayout(VkDescriptorSetLayout globalSetLayout);
   void createPipeline(VkRenderPass renderPass);
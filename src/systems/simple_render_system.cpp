@@ -65,6 +65,7 @@ void SimpleRenderSystem::createPipeline(VkRenderPass renderPass) {
 
 void SimpleRenderSystem::renderGameObjects(FrameInfo& frameInfo) {
   lvePipeline->bind(frameInfo.commandBuffer);
+  frameInfo.stats.pipelineBinds++;
 
   vkCmdBindDescriptorSets(
       frameInfo.commandBuffer,
@@ -75,24 +76,36 @@ void SimpleRenderSystem::renderGameObjects(FrameInfo& frameInfo) {
       &frameInfo.globalDescriptorSet,
       0,
       nullptr);
-
-  for (auto& kv : frameInfo.gameObjects) {
-    auto& obj = kv.second;
-    if (obj.model == nullptr) continue;
-    SimplePushConstantData push{};
-    push.modelMatrix = obj.transform.mat4();
-    push.normalMatrix = obj.transform.normalMatrix();
-
-    vkCmdPushConstants(
-        frameInfo.commandBuffer,
-        pipelineLayout,
-        VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-        0,
-        sizeof(SimplePushConstantData),
-        &push);
-    obj.model->bind(frameInfo.commandBuffer);
-    obj.model->draw(frameInfo.commandBuffer);
+  frameInfo.stats.descriptorBinds++;
+
+  if (frameInfo.visibleObjects != nullptr) {
+    for (auto id : *frameInfo.visibleObjects) {
+      renderGameObject(frameInfo, frameInfo.gameObjects.at(id));
+    }
+  } else {
+    for (auto& kv : frameInfo.gameObjects) {
+      renderGameObject(frameInfo, kv.second);
+    }
   }
 }
 
+void SimpleRenderSystem::renderGameObject(FrameInfo& frameInfo, LveGameObject& obj) {
+  if (obj.model == nullptr || !obj.model->isReady()) return;
+  SimplePushConstantData push{};
+  push.modelMatrix = obj.worldMatrix;
+  push.normalMatrix = obj.worldNormalMatrix;
+
+  vkCmdPushConstants(
+      frameInfo.commandBuffer,
+      pipelineLayout,
+      VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+      0,
+      sizeof(SimplePushConstantData),
+      &push);
+  obj.model->bind(frameInfo.commandBuffer);
+  obj.model->draw(frameInfo.commandBuffer);
+  frameInfo.stats.pushConstantBytes += sizeof(SimplePushConstantData);
+  frameInfo.stats.recordDraw(obj.model->getTriangleCount() * 3);
+}
+
 }  // namespace lve
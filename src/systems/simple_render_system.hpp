@@ -25,6 +25,7 @@ class SimpleRenderSystem {
  private:
   void createPipelineLayout(VkDescriptorSetLayout globalSetLayout);
   void createPipeline(VkRenderPass renderPass);
+  void renderGameObject(FrameInfo &frameInfo, LveGameObject &obj);
 
   LveDevice &lveDevice;
 
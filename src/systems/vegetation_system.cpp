@@ -0,0 +1,515 @@
+#include "vegetation_system.hpp"
+
+#include "lve_cpu_profiler.hpp"
+#include "lve_frustum.hpp"
+#include "lve_swap_chain.hpp"
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <fstream>
+#include <stdexcept>
+
+namespace lve {
+
+namespace {
+
+constexpr uint32_t WORKGROUP_SIZE = 64;
+
+// matches Instance in the vegetation shaders
+struct VegetationInstance {
+  glm::vec4 positionScale{0.f};
+  float yaw = 0.f;
+  uint32_t variant = 0;
+  uint32_t padding[2]{};
+};
+
+// matches Counters in vegetation_scatter.comp
+struct ScatterCounters {
+  uint32_t instanceCount = 0;
+  uint32_t variantCounts[VegetationSystem::MAX_VARIANTS]{};
+};
+
+// matches Variant in vegetation_cull.comp and vegetation.vert
+struct VariantData {
+  glm::mat4 modelMatrix{1.f};
+  glm::mat4 normalMatrix{1.f};
+  glm::vec4 boundingSphere{0.f};  // model space center, radius in w
+};
+
+// matches Draws in vegetation_cull.comp and vegetation.vert, the commands are read by
+// vkCmdDrawIndexedIndirect
+struct DrawData {
+  VariantData variants[VegetationSystem::MAX_VARIANTS];
+  VkDrawIndexedIndirectCommand commands[VegetationSystem::MAX_VARIANTS];
+};
+
+struct ScatterPushConstantData {
+  glm::vec4 area{0.f};
+  glm::vec4 cumulativeWeights{0.f};
+  float groundY = 0.f;
+  float minScale = 0.f;
+  float maxScale = 0.f;
+  uint32_t seed = 0;
+  uint32_t candidateCount = 0;
+  uint32_t variantCount = 0;
+  uint32_t densityWidth = 0;
+  uint32_t densityHeight = 0;
+};
+
+struct CullPushConstantData {
+  glm::vec4 frustumPlanes[6];
+  glm::vec4 cameraPosition{0.f};  // w is the max distance
+  uint32_t instanceCount = 0;
+};
+
+VkPipelineLayout createLayout(
+    LveDevice &device,
+    const std::vector<VkDescriptorSetLayout> &setLayouts,
+    VkShaderStageFlags pushStages,
+    uint32_t pushSize) {
+  VkPushConstantRange pushConstantRange{};
+  pushConstantRange.stageFlags = pushStages;
+  pushConstantRange.offset = 0;
+  pushConstantRange.size = pushSize;
+
+  VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+  pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+  pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+  pipelineLayoutInfo.pSetLayouts = setLayouts.data();
+  pipelineLayoutInfo.pushConstantRangeCount = pushSize > 0 ? 1 : 0;
+  pipelineLayoutInfo.pPushConstantRanges = pushSize > 0 ? &pushConstantRange : nullptr;
+  VkPipelineLayout layout;
+  if (vkCreatePipelineLayout(device.device(), &pipelineLayoutInfo, nullptr, &layout) !=
+      VK_SUCCESS) {
+    throw std::runtime_error("failed to create pipeline layout!");
+  }
+  return layout;
+}
+
+bool isDrawable(const std::shared_ptr<LveModel> &model) {
+  return model != nullptr && model->isReady() && model->getIndexCount() > 0;
+}
+
+}  // namespace
+
+VegetationSystem::VegetationSystem(
+    LveDevice &device,
+    VkRenderPass renderPass,
+    VkDescriptorSetLayout globalSetLayout,
+    const Config &config)
+    : lveDevice{device}, config{config}, models(config.variants.size()) {
+  if (config.variants.empty() || config.variants.size() > MAX_VARIANTS) {
+    throw std::runtime_error(
+        "vegetation needs between 1 and " + std::to_string(MAX_VARIANTS) + " variants");
+  }
+  createDescriptorSetLayouts();
+  createPipelineLayouts(globalSetLayout);
+  createPipelines(renderPass);
+  scatter();
+  createFrameResources();
+}
+
+VegetationSystem::~VegetationSystem() {
+  vkDestroyPipelineLayout(lveDevice.device(), scatterPipelineLayout, nullptr);
+  vkDestroyPipelineLayout(lveDevice.device(), cullPipelineLayout, nullptr);
+  vkDestroyPipelineLayout(lveDevice.device(), pipelineLayout, nullptr);
+}
+
+void VegetationSystem::createDescriptorSetLayouts() {
+  const uint32_t frameSets = LveSwapChain::MAX_FRAMES_IN_FLIGHT;
+  descriptorPool =
+      LveDescriptorPool::Builder(lveDevice)
+          .setMaxSets(1 + frameSets)
+          .addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3 + 3 * frameSets)
+          .build();
+
+  // density map, instances, counters
+  scatterSetLayout =
+      LveDescriptorSetLayout::Builder(lveDevice)
+          .addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+          .addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+          .addBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+          .build();
+
+  // instances, draws, visible instances; shared by the cull pass and the draw
+  const VkShaderStageFlags stages = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT;
+  instanceSetLayout = LveDescriptorSetLayout::Builder(lveDevice)
+                          .addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, stages)
+                          .addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, stages)
+                          .addBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, stages)
+                          .build();
+}
+
+void VegetationSystem::createPipelineLayouts(VkDescriptorSetLayout globalSetLayout) {
+  scatterPipelineLayout = createLayout(
+      lveDevice,
+      {scatterSetLayout->getDescriptorSetLayout()},
+      VK_SHADER_STAGE_COMPUTE_BIT,
+      sizeof(ScatterPushConstantData));
+  cullPipelineLayout = createLayout(
+      lveDevice,
+      {instanceSetLayout->getDescriptorSetLayout()},
+      VK_SHADER_STAGE_COMPUTE_BIT,
+      sizeof(CullPushConstantData));
+  pipelineLayout = createLayout(
+      lveDevice,
+      {globalSetLayout, instanceSetLayout->getDescriptorSetLayout()},
+      0,
+      0);
+}
+
+void VegetationSystem::createPipelines(VkRenderPass renderPass) {
+  scatterPipeline = std::make_unique<LveComputePipeline>(
+      lveDevice,
+      "shaders/vegetation_scatter.comp.spv",
+      scatterPipelineLayout);
+  cullPipeline = std::make_unique<LveComputePipeline>(
+      lveDevice,
+      "shaders/vegetation_cull.comp.spv",
+      cullPipelineLayout);
+
+  PipelineConfigInfo pipelineConfig{};
+  LvePipeline::defaultPipelineConfigInfo(pipelineConfig);
+  pipelineConfig.renderPass = renderPass;
+  pipelineConfig.pipelineLayout = pipelineLayout;
+  lvePipeline = std::make_unique<LvePipeline>(
+      lveDevice,
+      "shaders/vegetation.vert.spv",
+      "shaders/vegetation.frag.spv",
+      pipelineConfig);
+}
+
+void VegetationSystem::scatter() {
+  LVE_CPU_ZONE("VegetationSystem::scatter");
+  uint32_t densityWidth = 1, densityHeight = 1;
+  std::vector<float> density{1.f};
+  if (!config.densityMapFile.empty()) {
+    density = loadDensityMap(config.densityMapFile, densityWidth, densityHeight);
+  }
+
+  LveBuffer densityBuffer{
+      lveDevice,
+      sizeof(float),
+      static_cast<uint32_t>(density.size()),
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT};
+  densityBuffer.map();
+  densityBuffer.writeToBuffer(density.data());
+
+  ScatterCounters counters{};
+  LveBuffer counterBuffer{
+      lveDevice,
+      sizeof(ScatterCounters),
+      1,
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT};
+  counterBuffer.map();
+  counterBuffer.writeToBuffer(&counters);
+
+  // written here on the graphics queue, read by the cull pass on the compute queue
+  instanceBuffer = std::make_unique<LveBuffer>(
+      lveDevice,
+      sizeof(VegetationInstance),
+      std::max(config.count, 1u),
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+      1,
+      true);
+
+  VkDescriptorSet scatterSet;
+  auto densityInfo = densityBuffer.descriptorInfo();
+  auto instanceInfo = instanceBuffer->descriptorInfo();
+  auto counterInfo = counterBuffer.descriptorInfo();
+  if (!LveDescriptorWriter(*scatterSetLayout, *descriptorPool)
+           .writeBuffer(0, &densityInfo)
+           .writeBuffer(1, &instanceInfo)
+           .writeBuffer(2, &counterInfo)
+           .build(scatterSet)) {
+    throw std::runtime_error("failed to allocate vegetation scatter descriptor set!");
+  }
+
+  ScatterPushConstantData push{};
+  push.area = config.area;
+  float totalWeight = 0.f;
+  for (const auto &variant : config.variants) {
+    totalWeight += std::max(variant.weight, 0.f);
+  }
+  if (totalWeight <= 0.f) {
+    throw std::runtime_error("vegetation variant weights must not all be 0");
+  }
+  float cumulative = 0.f;
+  for (size_t i = 0; i < MAX_VARIANTS; i++) {
+    if (i < config.variants.size()) {
+      cumulative += std::max(config.variants[i].weight, 0.f) / totalWeight;
+    }
+    push.cumulativeWeights[i] = cumulative;
+  }
+  push.groundY = config.groundY;
+  push.minScale = config.minScale;
+  push.maxScale = config.maxScale;
+  push.seed = config.seed;
+  push.candidateCount = config.count;
+  push.variantCount = static_cast<uint32_t>(config.variants.size());
+  push.densityWidth = densityWidth;
+  push.densityHeight = densityHeight;
+
+  VkCommandBuffer commandBuffer = lveDevice.beginSingleTimeCommands();
+  scatterPipeline->bind(commandBuffer);
+  vkCmdBindDescriptorSets(
+      commandBuffer,
+      VK_PIPELINE_BIND_POINT_COMPUTE,
+      scatterPipelineLayout,
+      0,
+      1,
+      &scatterSet,
+      0,
+      nullptr);
+  vkCmdPushConstants(
+      commandBuffer,
+      scatterPipelineLayout,
+      VK_SHADER_STAGE_COMPUTE_BIT,
+      0,
+      sizeof(ScatterPushConstantData),
+      &push);
+  scatterPipeline->dispatch(
+      commandBuffer,
+      LveComputePipeline::groupCount(config.count, WORKGROUP_SIZE));
+
+  // the counters are read on the host once the fence signaled
+  VkMemoryBarrier barrier{};
+  barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+  barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+  barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+  vkCmdPipelineBarrier(
+      commandBuffer,
+      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+      VK_PIPELINE_STAGE_HOST_BIT,
+      0,
+      1,
+      &barrier,
+      0,
+      nullptr,
+      0,
+      nullptr);
+  lveDevice.endSingleTimeCommands(commandBuffer);
+
+  counters = *static_cast<const ScatterCounters *>(counterBuffer.getMappedMemory());
+  instanceCount = counters.instanceCount;
+  std::copy(
+      std::begin(counters.variantCounts),
+      std::end(counters.variantCounts),
+      variantCounts.begin());
+  // the scatter set isn't needed anymore, the pool is only ever used by this system
+  descriptorPool->resetPool();
+}
+
+void VegetationSystem::createFrameResources() {
+  drawBuffers.resize(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
+  visibleBuffers.resize(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
+  instanceSets.resize(LveSwapChain::MAX_FRAMES_IN_FLIGHT);
+  for (int i = 0; i < LveSwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+    drawBuffers[i] = std::make_unique<LveBuffer>(
+        lveDevice,
+        sizeof(DrawData),
+        1,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+        1,
+        true);
+    drawBuffers[i]->map();
+    visibleBuffers[i] = std::make_unique<LveBuffer>(
+        lveDevice,
+        sizeof(VegetationInstance),
+        std::max(instanceCount, 1u),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        1,
+        true);
+
+    auto instanceInfo = instanceBuffer->descriptorInfo();
+    auto drawInfo = drawBuffers[i]->descriptorInfo();
+    auto visibleInfo = visibleBuffers[i]->descriptorInfo();
+    if (!LveDescriptorWriter(*instanceSetLayout, *descriptorPool)
+             .writeBuffer(0, &instanceInfo)
+             .writeBuffer(1, &drawInfo)
+             .writeBuffer(2, &visibleInfo)
+             .build(instanceSets[i])) {
+      throw std::runtime_error("failed to allocate vegetation descriptor set!");
+    }
+  }
+}
+
+void VegetationSystem::onModelLoaded(
+    const std::string &filepath, std::shared_ptr<LveModel> model) {
+  for (size_t i = 0; i < config.variants.size(); i++) {
+    if (config.variants[i].modelPath == filepath) {
+      models[i] = model;
+    }
+  }
+}
+
+void VegetationSystem::cull(FrameInfo &frameInfo, VkCommandBuffer computeCommandBuffer) {
+  // the instances of each variant are packed after the ones of the previous variants, visible
+  // ones are appended from the start of their variant's range
+  DrawData draws{};
+  uint32_t firstInstance = 0;
+  for (size_t i = 0; i < config.variants.size(); i++) {
+    auto transform = config.variants[i].transform;
+    auto &variant = draws.variants[i];
+    variant.modelMatrix = transform.mat4();
+    variant.normalMatrix = glm::mat4{transform.normalMatrix()};
+
+    auto &command = draws.commands[i];
+    command.firstInstance = firstInstance;
+    firstInstance += variantCounts[i];
+    if (isDrawable(models[i])) {
+      const float maxScale = std::max(
+          glm::length(glm::vec3{variant.modelMatrix[0]}),
+          std::max(
+              glm::length(glm::vec3{variant.modelMatrix[1]}),
+              glm::length(glm::vec3{variant.modelMatrix[2]})));
+      variant.boundingSphere = glm::vec4{
+          models[i]->getBoundingCenter(),
+          models[i]->getBoundingRadius() * maxScale};
+      command.indexCount = models[i]->getIndexCount();
+    }
+  }
+  auto &drawBuffer = *drawBuffers[frameInfo.frameIndex];
+  drawBuffer.writeToBuffer(&draws);
+  drawBuffer.flush();
+  frameInfo.stats.recordUpload(sizeof(DrawData));
+  if (instanceCount == 0) {
+    return;
+  }
+
+  CullPushConstantData push{};
+  const auto &planes = LveFrustum::fromCamera(frameInfo.camera).getPlanes();
+  std::copy(planes.begin(), planes.end(), push.frustumPlanes);
+  push.cameraPosition = glm::vec4{frameInfo.camera.getPosition(), config.maxDistance};
+  push.instanceCount = instanceCount;
+
+  cullPipeline->bind(computeCommandBuffer);
+  vkCmdBindDescriptorSets(
+      computeCommandBuffer,
+      VK_PIPELINE_BIND_POINT_COMPUTE,
+      cullPipelineLayout,
+      0,
+      1,
+      &instanceSets[frameInfo.frameIndex],
+      0,
+      nullptr);
+  vkCmdPushConstants(
+      computeCommandBuffer,
+      cullPipelineLayout,
+      VK_SHADER_STAGE_COMPUTE_BIT,
+      0,
+      sizeof(CullPushConstantData),
+      &push);
+  cullPipeline->dispatch(
+      computeCommandBuffer,
+      LveComputePipeline::groupCount(instanceCount, WORKGROUP_SIZE));
+}
+
+std::unique_ptr<LvePipeline> VegetationSystem::createPipelineVariant(
+    PipelineConfigInfo &pipelineConfig, const std::string &fragFilepath) {
+  pipelineConfig.pipelineLayout = pipelineLayout;
+  return std::make_unique<LvePipeline>(
+      lveDevice,
+      "shaders/vegetation.vert.spv",
+      fragFilepath,
+      pipelineConfig);
+}
+
+void VegetationSystem::render(FrameInfo &frameInfo, LvePipeline &pipeline) {
+  if (instanceCount == 0) {
+    return;
+  }
+  pipeline.bind(frameInfo.commandBuffer);
+  frameInfo.stats.pipelineBinds++;
+
+  VkDescriptorSet descriptorSets[] = {
+      frameInfo.globalDescriptorSet,
+      instanceSets[frameInfo.frameIndex]};
+  vkCmdBindDescriptorSets(
+      frameInfo.commandBuffer,
+      VK_PIPELINE_BIND_POINT_GRAPHICS,
+      pipelineLayout,
+      0,
+      2,
+      descriptorSets,
+      0,
+      nullptr);
+  frameInfo.stats.descriptorBinds++;
+
+  for (size_t i = 0; i < config.variants.size(); i++) {
+    // a model that became ready after the cull pass has no instances counted yet, drawing it
+    // draws nothing
+    if (!isDrawable(models[i])) continue;
+    models[i]->bind(frameInfo.commandBuffer);
+    vkCmdDrawIndexedIndirect(
+        frameInfo.commandBuffer,
+        drawBuffers[frameInfo.frameIndex]->getBuffer(),
+        offsetof(DrawData, commands) + i * sizeof(VkDrawIndexedIndirectCommand),
+        1,
+        sizeof(VkDrawIndexedIndirectCommand));
+    // instance counts stay on the GPU, only the draw itself is known here
+    frameInfo.stats.drawCalls++;
+  }
+}
+
+std::vector<float> VegetationSystem::loadDensityMap(
+    const std::string &filepath, uint32_t &width, uint32_t &height) {
+  std::ifstream file{filepath, std::ios::binary};
+  if (!file.is_open()) {
+    throw std::runtime_error("failed to open density map: " + filepath);
+  }
+  auto invalid = [&](const std::string &reason) {
+    return std::runtime_error("invalid density map " + filepath + ": " + reason);
+  };
+
+  // header fields are separated by whitespace and may be followed by # comments
+  auto readField = [&]() {
+    while (true) {
+      file >> std::ws;
+      if (file.peek() != '#') break;
+      std::string comment;
+      std::getline(file, comment);
+    }
+    std::string field;
+    file >> field;
+    return field;
+  };
+  if (readField() != "P5") {
+    throw invalid("not a binary PGM");
+  }
+  uint32_t maxValue;
+  try {
+    width = static_cast<uint32_t>(std::stoul(readField()));
+    height = static_cast<uint32_t>(std::stoul(readField()));
+    maxValue = static_cast<uint32_t>(std::stoul(readField()));
+  } catch (const std::logic_error &) {
+    throw invalid("malformed header");
+  }
+  if (width == 0 || height == 0) {
+    throw invalid("empty image");
+  }
+  if (maxValue == 0 || maxValue > 255) {
+    throw invalid("only 8 bit images are supported");
+  }
+  // a single whitespace character separates the header from the pixels
+  file.get();
+
+  std::vector<unsigned char> pixels(static_cast<size_t>(width) * height);
+  if (!file.read(reinterpret_cast<char *>(pixels.data()), pixels.size())) {
+    throw invalid("truncated pixels");
+  }
+  std::vector<float> density(pixels.size());
+  for (size_t i = 0; i < pixels.size(); i++) {
+    density[i] = std::min(static_cast<float>(pixels[i]) / maxValue, 1.f);
+  }
+  return density;
+}
+
+}  // namespace lve
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "lve_buffer.hpp"
+#include "lve_compute_pipeline.hpp"
+#include "lve_descriptors.hpp"
+#include "lve_device.hpp"
+#include "lve_frame_info.hpp"
+#include "lve_game_object.hpp"
+#include "lve_model.hpp"
+#include "lve_pipeline.hpp"
+
+// libs
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+// std
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lve {
+
+// Plants that only exist on the GPU. A compute pass scatters up to Config::count instances over a
+// rectangle of ground once, the same seed and density map always giving the same layout. Every
+// frame a second compute pass culls them against the camera and appends the survivors per
+// variant, and each variant is drawn with a single indirect instanced draw.
+class VegetationSystem {
+ public:
+  static constexpr uint32_t MAX_VARIANTS = 4;
+
+  struct Variant {
+    std::string modelPath;
+    // relative share of the instances using this model
+    float weight = 1.f;
+    // applied in model space before the instance's scale, yaw and position
+    TransformComponent transform{};
+  };
+
+  struct Config {
+    // candidate positions, the density map rejects part of them
+    uint32_t count = 100000;
+    uint32_t seed = 1;
+    // ground rectangle as min x, min z, max x, max z and its height
+    glm::vec4 area{-10.f, -10.f, 10.f, 10.f};
+    float groundY = .5f;
+    float minScale = .05f;
+    float maxScale = .25f;
+    // instances further from the camera than this are never drawn
+    float maxDistance = 60.f;
+    // 8 bit binary PGM stretched over area, rows going from min z to max z. A texel's brightness
+    // is the chance a candidate falling on it is kept, without one every candidate is kept.
+    std::string densityMapFile{};
+    std::vector<Variant> variants{};
+  };
+
+  // Runs the scatter pass and waits for it, so the instances are ready when this returns
+  VegetationSystem(
+      LveDevice &device,
+      VkRenderPass renderPass,
+      VkDescriptorSetLayout globalSetLayout,
+      const Config &config);
+  ~VegetationSystem();
+
+  VegetationSystem(const VegetationSystem &) = delete;
+  VegetationSystem &operator=(const VegetationSystem &) = delete;
+
+  // hands the model of a variant over once it streamed in, variants without one are skipped
+  void onModelLoaded(const std::string &filepath, std::shared_ptr<LveModel> model);
+
+  // Records the cull pass of the frame slot into a compute command buffer, see
+  // LveRenderer::beginCompute. Graphics must wait for it before DRAW_INDIRECT.
+  void cull(FrameInfo &frameInfo, VkCommandBuffer computeCommandBuffer);
+  // draws what the frame slot's cull pass kept, within the swap chain render pass
+  void render(FrameInfo &frameInfo) { render(frameInfo, *lvePipeline); }
+  // Same draws with a pipeline from createPipelineVariant, within that pipeline's render pass
+  void render(FrameInfo &frameInfo, LvePipeline &pipeline);
+
+  // Pipeline drawing the instances with the vegetation vertex shader and layout but the render
+  // pass, fixed function state and fragment shader of pipelineConfig, e.g. for diagnostics passes
+  std::unique_ptr<LvePipeline> createPipelineVariant(
+      PipelineConfigInfo &pipelineConfig, const std::string &fragFilepath);
+
+  // instances the scatter pass kept, in total and per variant
+  uint32_t getInstanceCount() const { return instanceCount; }
+  const std::array<uint32_t, MAX_VARIANTS> &getVariantCounts() const { return variantCounts; }
+
+  // reads an 8 bit binary PGM as densities in [0, 1], row by row
+  static std::vector<float> loadDensityMap(
+      const std::string &filepath, uint32_t &width, uint32_t &height);
+
+ private:
+  void createDescriptorSetLayouts();
+  void createPipelineLayouts(VkDescriptorSetLayout globalSetLayout);
+  void createPipelines(VkRenderPass renderPass);
+  void scatter();
+  void createFrameResources();
+
+  LveDevice &lveDevice;
+  Config config;
+  std::vector<std::shared_ptr<LveModel>> models;
+
+  std::unique_ptr<LveDescriptorPool> descriptorPool;
+  std::unique_ptr<LveDescriptorSetLayout> scatterSetLayout;
+  std::unique_ptr<LveDescriptorSetLayout> instanceSetLayout;
+  VkPipelineLayout scatterPipelineLayout;
+  VkPipelineLayout cullPipelineLayout;
+  VkPipelineLayout pipelineLayout;
+  std::unique_ptr<LveComputePipeline> scatterPipeline;
+  std::unique_ptr<LveComputePipeline> cullPipeline;
+  std::unique_ptr<LvePipeline> lvePipeline;
+
+  // every scattered instance, in the order the scatter pass appended them
+  std::unique_ptr<LveBuffer> instanceBuffer;
+  uint32_t instanceCount = 0;
+  std::array<uint32_t, MAX_VARIANTS> variantCounts{};
+  // per frame slot: variant data and indirect commands written by the CPU and counted up by the
+  // cull pass, and the visible instances grouped by variant
+  std::vector<std::unique_ptr<LveBuffer>> drawBuffers;
+  std::vector<std::unique_ptr<LveBuffer>> visibleBuffers;
+  std::vector<VkDescriptorSet> instanceSets;
+};
+
+}  // namespace lve
@@ -0,0 +1,79 @@
+#include "lve_bvh.hpp"
+#include "lve_job_system.hpp"
+#include "lve_test.hpp"
+#include "spatial_query_checks.hpp"
+
+// std
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace lve {
+
+LVE_TEST(bvhLeavesHoldEveryItemOnce) {
+  std::mt19937 rng{1};
+  std::vector<LveBvh::Item> items = makeItems(rng, 20000);
+  LveJobSystem jobSystem{3};
+  LveBvh bvh{};
+  bvh.build(items, &jobSystem);
+  LVE_CHECK(bvh.getItemCount() == items.size());
+
+  std::vector<uint32_t> references(items.size(), 0);
+  for (auto &node : bvh.getNodes()) {
+    if (node.isLeaf()) {
+      for (uint32_t i = node.rightOrFirst; i < node.rightOrFirst + node.count; i++) {
+        LVE_CHECK(i < references.size());
+        references[i]++;
+      }
+    }
+  }
+  for (uint32_t count : references) {
+    LVE_CHECK(count == 1);
+  }
+}
+
+LVE_TEST(bvhQueriesMatchBruteForce) {
+  std::mt19937 rng{2};
+  std::vector<LveBvh::Item> items = makeItems(rng, 20000);
+  LveJobSystem jobSystem{3};
+  for (LveJobSystem *buildJobs : {static_cast<LveJobSystem *>(nullptr), &jobSystem}) {
+    LveBvh bvh{};
+    bvh.build(items, buildJobs);
+    checkQueries(bvh, items, rng);
+  }
+
+  // degenerate trees
+  LveBvh empty{};
+  empty.build(std::vector<LveBvh::Item>{});
+  checkQueries(empty, {}, rng);
+  std::vector<LveBvh::Item> few = makeItems(rng, 3);
+  LveBvh small{};
+  small.build(few);
+  checkQueries(small, few, rng);
+}
+
+LVE_TEST(bvhQueriesMatchBruteForceAfterRefit) {
+  std::mt19937 rng{3};
+  std::vector<LveBvh::Item> items = makeItems(rng, 5000);
+  LveBvh bvh{};
+  bvh.build(items);
+
+  // small moves of most items, then a few that cross the whole scene
+  std::uniform_real_distribution<float> jitter{-3.f, 3.f};
+  std::uniform_real_distribution<float> position{-500.f, 500.f};
+  for (int round = 0; round < 3; round++) {
+    for (auto &item : items) {
+      glm::vec3 offset{jitter(rng), jitter(rng) * .1f, jitter(rng)};
+      if (item.id % 97 == 0) {
+        offset = glm::vec3{position(rng), 0.f, position(rng)} - item.bounds.center();
+      }
+      item.bounds.min = item.bounds.min + offset;
+      item.bounds.max = item.bounds.max + offset;
+      bvh.setItemBounds(item.id, item.bounds);
+    }
+    bvh.refit();
+    checkQueries(bvh, items, rng);
+  }
+}
+
+}  // namespace lve
@@ -0,0 +1,144 @@
+#include "lve_job_system.hpp"
+#include "lve_test.hpp"
+
+// std
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace lve {
+
+namespace {
+
+// parallelFor must hand every index to exactly one chunk, no matter the grain or worker count
+void checkCoverage(LveJobSystem &jobSystem, uint32_t count, uint32_t grainSize) {
+  // without workers the whole range is a single chunk
+  uint32_t maxChunk = jobSystem.getWorkerCount() > 0 ? grainSize : count;
+  std::vector<std::atomic<uint32_t>> visits(count);
+  std::atomic<bool> badChunk{false};
+  jobSystem.parallelFor(count, grainSize, [&](uint32_t begin, uint32_t end) {
+    if (end <= begin || end - begin > maxChunk || end > count) {
+      badChunk = true;
+    }
+    for (uint32_t i = begin; i < end && i < count; i++) {
+      visits[i].fetch_add(1, std::memory_order_relaxed);
+    }
+  });
+  LVE_CHECK(!badChunk);
+  for (auto &visit : visits) {
+    LVE_CHECK(visit.load() == 1);
+  }
+}
+
+}  // namespace
+
+LVE_TEST(parallelForCoversEveryIndexOnce) {
+  for (unsigned workerCount : {0u, 1u, 4u}) {
+    LveJobSystem jobSystem{workerCount};
+    for (uint32_t count : {0u, 1u, 7u, 64u, 1000u, 20011u}) {
+      for (uint32_t grainSize : {1u, 3u, 64u, 1u << 20}) {
+        checkCoverage(jobSystem, count, grainSize);
+      }
+    }
+  }
+}
+
+LVE_TEST(parallelForRethrowsAfterEveryChunkFinished) {
+  LveJobSystem jobSystem{4};
+  std::vector<std::atomic<uint32_t>> visits(10000);
+  bool caught = false;
+  try {
+    jobSystem.parallelFor(10000, 16, [&](uint32_t begin, uint32_t end) {
+      for (uint32_t i = begin; i < end; i++) {
+        visits[i].fetch_add(1, std::memory_order_relaxed);
+      }
+      if (begin == 4992) {
+        throw std::runtime_error{"chunk failed"};
+      }
+    });
+  } catch (const std::runtime_error &e) {
+    caught = std::string{e.what()} == "chunk failed";
+  }
+  LVE_CHECK(caught);
+  // the throwing chunk doesn't cancel the others
+  for (auto &visit : visits) {
+    LVE_CHECK(visit.load() == 1);
+  }
+
+  // the system stays usable afterwards
+  checkCoverage(jobSystem, 5000, 7);
+}
+
+LVE_TEST(parallelForRethrowsOneOfSeveralExceptions) {
+  LveJobSystem jobSystem{4};
+  std::atomic<uint32_t> thrown{0};
+  bool caught = false;
+  try {
+    jobSystem.parallelFor(1000, 10, [&](uint32_t begin, uint32_t) {
+      if (begin % 100 == 0) {
+        thrown.fetch_add(1, std::memory_order_relaxed);
+        throw std::out_of_range{"chunk " + std::to_string(begin)};
+      }
+    });
+  } catch (const std::out_of_range &) {
+    caught = true;
+  }
+  LVE_CHECK(caught);
+  LVE_CHECK(thrown.load() == 10);
+}
+
+LVE_TEST(nestedJobsFinishBeforeWaitReturns) {
+  LveJobSystem jobSystem{3};
+  std::atomic<uint32_t> leaves{0};
+  LveJobCounter outer{};
+  for (int i = 0; i < 32; i++) {
+    jobSystem.run(
+        [&] {
+          LveJobCounter inner{};
+          for (int j = 0; j < 32; j++) {
+            jobSystem.run([&] { leaves.fetch_add(1, std::memory_order_relaxed); }, inner);
+          }
+          jobSystem.wait(inner);
+        },
+        outer);
+  }
+  jobSystem.wait(outer);
+  LVE_CHECK(outer.isDone());
+  LVE_CHECK(leaves.load() == 32 * 32);
+}
+
+LVE_TEST(backgroundJobsOnlyRunOnWorkers) {
+  for (unsigned workerCount : {1u, 4u}) {
+    LveJobSystem jobSystem{workerCount};
+    const std::thread::id creatingThread = std::this_thread::get_id();
+    std::atomic<uint32_t> onCreatingThread{0};
+    std::atomic<uint32_t> finished{0};
+    LveJobCounter background{};
+    for (int i = 0; i < 64; i++) {
+      jobSystem.runBackground(
+          [&] {
+            if (std::this_thread::get_id() == creatingThread) {
+              onCreatingThread.fetch_add(1, std::memory_order_relaxed);
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            finished.fetch_add(1, std::memory_order_relaxed);
+          },
+          background);
+    }
+
+    // frame work waited on meanwhile must not pick up the background jobs
+    for (int frame = 0; frame < 8; frame++) {
+      checkCoverage(jobSystem, 2000, 16);
+    }
+    jobSystem.wait(background);
+    LVE_CHECK(background.isDone());
+    LVE_CHECK(finished.load() == 64);
+    LVE_CHECK(onCreatingThread.load() == 0);
+  }
+}
+
+}  // namespace lve
@@ -0,0 +1,34 @@
+#include "lve_test.hpp"
+
+// std
+#include <exception>
+#include <iostream>
+
+namespace lve {
+
+LveTestRegistry &LveTestRegistry::get() {
+  static LveTestRegistry registry{};
+  return registry;
+}
+
+int LveTestRegistry::run(const std::string &filter) const {
+  int passed = 0;
+  int failed = 0;
+  for (auto &testCase : cases) {
+    if (std::string{testCase.name}.find(filter) == std::string::npos) {
+      continue;
+    }
+    try {
+      testCase.test();
+      passed++;
+      std::cerr << "[ ok ] " << testCase.name << '\n';
+    } catch (const std::exception &e) {
+      failed++;
+      std::cerr << "[FAIL] " << testCase.name << ": " << e.what() << '\n';
+    }
+  }
+  std::cerr << passed << " passed, " << failed << " failed\n";
+  return failed;
+}
+
+}  // namespace lve
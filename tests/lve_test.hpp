@@ -0,0 +1,58 @@
+#pragma once
+
+// std
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace lve {
+
+// Thrown by LVE_CHECK, ends the current case and is reported by the runner
+class LveTestFailure : public std::runtime_error {
+ public:
+  LveTestFailure(const char *file, int line, const std::string &message)
+      : std::runtime_error{std::string{file} + ":" + std::to_string(line) + ": " + message} {}
+};
+
+// Minimal test runner. Cases register themselves at static initialization through LVE_TEST and
+// run in registration order; a case fails when it throws.
+class LveTestRegistry {
+ public:
+  using TestFn = std::function<void()>;
+
+  static LveTestRegistry &get();
+
+  void add(const char *name, TestFn test) { cases.push_back({name, std::move(test)}); }
+
+  // Runs every case whose name contains filter, returns the number of failed cases
+  int run(const std::string &filter) const;
+
+ private:
+  struct Case {
+    const char *name;
+    TestFn test;
+  };
+
+  std::vector<Case> cases;
+};
+
+struct LveTestRegistration {
+  LveTestRegistration(const char *name, LveTestRegistry::TestFn test) {
+    LveTestRegistry::get().add(name, std::move(test));
+  }
+};
+
+}  // namespace lve
+
+#define LVE_TEST(name)                                                   \
+  static void name();                                                    \
+  static const lve::LveTestRegistration name##Registration{#name, name}; \
+  static void name()
+
+#define LVE_CHECK(condition)                                     \
+  do {                                                           \
+    if (!(condition)) {                                          \
+      throw lve::LveTestFailure{__FILE__, __LINE__, #condition}; \
+    }                                                            \
+  } while (false)
@@ -0,0 +1,23 @@
+#include "lve_test.hpp"
+
+// std
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+int main(int argc, char **argv) {
+  std::string filter{};
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--filter" && i + 1 < argc) {
+      filter = argv[++i];
+    } else {
+      std::cerr << "unknown argument: " << arg << '\n'
+                << "usage: " << argv[0] << " [--filter TEXT]\n"
+                << "  --filter TEXT   only run cases whose name contains TEXT\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  return lve::LveTestRegistry::get().run(filter) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,92 @@
+#include "lve_mpsc_queue.hpp"
+#include "lve_test.hpp"
+
+// std
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace lve {
+
+LVE_TEST(mpscQueueIsFifoOnOneThread) {
+  LveMpscQueue<int> queue{};
+  int value = -1;
+  LVE_CHECK(queue.empty());
+  LVE_CHECK(!queue.pop(value));
+  for (int i = 0; i < 100; i++) {
+    queue.push(i);
+  }
+  for (int i = 0; i < 100; i++) {
+    LVE_CHECK(queue.pop(value));
+    LVE_CHECK(value == i);
+  }
+  LVE_CHECK(queue.empty());
+  LVE_CHECK(!queue.pop(value));
+}
+
+LVE_TEST(mpscQueueKeepsPerProducerOrder) {
+  constexpr uint32_t PRODUCERS = 8;
+  constexpr uint32_t ITEMS_PER_PRODUCER = 50000;
+
+  // items carry their producer in the high bits and a sequence number in the low ones
+  LveMpscQueue<uint64_t> queue{};
+  std::atomic<uint32_t> ready{0};
+  std::vector<std::thread> producers;
+  for (uint32_t p = 0; p < PRODUCERS; p++) {
+    producers.emplace_back([&, p] {
+      ready.fetch_add(1);
+      while (ready.load() < PRODUCERS) {
+      }
+      for (uint32_t i = 0; i < ITEMS_PER_PRODUCER; i++) {
+        queue.push(static_cast<uint64_t>(p) << 32 | i);
+      }
+    });
+  }
+
+  std::vector<uint32_t> nextSequence(PRODUCERS, 0);
+  bool inOrder = true;
+  uint64_t received = 0;
+  uint64_t item = 0;
+  while (received < PRODUCERS * ITEMS_PER_PRODUCER) {
+    if (!queue.pop(item)) {
+      std::this_thread::yield();
+      continue;
+    }
+    uint32_t producer = static_cast<uint32_t>(item >> 32);
+    uint32_t sequence = static_cast<uint32_t>(item);
+    if (producer >= PRODUCERS || sequence != nextSequence[producer]) {
+      inOrder = false;
+      break;
+    }
+    nextSequence[producer]++;
+    received++;
+  }
+  for (auto &producer : producers) {
+    producer.join();
+  }
+
+  LVE_CHECK(inOrder);
+  for (uint32_t count : nextSequence) {
+    LVE_CHECK(count == ITEMS_PER_PRODUCER);
+  }
+  LVE_CHECK(queue.empty());
+}
+
+LVE_TEST(mpscQueueReleasesItemsItDidNotDeliver) {
+  auto tracked = std::make_shared<int>(0);
+  {
+    LveMpscQueue<std::shared_ptr<int>> queue{};
+    for (int i = 0; i < 10; i++) {
+      queue.push(tracked);
+    }
+    std::shared_ptr<int> out{};
+    LVE_CHECK(queue.pop(out));
+    out.reset();
+    LVE_CHECK(tracked.use_count() == 10);
+  }
+  LVE_CHECK(tracked.use_count() == 1);
+}
+
+}  // namespace lve
@@ -0,0 +1,145 @@
+#include "lve_bvh.hpp"
+#include "lve_scene_index.hpp"
+#include "lve_spatial_hash.hpp"
+#include "lve_test.hpp"
+#include "spatial_query_checks.hpp"
+
+// libs
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+// std
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace lve {
+
+LVE_TEST(spatialHashQueriesMatchBruteForce) {
+  std::mt19937 rng{4};
+  std::vector<LveBvh::Item> items = makeItems(rng, 5000);
+  for (float cellSize : {2.f, 8.f, 64.f}) {
+    LveSpatialHash hash{cellSize};
+    for (auto &item : items) {
+      hash.insert(item.id, item.bounds);
+    }
+    LVE_CHECK(hash.getItemCount() == items.size());
+    checkQueries(hash, items, rng);
+  }
+}
+
+LVE_TEST(spatialHashQueriesMatchBruteForceAfterMoves) {
+  std::mt19937 rng{5};
+  std::vector<LveBvh::Item> items = makeItems(rng, 5000);
+  LveSpatialHash hash{8.f};
+  for (auto &item : items) {
+    hash.insert(item.id, item.bounds);
+  }
+
+  std::uniform_real_distribution<float> jitter{-3.f, 3.f};
+  std::uniform_real_distribution<float> position{-500.f, 500.f};
+  LveGameObject::id_t nextId = static_cast<LveGameObject::id_t>(items.size());
+  for (int round = 0; round < 3; round++) {
+    // most items move a little, some cross the scene, grow, leave or are replaced by new ones
+    std::vector<LveBvh::Item> moved;
+    for (auto &item : items) {
+      if (item.id % 31 == round) {
+        hash.remove(item.id);
+        LVE_CHECK(!hash.contains(item.id));
+        continue;
+      }
+      if (item.id % 211 == 0) {
+        // grows around the same center, so the item stays in its cell
+        item.bounds.min = item.bounds.min - glm::vec3{75.f, 0.f, 75.f};
+        item.bounds.max = item.bounds.max + glm::vec3{75.f, 0.f, 75.f};
+      } else {
+        glm::vec3 offset{jitter(rng), jitter(rng) * .1f, jitter(rng)};
+        if (item.id % 97 == 0) {
+          offset = glm::vec3{position(rng), 0.f, position(rng)} - item.bounds.center();
+        }
+        item.bounds.min = item.bounds.min + offset;
+        item.bounds.max = item.bounds.max + offset;
+      }
+      hash.update(item.id, item.bounds);
+      moved.push_back(item);
+    }
+    for (int i = 0; i < 100; i++) {
+      glm::vec3 center{position(rng), 0.f, position(rng)};
+      LveBvh::Item item{{center - glm::vec3{1.f}, center + glm::vec3{1.f}}, nextId++, false};
+      hash.update(item.id, item.bounds);
+      moved.push_back(item);
+    }
+    items = std::move(moved);
+
+    LVE_CHECK(hash.getItemCount() == items.size());
+    std::vector<LveGameObject::id_t> expectedIds;
+    for (auto &item : items) {
+      expectedIds.push_back(item.id);
+    }
+    LVE_CHECK(sorted(hash.getIds()) == sorted(expectedIds));
+    checkQueries(hash, items, rng);
+  }
+
+  hash.clear();
+  LVE_CHECK(hash.getItemCount() == 0 && hash.getCellCount() == 0);
+  checkQueries(hash, {}, rng);
+}
+
+LVE_TEST(sceneIndexQueriesMatchBruteForce) {
+  std::mt19937 rng{6};
+  // makeItems marks every third item static
+  std::vector<LveBvh::Item> items = makeItems(rng, 10000);
+  LveJobSystem jobSystem{3};
+  LveSceneIndex sceneIndex{8.f};
+  sceneIndex.build(items, &jobSystem);
+
+  size_t staticCount = 0;
+  for (auto &item : items) {
+    staticCount += item.isStatic ? 1 : 0;
+  }
+  LVE_CHECK(sceneIndex.getItemCount() == items.size());
+  LVE_CHECK(sceneIndex.getStaticObjects().getItemCount() == staticCount);
+  LVE_CHECK(sceneIndex.getDynamicObjects().getItemCount() == items.size() - staticCount);
+  checkQueries(sceneIndex, items, rng);
+}
+
+LVE_TEST(sceneIndexQueriesMatchBruteForceAfterUpdates) {
+  std::mt19937 rng{7};
+  std::vector<LveBvh::Item> items = makeItems(rng, 5000);
+  LveSceneIndex sceneIndex{8.f};
+  sceneIndex.build(items);
+  const size_t staticCount = sceneIndex.getStaticObjects().getItemCount();
+
+  std::uniform_real_distribution<float> jitter{-3.f, 3.f};
+  std::uniform_real_distribution<float> position{-500.f, 500.f};
+  LveGameObject::id_t nextId = static_cast<LveGameObject::id_t>(items.size());
+  for (int round = 0; round < 3; round++) {
+    // static items stay where they are, dynamic ones move, leave or are replaced by new ones
+    std::vector<LveBvh::Item> updated;
+    for (auto &item : items) {
+      if (!item.isStatic) {
+        if (item.id % 29 == round) continue;
+        glm::vec3 offset{jitter(rng), jitter(rng) * .1f, jitter(rng)};
+        if (item.id % 89 == 0) {
+          offset = glm::vec3{position(rng), 0.f, position(rng)} - item.bounds.center();
+        }
+        item.bounds.min = item.bounds.min + offset;
+        item.bounds.max = item.bounds.max + offset;
+      }
+      updated.push_back(item);
+    }
+    for (int i = 0; i < 100; i++) {
+      glm::vec3 center{position(rng), 0.f, position(rng)};
+      updated.push_back({{center - glm::vec3{1.f}, center + glm::vec3{1.f}}, nextId++, false});
+    }
+    items = std::move(updated);
+    sceneIndex.update(items);
+
+    LVE_CHECK(sceneIndex.getStaticObjects().getItemCount() == staticCount);
+    LVE_CHECK(sceneIndex.getItemCount() == items.size());
+    checkQueries(sceneIndex, items, rng);
+  }
+}
+
+}  // namespace lve
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "lve_bvh.hpp"
+#include "lve_camera.hpp"
+#include "lve_frustum.hpp"
+#include "lve_job_system.hpp"
+#include "lve_test.hpp"
+
+// libs
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+// std
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace lve {
+
+// boxes scattered over a flat 1000 x 1000 area like a scene, with every 500th box stacked on the
+// same spot so the builder has to cope with identical centers
+inline std::vector<LveBvh::Item> makeItems(std::mt19937 &rng, uint32_t count) {
+  std::uniform_real_distribution<float> position{-500.f, 500.f};
+  std::uniform_real_distribution<float> extent{.2f, 4.f};
+  std::vector<LveBvh::Item> items(count);
+  for (uint32_t i = 0; i < count; i++) {
+    glm::vec3 center{position(rng), position(rng) * .02f, position(rng)};
+    if (i % 500 == 0) {
+      center = glm::vec3{3.f};
+    }
+    glm::vec3 halfExtent{extent(rng), extent(rng), extent(rng)};
+    items[i] = {{center - halfExtent, center + halfExtent}, i, i % 3 == 0};
+  }
+  return items;
+}
+
+inline std::vector<LveFrustum> makeFrustums(std::mt19937 &rng, uint32_t count) {
+  std::uniform_real_distribution<float> position{-500.f, 500.f};
+  std::uniform_real_distribution<float> direction{-1.f, 1.f};
+  std::vector<LveFrustum> frustums;
+  for (uint32_t i = 0; i < count; i++) {
+    LveCamera camera{};
+    camera.setPerspectiveProjection(glm::radians(50.f), 1.5f, .1f, 150.f);
+    camera.setViewDirection(
+        {position(rng), -5.f, position(rng)},
+        {direction(rng), direction(rng) * .2f, direction(rng)});
+    frustums.push_back(LveFrustum::fromCamera(camera));
+  }
+  return frustums;
+}
+
+inline std::vector<LveGameObject::id_t> sorted(std::vector<LveGameObject::id_t> ids) {
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+// Compares every query of index, an LveBvh, LveSpatialHash or LveSceneIndex, against a scan over
+// all items with the same box tests
+template <typename Index>
+void checkQueries(const Index &index, const std::vector<LveBvh::Item> &items, std::mt19937 &rng) {
+  LveJobSystem jobSystem{3};
+
+  std::vector<LveFrustum> frustums = makeFrustums(rng, 24);
+  std::vector<std::vector<LveGameObject::id_t>> visible;
+  index.queryFrustums(frustums, visible);
+  LVE_CHECK(visible.size() == frustums.size());
+  for (size_t v = 0; v < frustums.size(); v++) {
+    std::vector<LveGameObject::id_t> expected;
+    for (auto &item : items) {
+      if (frustums[v].intersectsAabb(item.bounds.min, item.bounds.max)) {
+        expected.push_back(item.id);
+      }
+    }
+    LVE_CHECK(sorted(visible[v]) == sorted(expected));
+  }
+
+  std::uniform_real_distribution<float> position{-500.f, 500.f};
+  std::uniform_real_distribution<float> radius{0.f, 40.f};
+  std::vector<LveBoundingSphere> spheres(40);
+  for (size_t s = 0; s < spheres.size(); s++) {
+    // every tenth sphere covers a large part of the scene
+    spheres[s] = {{position(rng), 0.f, position(rng)}, s % 10 == 0 ? 400.f : radius(rng)};
+  }
+  std::vector<std::vector<LveGameObject::id_t>> inSpheres;
+  index.querySpheres(spheres, inSpheres, &jobSystem);
+  LVE_CHECK(inSpheres.size() == spheres.size());
+  for (size_t s = 0; s < spheres.size(); s++) {
+    std::vector<LveGameObject::id_t> expected;
+    for (auto &item : items) {
+      if (item.bounds.intersectsSphere(spheres[s].center, spheres[s].radius)) {
+        expected.push_back(item.id);
+      }
+    }
+    LVE_CHECK(sorted(inSpheres[s]) == sorted(expected));
+
+    std::vector<LveGameObject::id_t> single;
+    index.querySphere(spheres[s].center, spheres[s].radius, single);
+    LVE_CHECK(sorted(single) == sorted(expected));
+  }
+
+  std::uniform_real_distribution<float> direction{-1.f, 1.f};
+  std::vector<LveRay> rays(200);
+  for (size_t r = 0; r < rays.size(); r++) {
+    rays[r].origin = {position(rng), 1.f, position(rng)};
+    rays[r].direction = glm::normalize(glm::vec3{direction(rng), .01f, direction(rng)});
+    if (r % 2 == 0) {
+      rays[r].maxDistance = 100.f;
+    }
+  }
+  std::vector<LveBvh::RayHit> hits;
+  index.intersectRays(rays, hits, &jobSystem);
+  LVE_CHECK(hits.size() == rays.size());
+  for (size_t r = 0; r < rays.size(); r++) {
+    const glm::vec3 inverseDirection = 1.f / rays[r].direction;
+    bool expectedHit = false;
+    float closest = rays[r].maxDistance;
+    for (auto &item : items) {
+      float distance = item.bounds.intersectRay(rays[r].origin, inverseDirection, closest);
+      if (distance >= 0.f) {
+        expectedHit = true;
+        closest = distance;
+      }
+    }
+    // several boxes may tie for the closest, so only the distance is compared
+    LVE_CHECK(hits[r].hit == expectedHit);
+    if (expectedHit) {
+      LVE_CHECK(hits[r].distance == closest);
+    }
+    LveBvh::RayHit single = index.intersectRay(rays[r]);
+    LVE_CHECK(single.hit == hits[r].hit && single.distance == hits[r].distance);
+  }
+}
+
+
+}  // namespace lve
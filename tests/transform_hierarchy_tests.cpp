@@ -0,0 +1,189 @@
+#include "lve_game_object.hpp"
+#include "lve_job_system.hpp"
+#include "lve_test.hpp"
+#include "lve_transform_hierarchy.hpp"
+
+// libs
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+// std
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace lve {
+
+namespace {
+
+using ParentMap = std::unordered_map<LveGameObject::id_t, LveGameObject::id_t>;
+
+TransformComponent randomTransform(std::mt19937 &rng) {
+  std::uniform_real_distribution<float> position{-5.f, 5.f};
+  std::uniform_real_distribution<float> angle{-3.f, 3.f};
+  std::uniform_real_distribution<float> scale{.5f, 1.5f};
+  TransformComponent transform{};
+  transform.translation = {position(rng), position(rng), position(rng)};
+  transform.rotation = {angle(rng), angle(rng), angle(rng)};
+  transform.scale = {scale(rng), scale(rng), scale(rng)};
+  return transform;
+}
+
+template <typename Matrix>
+bool nearlyEqual(const Matrix &a, const Matrix &b, int columns, int rows) {
+  for (int c = 0; c < columns; c++) {
+    for (int r = 0; r < rows; r++) {
+      if (std::abs(a[c][r] - b[c][r]) > 1e-3f * (1.f + std::abs(b[c][r]))) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Composes the expected world matrices by walking up the parent links, ancestors missing from
+// gameObjects end the chain like the hierarchy does
+void checkWorldMatrices(LveGameObject::Map &gameObjects, const ParentMap &parents) {
+  for (auto &kv : gameObjects) {
+    glm::mat4 world = kv.second.transform.mat4();
+    glm::mat3 normal = kv.second.transform.normalMatrix();
+    for (auto parent = parents.find(kv.first); parent != parents.end();
+         parent = parents.find(parent->second)) {
+      auto ancestor = gameObjects.find(parent->second);
+      if (ancestor == gameObjects.end()) break;
+      world = ancestor->second.transform.mat4() * world;
+      normal = ancestor->second.transform.normalMatrix() * normal;
+    }
+    LVE_CHECK(nearlyEqual(kv.second.worldMatrix, world, 4, 4));
+    LVE_CHECK(nearlyEqual(kv.second.worldNormalMatrix, normal, 3, 3));
+  }
+}
+
+bool createsCycle(LveGameObject::id_t child, LveGameObject::id_t parent, const ParentMap &parents) {
+  for (LveGameObject::id_t ancestor = parent;;) {
+    if (ancestor == child) return true;
+    auto next = parents.find(ancestor);
+    if (next == parents.end()) return false;
+    ancestor = next->second;
+  }
+}
+
+// objects whose world matrix depends on id's transform: id itself and its descendants
+uint32_t countSubtree(
+    LveGameObject::id_t id, LveGameObject::Map &gameObjects, const ParentMap &parents) {
+  uint32_t count = 0;
+  for (auto &kv : gameObjects) {
+    for (LveGameObject::id_t current = kv.first;;) {
+      if (current == id) {
+        count++;
+        break;
+      }
+      auto parent = parents.find(current);
+      if (parent == parents.end() || gameObjects.count(parent->second) == 0) break;
+      current = parent->second;
+    }
+  }
+  return count;
+}
+
+}  // namespace
+
+LVE_TEST(hierarchyWorldMatricesMatchParentTimesLocal) {
+  std::mt19937 rng{7};
+  LveJobSystem jobSystem{3};
+  for (LveJobSystem *updateJobs : {static_cast<LveJobSystem *>(nullptr), &jobSystem}) {
+    LveGameObject::Map gameObjects;
+    LveTransformHierarchy hierarchy{};
+    ParentMap parents;
+    std::vector<LveGameObject::id_t> ids;
+
+    // a few thousand objects, each usually attached to a random earlier one, so the tree gets
+    // both wide levels for the parallel path and long chains
+    for (int i = 0; i < 6000; i++) {
+      auto object = LveGameObject::createGameObject();
+      LveGameObject::id_t id = object.getId();
+      object.transform = randomTransform(rng);
+      gameObjects.emplace(id, std::move(object));
+      if (!ids.empty() && rng() % 4 != 0) {
+        LveGameObject::id_t parent = ids[rng() % ids.size()];
+        hierarchy.setParent(id, parent);
+        parents[id] = parent;
+      }
+      ids.push_back(id);
+    }
+    hierarchy.update(gameObjects, updateJobs);
+    LVE_CHECK(hierarchy.getLastRecomputedCount() == gameObjects.size());
+    checkWorldMatrices(gameObjects, parents);
+
+    hierarchy.update(gameObjects, updateJobs);
+    LVE_CHECK(hierarchy.getLastRecomputedCount() == 0);
+    checkWorldMatrices(gameObjects, parents);
+
+    // moving one object only recomputes it and its descendants
+    for (int move = 0; move < 20; move++) {
+      LveGameObject::id_t id = ids[rng() % ids.size()];
+      gameObjects.at(id).transform = randomTransform(rng);
+      hierarchy.update(gameObjects, updateJobs);
+      LVE_CHECK(hierarchy.getLastRecomputedCount() == countSubtree(id, gameObjects, parents));
+      checkWorldMatrices(gameObjects, parents);
+    }
+
+    // reparenting, detaching and removing objects change the layout
+    for (int change = 0; change < 20; change++) {
+      LveGameObject::id_t child = ids[rng() % ids.size()];
+      LveGameObject::id_t parent = ids[rng() % ids.size()];
+      if (change % 3 == 0) {
+        hierarchy.clearParent(child);
+        parents.erase(child);
+      } else {
+        bool threw = false;
+        try {
+          hierarchy.setParent(child, parent);
+        } catch (const std::runtime_error &) {
+          threw = true;
+        }
+        LVE_CHECK(threw == createsCycle(child, parent, parents));
+        if (!threw) {
+          parents[child] = parent;
+        }
+      }
+      if (change % 5 == 0) {
+        gameObjects.erase(ids[rng() % ids.size()]);
+      }
+      hierarchy.update(gameObjects, updateJobs);
+      checkWorldMatrices(gameObjects, parents);
+    }
+  }
+}
+
+LVE_TEST(hierarchyRejectsCycles) {
+  LveGameObject::Map gameObjects;
+  std::vector<LveGameObject::id_t> ids;
+  for (int i = 0; i < 3; i++) {
+    auto object = LveGameObject::createGameObject();
+    ids.push_back(object.getId());
+    gameObjects.emplace(object.getId(), std::move(object));
+  }
+  LveTransformHierarchy hierarchy{};
+  hierarchy.setParent(ids[1], ids[0]);
+  hierarchy.setParent(ids[2], ids[1]);
+
+  for (LveGameObject::id_t parent : {ids[2], ids[0]}) {
+    bool threw = false;
+    try {
+      hierarchy.setParent(ids[0], parent);
+    } catch (const std::runtime_error &) {
+      threw = true;
+    }
+    LVE_CHECK(threw);
+  }
+  LVE_CHECK(!hierarchy.hasParent(ids[0]));
+  hierarchy.update(gameObjects);
+  LVE_CHECK(hierarchy.getLevelCount() == 3);
+}
+
+}  // namespace lve